@@ -0,0 +1,238 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "glyr.h"
+#include "core.h"
+
+/*-----------------------------------------------------------------*/
+
+struct _GlyrAsync {
+    GlyrQuery * query;
+    GThread * thread;
+
+    /* Readable end is handed out; written whenever something happened */
+    int wake_fds[2];
+
+    /* Copies of the items found so far, not yet collected */
+    GAsyncQueue * items;
+
+    /* Set by the worker once glyr_get() returned */
+    volatile gint done;
+    GLYR_ERROR error;
+
+    /* What the user set with glyr_opt_dlcallback(); wrapped while running */
+    DL_callback user_callback;
+    void * user_pointer;
+};
+
+/*-----------------------------------------------------------------*/
+
+static void async_wakeup(GlyrAsync * async)
+{
+    /* If the pipe is full it is readable anyway */
+    char c = 0;
+    while(write(async->wake_fds[1],&c,1) == -1 && errno == EINTR)
+        ;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Installed as download callback: pass the item on, and to the user's callback first */
+static GLYR_ERROR async_item_ready(GlyrMemCache * item, GlyrQuery * query)
+{
+    GlyrAsync * async = query->callback.user_pointer;
+    GLYR_ERROR result = GLYRE_OK;
+
+    if(async->user_callback != NULL)
+    {
+        query->callback.user_pointer = async->user_pointer;
+        result = async->user_callback(item,query);
+        query->callback.user_pointer = async;
+    }
+
+    if(result != GLYRE_SKIP && result != GLYRE_STOP_PRE)
+    {
+        g_async_queue_push(async->items,DL_copy(item));
+        async_wakeup(async);
+    }
+    return result;
+}
+
+/*-----------------------------------------------------------------*/
+
+static gpointer async_worker(gpointer data)
+{
+    GlyrAsync * async = data;
+
+    /* Every item in here was handed out by async_item_ready() already */
+    GlyrMemCache * results = glyr_get(async->query,&async->error,NULL);
+    glyr_free_list(results);
+
+    g_atomic_int_set(&async->done,TRUE);
+    async_wakeup(async);
+    return NULL;
+}
+
+/*-----------------------------------------------------------------*/
+
+__attribute__((visibility("default")))
+GlyrAsync * glyr_get_async(GlyrQuery * query)
+{
+    if(query == NULL)
+    {
+        return NULL;
+    }
+
+    GlyrAsync * async = g_malloc0(sizeof(GlyrAsync));
+    if(pipe(async->wake_fds) == -1)
+    {
+        glyr_message(1,query,"Error: Unable to create pipe: %s\n",strerror(errno));
+        g_free(async);
+        return NULL;
+    }
+
+    for(int i = 0; i < 2; i++)
+    {
+        fcntl(async->wake_fds[i],F_SETFL,fcntl(async->wake_fds[i],F_GETFL) | O_NONBLOCK);
+    }
+
+    async->query = query;
+    async->items = g_async_queue_new();
+    async->user_callback = query->callback.download;
+    async->user_pointer  = query->callback.user_pointer;
+
+    query->callback.download = async_item_ready;
+    query->callback.user_pointer = async;
+
+    async->thread = g_thread_create(async_worker,async,TRUE,NULL);
+    if(async->thread == NULL)
+    {
+        async->error = GLYRE_UNKNOWN;
+        g_atomic_int_set(&async->done,TRUE);
+        async_wakeup(async);
+    }
+    return async;
+}
+
+/*-----------------------------------------------------------------*/
+
+__attribute__((visibility("default")))
+int glyr_async_get_fd(GlyrAsync * async)
+{
+    return (async) ? async->wake_fds[0] : -1;
+}
+
+/*-----------------------------------------------------------------*/
+
+__attribute__((visibility("default")))
+bool glyr_async_step(GlyrAsync * async)
+{
+    if(async == NULL)
+    {
+        return true;
+    }
+
+    char buf[64];
+    while(read(async->wake_fds[0],buf,sizeof(buf)) > 0)
+        ;
+
+    return g_atomic_int_get(&async->done);
+}
+
+/*-----------------------------------------------------------------*/
+
+__attribute__((visibility("default")))
+GlyrMemCache * glyr_async_collect(GlyrAsync * async, int * length)
+{
+    GlyrMemCache * head = NULL, * tail = NULL;
+    gint collected = 0;
+
+    GlyrMemCache * item = NULL;
+    while(async && (item = g_async_queue_try_pop(async->items)) != NULL)
+    {
+        item->prev = tail;
+        item->next = NULL;
+        if(tail != NULL)
+        {
+            tail->next = item;
+        }
+        else
+        {
+            head = item;
+        }
+        tail = item;
+        collected++;
+    }
+
+    if(length != NULL)
+    {
+        *length = collected;
+    }
+    return head;
+}
+
+/*-----------------------------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_async_get_error(GlyrAsync * async)
+{
+    if(async == NULL)
+    {
+        return GLYRE_EMPTY_STRUCT;
+    }
+    return (g_atomic_int_get(&async->done)) ? async->error : GLYRE_OK;
+}
+
+/*-----------------------------------------------------------------*/
+
+__attribute__((visibility("default")))
+void glyr_async_free(GlyrAsync * async)
+{
+    if(async == NULL)
+    {
+        return;
+    }
+
+    if(g_atomic_int_get(&async->done) == FALSE)
+    {
+        glyr_signal_exit(async->query);
+    }
+
+    if(async->thread != NULL)
+    {
+        g_thread_join(async->thread);
+    }
+
+    /* The query is the user's again */
+    async->query->callback.download = async->user_callback;
+    async->query->callback.user_pointer = async->user_pointer;
+
+    glyr_free_list(glyr_async_collect(async,NULL));
+    g_async_queue_unref(async->items);
+    close(async->wake_fds[0]);
+    close(async->wake_fds[1]);
+    g_free(async);
+}
+
+/*-----------------------------------------------------------------*/
@@ -23,6 +23,7 @@
 #include "core.h"
 #include "glyr.h"
 #include "register_plugins.h"
+#include "ranking.h"
 
 ///////////////////////////////
 
@@ -33,7 +34,12 @@ enum
     SQL_DELETE_SELECT,
     SQL_ACTUAL_DELETE,
     SQL_LOOKUP,
-    SQL_INSERT_CACHE
+    SQL_INSERT_CACHE,
+    SQL_PROVIDER_STATS,
+    SQL_PROVIDER_RATINGS,
+    SQL_SAVE_PROVIDER_STATS,
+    SQL_LOOKUP_MBID,
+    SQL_STORE_MBID
 };
 
 static const char * sqlcode[] = 
@@ -78,6 +84,26 @@ static const char * sqlcode[] =
         "CREATE INDEX IF NOT EXISTS index_provider_id ON metadata(provider_id);      \n"
         "CREATE UNIQUE INDEX IF NOT EXISTS index_unique                              \n"
         "       ON metadata(get_type,data_type,data_checksum,source_url);            \n"
+        "                                                                            \n"
+        "-- What was learned about the providers, see ranking.h                      \n"
+        "CREATE TABLE IF NOT EXISTS provider_stats(                                  \n"
+        "                     provider_name VARCHAR(20),                             \n"
+        "                     get_type INTEGER,                                      \n"
+        "                     transfers INTEGER,                                     \n"
+        "                     successes INTEGER,                                     \n"
+        "                     items INTEGER,                                         \n"
+        "                     latency_ms FLOAT,                                      \n"
+        "                     UNIQUE(provider_name,get_type)                         \n"
+        ");                                                                          \n"
+        "                                                                            \n"
+        "-- Resolved MusicBrainz IDs, see mbidcache.h                                \n"
+        "CREATE TABLE IF NOT EXISTS mbids(                                           \n"
+        "                     entity VARCHAR(8),                                     \n"
+        "                     names TEXT,                                            \n"
+        "                     mbid VARCHAR(36),                                      \n"
+        "                     timestamp FLOAT,                                       \n"
+        "                     UNIQUE(entity,names)                                   \n"
+        ");                                                                          \n"
         "-- Insert imageformats                                                      \n"
         "INSERT OR IGNORE INTO image_types VALUES('jpeg');                           \n"
         "INSERT OR IGNORE INTO image_types VALUES('jpg');                            \n"
@@ -172,7 +198,22 @@ static const char * sqlcode[] =
        "  ?,                                                                  \n"
        "  (SELECT rowid FROM image_types WHERE image_type_name = LOWER('%q')),\n"
        "  ?,?,?,?,?,?,?,?,?                                                   \n"
-       ");                                                                    \n"
+       ");                                                                    \n",
+   [SQL_PROVIDER_STATS] = 
+       "SELECT provider_name, get_type, transfers, successes, items, latency_ms \n"
+       "FROM provider_stats;                                                   \n",
+   [SQL_PROVIDER_RATINGS] = 
+       "SELECT provider_name, get_type, AVG(rating), COUNT(*)  \n"
+       "FROM metadata AS m                                     \n"
+       "JOIN providers AS p ON m.provider_id = p.rowid         \n"
+       "WHERE rating != 0                                      \n"
+       "GROUP BY provider_name, get_type;                      \n",
+   [SQL_SAVE_PROVIDER_STATS] = 
+       "INSERT OR REPLACE INTO provider_stats VALUES(?,?,?,?,?,?); \n",
+   [SQL_LOOKUP_MBID] = 
+       "SELECT mbid FROM mbids WHERE entity = ? AND names = ?; \n",
+   [SQL_STORE_MBID] = 
+       "INSERT OR REPLACE INTO mbids VALUES(?,?,?,?); \n"
 };
 
 ////////////////////////////////////////////////////////
@@ -331,6 +372,9 @@ GlyrDatabase * glyr_db_init(const char * root_path)
 
                 /* Now create the Tables via sql */
                 execute(to_return,(char*)sqlcode[SQL_TABLE_DEF]);
+
+                /* Rank providers by what earlier runs learned */
+                db_load_provider_stats(to_return);
             }
             else
             {
@@ -735,6 +779,146 @@ static void execute(GlyrDatabase * db, const gchar * sql_statement)
 ////////////////////////////////////
 ////////////////////////////////////
 
+static MetaDataSource * find_provider(const gchar * name, GLYR_GET_TYPE type)
+{
+    for(GList * elem = r_getSList(); elem && name; elem = elem->next)
+    {
+        MetaDataSource * item = elem->data;
+        if(item && (item->type == type || item->type == GLYR_GET_ANY) && g_ascii_strcasecmp(item->name,name) == 0)
+        {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+////////////////////////////////////
+
+void db_load_provider_stats(GlyrDatabase * db)
+{
+    if(db == NULL)
+    {
+        return;
+    }
+
+    /* Counts first, ratings after - those come from the items */
+    for(gint sql = SQL_PROVIDER_STATS; sql <= SQL_PROVIDER_RATINGS; sql++)
+    {
+        sqlite3_stmt * stmt = NULL;
+        if(sqlite3_prepare_v2(db->db_handle,sqlcode[sql],-1,&stmt,NULL) != SQLITE_OK)
+        {
+            glyr_message(-1,NULL,"Loading provider stats failed: %s\n",sqlite3_errmsg(db->db_handle));
+            continue;
+        }
+
+        while(sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            MetaDataSource * source = find_provider((const gchar*)sqlite3_column_text(stmt,0),sqlite3_column_int(stmt,1));
+            if(source != NULL)
+            {
+                RankingRecord record;
+                if(ranking_get(source,&record) == FALSE)
+                {
+                    memset(&record,0,sizeof(RankingRecord));
+                }
+
+                if(sql == SQL_PROVIDER_STATS)
+                {
+                    record.transfers  = sqlite3_column_int64(stmt,2);
+                    record.successes  = sqlite3_column_int64(stmt,3);
+                    record.items      = sqlite3_column_int64(stmt,4);
+                    record.latency_ms = sqlite3_column_double(stmt,5);
+                }
+                else
+                {
+                    record.rating = sqlite3_column_double(stmt,2);
+                    record.rated  = sqlite3_column_int64(stmt,3);
+                }
+                ranking_merge(source,&record);
+            }
+        }
+        sqlite3_finalize(stmt);
+    }
+}
+
+////////////////////////////////////
+
+void db_save_provider_stats(GlyrDatabase * db, GLYR_GET_TYPE type)
+{
+    sqlite3_stmt * stmt = NULL;
+    if(db == NULL || sqlite3_prepare_v2(db->db_handle,sqlcode[SQL_SAVE_PROVIDER_STATS],-1,&stmt,NULL) != SQLITE_OK)
+    {
+        return;
+    }
+
+    execute(db,"BEGIN IMMEDIATE;");
+    for(GList * elem = r_getSList(); elem; elem = elem->next)
+    {
+        MetaDataSource * item = elem->data;
+        RankingRecord record;
+        if(item && item->type == type && ranking_get(item,&record) == TRUE && record.transfers > 0)
+        {
+            sqlite3_bind_text(stmt,1,item->name,-1,SQLITE_STATIC);
+            sqlite3_bind_int(stmt,2,type);
+            sqlite3_bind_int64(stmt,3,record.transfers);
+            sqlite3_bind_int64(stmt,4,record.successes);
+            sqlite3_bind_int64(stmt,5,record.items);
+            sqlite3_bind_double(stmt,6,record.latency_ms);
+
+            if(sqlite3_step(stmt) != SQLITE_DONE)
+            {
+                glyr_message(-1,NULL,"Saving provider stats failed: %s\n",sqlite3_errmsg(db->db_handle));
+            }
+            sqlite3_reset(stmt);
+        }
+    }
+    execute(db,"COMMIT;");
+    sqlite3_finalize(stmt);
+}
+
+////////////////////////////////////
+
+gchar * db_lookup_mbid(GlyrDatabase * db, const gchar * entity, const gchar * names)
+{
+    gchar * mbid = NULL;
+    sqlite3_stmt * stmt = NULL;
+    if(db != NULL && sqlite3_prepare_v2(db->db_handle,sqlcode[SQL_LOOKUP_MBID],-1,&stmt,NULL) == SQLITE_OK)
+    {
+        sqlite3_bind_text(stmt,1,entity,-1,SQLITE_STATIC);
+        sqlite3_bind_text(stmt,2,names,-1,SQLITE_STATIC);
+        if(sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            mbid = g_strdup((const gchar*)sqlite3_column_text(stmt,0));
+        }
+        sqlite3_finalize(stmt);
+    }
+    return mbid;
+}
+
+////////////////////////////////////
+
+void db_store_mbid(GlyrDatabase * db, const gchar * entity, const gchar * names, const gchar * mbid)
+{
+    sqlite3_stmt * stmt = NULL;
+    if(db != NULL && sqlite3_prepare_v2(db->db_handle,sqlcode[SQL_STORE_MBID],-1,&stmt,NULL) == SQLITE_OK)
+    {
+        sqlite3_bind_text(stmt,1,entity,-1,SQLITE_STATIC);
+        sqlite3_bind_text(stmt,2,names,-1,SQLITE_STATIC);
+        sqlite3_bind_text(stmt,3,mbid,-1,SQLITE_STATIC);
+        sqlite3_bind_double(stmt,4,get_current_time());
+
+        if(sqlite3_step(stmt) != SQLITE_DONE)
+        {
+            glyr_message(-1,NULL,"Saving MBID failed: %s\n",sqlite3_errmsg(db->db_handle));
+        }
+        sqlite3_finalize(stmt);
+    }
+}
+
+////////////////////////////////////
+////////////////////////////////////
+////////////////////////////////////
+
 /**
  *  Return the current time as double:
  *  <seconds>.<microseconds/one_second>
@@ -28,4 +28,12 @@
 /* Check if a file is contained in the db */
 gboolean db_contains(GlyrDatabase * db, GlyrMemCache * cache);
 
+/* Feed ranking.h with what's stored in the db, or store it there */
+void db_load_provider_stats(GlyrDatabase * db);
+void db_save_provider_stats(GlyrDatabase * db, GLYR_GET_TYPE type);
+
+/* Backend of mbidcache.h; names is the normalized part of the key */
+gchar * db_lookup_mbid(GlyrDatabase * db, const gchar * entity, const gchar * names);
+void db_store_mbid(GlyrDatabase * db, const gchar * entity, const gchar * names, const gchar * mbid);
+
 #endif
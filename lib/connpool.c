@@ -0,0 +1,134 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include "connpool.h"
+#include "types.h"
+
+/*-----------------------------------------------------------------*/
+
+static CURLSH * share_handle = NULL;
+static GStaticMutex share_locks[CURL_LOCK_DATA_LAST];
+
+static gint pool_max_conns = GLYR_DEFAULT_POOL_SIZE;
+static gint pool_max_idle  = GLYR_DEFAULT_POOL_IDLE;
+
+/*-----------------------------------------------------------------*/
+
+static void share_lock_cb(CURL * eh, curl_lock_data data, curl_lock_access access, void * userptr)
+{
+    g_static_mutex_lock(&share_locks[data]);
+}
+
+/*-----------------------------------------------------------------*/
+
+static void share_unlock_cb(CURL * eh, curl_lock_data data, void * userptr)
+{
+    g_static_mutex_unlock(&share_locks[data]);
+}
+
+/*-----------------------------------------------------------------*/
+
+void connpool_init(void)
+{
+    if(share_handle == NULL)
+    {
+        for(gint i = 0; i < CURL_LOCK_DATA_LAST; i++)
+        {
+            g_static_mutex_init(&share_locks[i]);
+        }
+
+        share_handle = curl_share_init();
+        if(share_handle != NULL)
+        {
+            curl_share_setopt(share_handle, CURLSHOPT_LOCKFUNC, share_lock_cb);
+            curl_share_setopt(share_handle, CURLSHOPT_UNLOCKFUNC, share_unlock_cb);
+            curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            /* The connection cache is not shared on purpose:
+             * libcurl does not support using it from several threads at once.
+             * Every multi handle keeps its own, see connpool_setup_multi() */
+        }
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void connpool_destroy(void)
+{
+    if(share_handle != NULL)
+    {
+        curl_share_cleanup(share_handle);
+        share_handle = NULL;
+
+        for(gint i = 0; i < CURL_LOCK_DATA_LAST; i++)
+        {
+            g_static_mutex_free(&share_locks[i]);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void connpool_attach(CURL * eh)
+{
+    if(eh != NULL && share_handle != NULL)
+    {
+        curl_easy_setopt(eh, CURLOPT_SHARE, share_handle);
+
+#if LIBCURL_VERSION_NUM >= 0x074100
+        gint max_idle = g_atomic_int_get(&pool_max_idle);
+        if(max_idle > 0)
+        {
+            curl_easy_setopt(eh, CURLOPT_MAXAGE_CONN, (long)max_idle);
+        }
+#endif
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void connpool_setup_multi(CURLM * multi, gint parallel)
+{
+    if(multi != NULL)
+    {
+        gint max_conns = g_atomic_int_get(&pool_max_conns);
+
+        /* Easy handles inside a multi ignore CURLOPT_MAXCONNECTS, so the limit goes here */
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, (long)MIN(MAX(parallel,1),max_conns));
+        curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, (long)max_conns);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void connpool_set_limits(gint max_conns, gint max_idle)
+{
+    g_atomic_int_set(&pool_max_conns,max_conns);
+    g_atomic_int_set(&pool_max_idle,max_idle);
+}
+
+/*-----------------------------------------------------------------*/
+
+gint connpool_get_max_connections(void)
+{
+    return g_atomic_int_get(&pool_max_conns);
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,47 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_CONNPOOL_H
+#define GLYR_CONNPOOL_H
+
+#include <glib.h>
+#include <curl/curl.h>
+
+/* Process wide CURLSH, shared by all easy handles libglyr creates.
+ * Caches DNS lookups and TLS sessions, so subsequent queries to the same
+ * provider skip the lookup and the full TLS handshake.
+ * Open connections are NOT reused across queries: libcurl can't share its
+ * connection cache between threads, so each multi handle (one per query) keeps its own.
+ * Only the queries of one glyr_get_batch() share one, that of their Engine.
+ */
+void connpool_init(void);
+void connpool_destroy(void);
+
+/* Make an easy handle use the shared pool; no-op before connpool_init() */
+void connpool_attach(CURL * eh);
+
+/* Apply the connection limits to a multi handle running at most parallel transfers */
+void connpool_setup_multi(CURLM * multi, gint parallel);
+
+/* Limits; max_conns > 0, max_idle in seconds (0 = curl's default) */
+void connpool_set_limits(gint max_conns, gint max_idle);
+gint connpool_get_max_connections(void);
+
+#endif
@@ -23,6 +23,7 @@
 
 #include "stringlib.h"
 #include "core.h"
+#include "register_plugins.h"
 
 /* Get user agent string */
 #include "config.h"
@@ -33,6 +34,40 @@
 /* Mini blacklist */
 #include "blacklist.h"
 
+/* socket_action driver */
+#include "eventloop.h"
+
+/* Multihandle shared by the queries of glyr_get_batch() */
+#include "engine.h"
+
+/* Shared connections */
+#include "connpool.h"
+
+/* Cache of raw responses */
+#include "httpcache.h"
+
+/* Sharing downloads between queries */
+#include "singleflight.h"
+
+/* Per host limits */
+#include "ratelimit.h"
+#include "stats.h"
+
+/* Adaptive timeouts */
+#include "latency.h"
+
+/* Learned provider ranking */
+#include "ranking.h"
+
+/* Format sniffing */
+#include "imgprobe.h"
+
+/* glyr_opt_trace_callback() */
+#include "trace.h"
+
+/* Per provider counters */
+#include "metrics.h"
+
 /* Somehow needed to prevent some compiler warning.. */
 #include <glib/gprintf.h>
 
@@ -95,6 +130,149 @@ gboolean size_is_okay(int sZ, int min, int max)
 
 //////////////////////////////////////
 
+/* Do not trust Content-Length blindly */
+#define DL_MAX_PREALLOC (16 * 1024 * 1024)
+
+/* Smallest allocation if no Content-Length is known */
+#define DL_MIN_ALLOC 4096
+
+/* Give up looking for the image size after this many bytes */
+#define DL_MAX_HEADER_SIZE (128 * 1024)
+
+//////////////////////////////////////
+
+/* Make sure there is space for at least needed bytes (+ nullbyte).
+ * Grows geometrically, so we do not realloc on every chunk. */
+static gboolean DL_reserve(DLBufferContainer * data, gsize needed)
+{
+    GlyrMemCache * mem = data->cache;
+    if(mem->data != NULL && needed + 1 <= data->capacity)
+        return TRUE;
+
+    gsize new_cap = MAX(data->capacity, DL_MIN_ALLOC);
+
+    /* First chunk - use the Content-Length as hint, if any */
+    if(mem->data == NULL && data->handle != NULL)
+    {
+        curl_off_t content_length = -1;
+        if(curl_easy_getinfo(data->handle,CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,&content_length) == CURLE_OK &&
+           content_length > 0 && content_length < DL_MAX_PREALLOC)
+        {
+            new_cap = MAX(new_cap,(gsize)content_length + 1);
+        }
+    }
+
+    while(new_cap < needed + 1)
+    {
+        new_cap *= 2;
+    }
+
+    gchar * new_data = g_try_realloc(mem->data,new_cap);
+    if(new_data == NULL)
+        return FALSE;
+
+    mem->data = new_data;
+    data->capacity = new_cap;
+    return TRUE;
+}
+
+//////////////////////////////////////
+
+static gboolean format_is_allowed(gchar * format, gchar * allowed);
+
+//////////////////////////////////////
+
+/* Check the format by the first bytes, see glyr_opt_sniff_formats() */
+static gboolean DL_check_format(DLBufferContainer * data)
+{
+    GlyrMemCache * mem = data->cache;
+    GlyrQuery * query = data->query;
+    if(query->sniff_formats == TRUE)
+    {
+        const gchar * format = imgprobe_sniff_format((guchar*)mem->data,mem->size);
+        gchar * allowed_formats = query->allowed_formats;
+        if(allowed_formats == NULL)
+        {
+            allowed_formats = GLYR_DEFAULT_ALLOWED_FORMATS;
+        }
+
+        if(format_is_allowed((gchar*)format,allowed_formats) == FALSE)
+        {
+            glyr_message(3,query,"- Cancelling download: format '%s' is not allowed\n",format ? format : "unknown");
+            return FALSE;
+        }
+
+        g_free(mem->img_format);
+        mem->img_format = g_strdup(format);
+    }
+    return TRUE;
+}
+
+//////////////////////////////////////
+
+/* Check the size in pixels against img_min_size/img_max_size */
+static gboolean DL_check_dimensions(DLBufferContainer * data, gboolean complete)
+{
+    GlyrMemCache * mem = data->cache;
+    GlyrQuery * query = data->query;
+
+    gint width = 0, height = 0;
+    ImgProbeResult result = imgprobe_get_dimensions((guchar*)mem->data,mem->size,&width,&height);
+    if(result == IMGPROBE_NEED_MORE && complete == FALSE && mem->size < DL_MAX_HEADER_SIZE)
+    {
+        return TRUE;
+    }
+
+    data->size_checked = TRUE;
+    if(result == IMGPROBE_FOUND)
+    {
+        mem->img_width  = width;
+        mem->img_height = height;
+
+        /* Providers are fuzzy about it too, so take the mean */
+        if(size_is_okay((width + height) / 2,query->img_min_size,query->img_max_size) == FALSE)
+        {
+            glyr_message(3,query,"- Cancelling download: %dx%d is out of range\n",width,height);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+//////////////////////////////////////
+
+/* Look at the header of an image download,
+ * once enough of it is there, or the download is complete.
+ * Returns FALSE if the download should be cancelled.
+ */
+static gboolean DL_check_image(DLBufferContainer * data, gboolean complete)
+{
+    GlyrMemCache * mem = data->cache;
+    if(data->check_image == FALSE || data->size_checked == TRUE || data->query == NULL)
+    {
+        return TRUE;
+    }
+
+    /* Wait for more */
+    if(mem->size < IMGPROBE_MAGIC_LEN && complete == FALSE)
+    {
+        return TRUE;
+    }
+
+    if(data->format_checked == FALSE)
+    {
+        data->format_checked = TRUE;
+        if(DL_check_format(data) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+
+    return DL_check_dimensions(data,complete);
+}
+
+//////////////////////////////////////
+
 /* cache incoming data in a GlyrMemCache
  * libglyr is spending quite some time here
  */
@@ -105,12 +283,12 @@ static size_t DL_buffer(void *puffer, size_t size, size_t nmemb, void * buff_dat
     if(data != NULL)
     {
         GlyrMemCache * mem = data->cache;
-        mem->data = realloc(mem->data, mem->size + realsize + 1);
-        if (mem->data)
+        if (DL_reserve(data, mem->size + realsize))
         {
             memcpy(&(mem->data[mem->size]), puffer, realsize);
             mem->size += realsize;
             mem->data[mem->size] = 0;
+            stats_add(STATS_BYTES_RECEIVED,realsize);
 
             GlyrQuery * query = data->query;
             if(query && GET_ATOMIC_SIGNAL_EXIT(query))
@@ -118,15 +296,35 @@ static size_t DL_buffer(void *puffer, size_t size, size_t nmemb, void * buff_dat
                 return 0;
             }
 
-            /* Test if a endmarker is in this buffer */
-            const gchar * endmarker = data->endmarker;
-            if(endmarker && strstr(mem->data,endmarker))
+            /* Not the image we're looking for? */
+            if(DL_check_image(data,FALSE) == FALSE)
+            {
                 return 0;
+            }
+
+            /* Test if a endmarker is in the new part of the buffer.
+             * The marker might span the last chunk border, so go back len-1 bytes */
+            const gchar * endmarker = data->endmarker;
+            if(endmarker != NULL)
+            {
+                if(strstr(mem->data + data->scan_offset,endmarker))
+                {
+                    data->endmark_hit = TRUE;
+                    return 0;
+                }
+
+                gsize marker_len = strlen(endmarker);
+                if(mem->size >= marker_len)
+                {
+                    data->scan_offset = mem->size - marker_len + 1;
+                }
+            }
         }
         else
         {
             glyr_message(-1,NULL,"Caching failed: Out of memory.\n");
             glyr_message(-1,NULL,"Did you perhaps try to load a 4,7GB .iso into your RAM?\n");
+            return 0;
         }
     }
     return realsize;
@@ -134,6 +332,27 @@ static size_t DL_buffer(void *puffer, size_t size, size_t nmemb, void * buff_dat
 
 //////////////////////////////////////
 
+GlyrMemCache * DL_buffer_replay(const gchar * body, gsize size, gsize chunk, const gchar * endmarker)
+{
+    DLBufferContainer container = {
+        .cache = DL_init(),
+        .endmarker = (gchar*)endmarker
+    };
+
+    chunk = MAX(chunk,1);
+    for(gsize offset = 0; offset < size; offset += chunk)
+    {
+        gsize len = MIN(chunk,size - offset);
+        if(DL_buffer((gchar*)body + offset,1,len,&container) != len)
+        {
+            break;
+        }
+    }
+    return container.cache;
+}
+
+//////////////////////////////////////
+
 void DL_set_data(GlyrMemCache * cache, const gchar * data, gint len)
 {
     if(cache != NULL)
@@ -355,11 +574,11 @@ gsize header_cb(void *ptr, gsize size, gsize nmemb, void *userdata)
 
 //////////////////////////////////////
 
-/* empty callback just prevent writing header to stdout */
-gsize nearly_empty_callback(void * p, gsize size, gsize numb, void * pp_Query)
+/* We only want the headers - stop as soon the body starts.
+ * (This is only reached for amazon, which does not like HEAD) */
+static gsize probe_body_callback(void * p, gsize size, gsize numb, void * userdata)
 {
-    GlyrQuery * query = (GlyrQuery *)pp_Query;
-    return (query && GET_ATOMIC_SIGNAL_EXIT(query)) ? 0 : (size * numb);
+    return 0;
 }
 
 //////////////////////////////////////
@@ -392,24 +611,30 @@ static void DL_setproxy(CURL *eh, gchar * proxystring)
 
 //////////////////////////////////////
 
-static struct header_data * retrieve_content_info(gchar * url, gchar * proxystring, gchar * useragent, GlyrQuery * query)
+/* One running check of the content type of an image URL */
+struct content_probe
 {
-    struct header_data * info = NULL;
-    if(url != NULL)
-    {
-        CURL * eh = curl_easy_init();
-        CURLcode rc = CURLE_OK;
+    GlyrMemCache * item;
+    struct header_data info;
+    CURL * handle;
+};
 
-        info = g_malloc0(sizeof(struct header_data));
-        gchar * link_user_agent =  g_strdup_printf("%s / linkvalidator",useragent);
+//////////////////////////////////////
+
+static CURL * init_content_probe(struct content_probe * probe, GlyrQuery * query, const gchar * link_user_agent)
+{
+    CURL * eh = curl_easy_init();
+    if(eh != NULL)
+    {
+        gchar * url = probe->item->data;
 
-        curl_easy_setopt(eh, CURLOPT_TIMEOUT, 10);
+        curl_easy_setopt(eh, CURLOPT_TIMEOUT_MS, deadline_clamp_ms(query,10000));
         curl_easy_setopt(eh, CURLOPT_NOSIGNAL, 1L);
         curl_easy_setopt(eh, CURLOPT_USERAGENT, link_user_agent);
         curl_easy_setopt(eh, CURLOPT_URL,url);
         curl_easy_setopt(eh, CURLOPT_FOLLOWLOCATION, TRUE);
         curl_easy_setopt(eh, CURLOPT_MAXREDIRS, 5L);
-        curl_easy_setopt(eh, CURLOPT_HEADER,TRUE);
+        curl_easy_setopt(eh, CURLOPT_PRIVATE, probe);
 
         /* Dirty hack here: Amazon bitches at me when setting NOBODY to true *
          * But otherwise large images won't pass with other providers        *
@@ -425,39 +650,20 @@ static struct header_data * retrieve_content_info(gchar * url, gchar * proxystri
         }
 
         curl_easy_setopt(eh, CURLOPT_HEADERFUNCTION, header_cb);
-        curl_easy_setopt(eh, CURLOPT_WRITEFUNCTION, nearly_empty_callback);
-        curl_easy_setopt(eh, CURLOPT_WRITEDATA, query);
-        curl_easy_setopt(eh, CURLOPT_WRITEHEADER, info);
+        curl_easy_setopt(eh, CURLOPT_WRITEHEADER, &probe->info);
+        curl_easy_setopt(eh, CURLOPT_WRITEFUNCTION, probe_body_callback);
 
         /* Set proxy, if any */
-        DL_setproxy(eh, proxystring);
+        DL_setproxy(eh, (gchar*)query->proxy);
+
+        /* HEAD requests benefit from cached DNS entries and TLS sessions too */
+        connpool_attach(eh);
 
         /* This seemed to prevent some valid urls from passing. Strange. */
         //curl_easy_setopt(eh, CURLOPT_FAILONERROR,TRUE);
-
-        rc = curl_easy_perform(eh);
-        curl_easy_cleanup(eh);
-
-        if(rc != CURLE_OK) 
-        {
-            if(GET_ATOMIC_SIGNAL_EXIT(query) == FALSE)
-            {
-                glyr_message(1,query,"- DLError: %s [%d]\n",curl_easy_strerror(rc),rc);
-            }
-            g_free(info);
-            info = NULL;
-        }
-        else
-        {
-            /* Remove trailing newlines,carriage returns */
-            chomp_breakline(info->type);
-            chomp_breakline(info->format);
-            chomp_breakline(info->extra);
-        }
-
-        g_free(link_user_agent);
     }
-    return info;
+    probe->handle = eh;
+    return eh;
 }
 
 //////////////////////////////////////
@@ -484,6 +690,7 @@ static DLBufferContainer * DL_setopt(CURL *eh, GlyrMemCache * cache, const char
     dlbuffer->cache = cache;
     dlbuffer->endmarker = endmarker;
     dlbuffer->query = s;
+    dlbuffer->handle = eh;
 
     // amazon plugin requires redirects
     curl_easy_setopt(eh, CURLOPT_FOLLOWLOCATION, 1L);
@@ -498,6 +705,9 @@ static DLBufferContainer * DL_setopt(CURL *eh, GlyrMemCache * cache, const char
     // Discogs requires gzip compression
     curl_easy_setopt(eh, CURLOPT_ENCODING,"gzip");
 
+    // Reuse DNS entries and TLS sessions of earlier queries
+    connpool_attach(eh);
+
     // Don't save cookies - I had some quite embarassing moments
     // when amazon's startpage showed me "Hooray for Boobies",
     // because I searched for the Bloodhoundgang album...
@@ -523,13 +733,46 @@ gboolean continue_search(gint current, GlyrQuery * s)
          * since many of the *may* be already in the Database
          */
         gint pre_cache = (s->local_db) ? s->number : 0;
-        decision = (current + s->itemctr) < (s->number + buffering + pre_cache) &&
+
+        /* Parsers may run in the parse pool, while the download loop counts the items */
+        decision = (current + g_atomic_int_get(&s->itemctr)) < (s->number + buffering + pre_cache) &&
             (current < s->plugmax || (s->plugmax == -1));
 
     }
     return decision;
 }
 
+//////////////////////////////////////
+
+gint64 deadline_remaining_ms(GlyrQuery * s)
+{
+    if(s == NULL || s->deadline_at <= 0)
+    {
+        return -1;
+    }
+    return MAX(s->deadline_at - g_get_monotonic_time(),0) / 1000;
+}
+
+//////////////////////////////////////
+
+gboolean deadline_passed(GlyrQuery * s)
+{
+    return deadline_remaining_ms(s) == 0;
+}
+
+//////////////////////////////////////
+
+glong deadline_clamp_ms(GlyrQuery * s, glong timeout_ms)
+{
+    gint64 remaining = deadline_remaining_ms(s);
+    if(remaining >= 0)
+    {
+        /* 0 would mean 'no timeout' to curl */
+        timeout_ms = CLAMP(remaining,1,timeout_ms);
+    }
+    return timeout_ms;
+}
+
 //////////////////////////////////////
 // Bad data checker mehods:
 //////////////////////////////////////
@@ -599,6 +842,68 @@ gsize delete_dupes(GList * result, GlyrQuery * s)
 
 //////////////////////////////////////
 
+// Revalidate a stale response, and listen to what the server says about caching
+static void DL_setup_http_cache(CURL * eh, struct curl_slist * validators, HttpCacheMeta * meta)
+{
+    if(validators != NULL)
+    {
+        curl_easy_setopt(eh, CURLOPT_HTTPHEADER, validators);
+    }
+
+    if(httpcache_is_enabled())
+    {
+        curl_easy_setopt(eh, CURLOPT_HEADERFUNCTION, httpcache_header_cb);
+        curl_easy_setopt(eh, CURLOPT_HEADERDATA, meta);
+    }
+}
+
+//////////////////////////////////////
+
+// Remember a complete response, or use the stored one if the server says it's still valid.
+// Returns the body to use from now on.
+static GlyrMemCache * DL_finish_http_cache(CURL * eh, const gchar * url, CURLcode result, GlyrMemCache * body, GlyrMemCache ** stale, HttpCacheMeta * meta)
+{
+    long response_code = 0;
+    if(result == CURLE_OK && curl_easy_getinfo(eh,CURLINFO_RESPONSE_CODE,&response_code) == CURLE_OK)
+    {
+        if(response_code == 304 && *stale != NULL)
+        {
+            httpcache_refresh(url,meta);
+            DL_free(body);
+            body = *stale;
+            *stale = NULL;
+        }
+        else if(response_code == 200)
+        {
+            httpcache_store(url,body,meta);
+        }
+    }
+    return body;
+}
+
+//////////////////////////////////////
+
+/* Bodies from the HTTP cache are complete; cut them after endmark,
+ * like DL_buffer() would have stopped the transfer there */
+static void DL_truncate_at_endmark(GlyrMemCache * body, const gchar * endmark)
+{
+    if(body != NULL && body->data != NULL && endmark != NULL)
+    {
+        gchar * found = strstr(body->data,endmark);
+        if(found != NULL)
+        {
+            body->size = (found - body->data) + strlen(endmark);
+            body->data[body->size] = 0;
+        }
+    }
+}
+
+//////////////////////////////////////
+
+/* Max. time download_single() sleeps at once while waiting for the ratelimit,
+ * so signal_exit is noticed in time */
+#define DL_RATELIMIT_POLL_MS 250
+
 // Download a singe file NOT in parallel
 GlyrMemCache * download_single(const char* url, GlyrQuery * s, const char * end)
 {
@@ -607,6 +912,19 @@ GlyrMemCache * download_single(const char* url, GlyrQuery * s, const char * end)
         CURL *curl = NULL;
         CURLcode res = 0;
 
+        /* Maybe we do not even need to ask */
+        gboolean fresh = FALSE;
+        struct curl_slist * validators = NULL;
+        GlyrMemCache * stale = httpcache_lookup(url,&fresh,&validators);
+        if(stale != NULL && fresh == TRUE)
+        {
+            curl_slist_free_all(validators);
+            DL_truncate_at_endmark(stale,end);
+            update_md5sum(stale);
+            stale->dsrc = g_strdup(url);
+            return stale;
+        }
+
         /* Init handles */
         curl = curl_easy_init();
         GlyrMemCache * dldata = DL_init();
@@ -622,10 +940,46 @@ GlyrMemCache * download_single(const char* url, GlyrQuery * s, const char * end)
         if(curl != NULL)
         {
             /* Configure curl */
+            HttpCacheMeta http_meta = {0};
             DLBufferContainer * dlbuffer = DL_setopt(curl,dldata,url,s,NULL,(s) ? s->timeout : 5, NULL);
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, deadline_clamp_ms(s,((s) ? s->timeout : 5) * 1000L));
+            DL_setup_http_cache(curl,validators,&http_meta);
+
+            /* Wait till the host's limits allow it, but never longer than the timeout,
+             * past the query's deadline or after glyr_signal_exit() */
+            gint64 retry_us = 0;
+            gboolean acquired = FALSE;
+            gchar * host = ratelimit_host_of(url);
+            gint64 wait_until = g_get_monotonic_time() + ((s) ? s->timeout : 5) * G_USEC_PER_SEC;
+            while((acquired = ratelimit_acquire(host,&retry_us)) == FALSE)
+            {
+                gint64 left_us = wait_until - g_get_monotonic_time();
+                if(left_us <= 0 || deadline_passed(s) || (s && GET_ATOMIC_SIGNAL_EXIT(s)))
+                {
+                    break;
+                }
+
+                gint64 sleep_ms = MIN(MIN(retry_us,left_us) / 1000 + 1, DL_RATELIMIT_POLL_MS);
+                g_usleep(deadline_clamp_ms(s,sleep_ms) * 1000);
+            }
 
             /* Perform transaction */
-            res = curl_easy_perform(curl);
+            if(acquired == TRUE)
+            {
+                gint64 started = g_get_monotonic_time();
+                res = curl_easy_perform(curl);
+                ratelimit_release(host);
+                trace_transfer(s,curl,NULL,started);
+            }
+            else if(s && GET_ATOMIC_SIGNAL_EXIT(s))
+            {
+                res = CURLE_ABORTED_BY_CALLBACK;
+            }
+            else
+            {
+                res = CURLE_OPERATION_TIMEDOUT;
+            }
+            g_free(host);
 
             /* Free the pointer buff */
             g_free(dlbuffer);
@@ -639,6 +993,9 @@ GlyrMemCache * download_single(const char* url, GlyrQuery * s, const char * end)
             }
             else
             {
+                dldata = DL_finish_http_cache(curl,url,res,dldata,&stale,&http_meta);
+                DL_truncate_at_endmark(dldata,end);
+
                 /* Set the source URL */
                 if(dldata->dsrc != NULL)
                 {
@@ -649,9 +1006,15 @@ GlyrMemCache * download_single(const char* url, GlyrQuery * s, const char * end)
             }
 
             curl_easy_cleanup(curl);
+            curl_slist_free_all(validators);
+            httpcache_meta_clear(&http_meta);
+            DL_free(stale);
+
             update_md5sum(dldata);
             return dldata;
         }
+        curl_slist_free_all(validators);
+        DL_free(stale);
         DL_free(dldata);
     }
     return NULL;
@@ -659,89 +1022,547 @@ GlyrMemCache * download_single(const char* url, GlyrQuery * s, const char * end)
 
 //////////////////////////////////////
 
-// Init a callback object and a curl_easy_handle
-static GlyrMemCache * init_async_cache(CURLM * cm, cb_object * capo, GlyrQuery *s, long timeout, gchar * endmark)
-{
-    GlyrMemCache * dlcache = NULL;
-    if(capo && capo->url)
-    {
-        /* Init handle */
-        CURL *eh = curl_easy_init();
+/* Max. time to block, so signal_exit is noticed in time */
+#define DL_MAX_WAIT_MS 250
 
-        /* Init cache */
-        dlcache = DL_init();
+/* Transfers of a provider may take DL_LATENCY_FACTOR times 
+ * its DL_LATENCY_PERCENTILE of the latest transfers, 
+ * but at least DL_MIN_TIMEOUT_MS, and at most GlyrQuery.timeout */
+#define DL_LATENCY_PERCENTILE 0.99
+#define DL_LATENCY_FACTOR 3
+#define DL_MIN_TIMEOUT_MS 2000
 
-        /* Remind this handle */
-        capo->handle = eh;
+/* Hedging: A transfer that brought no item within DL_HEDGE_PERCENTILE 
+ * of its provider's latency (or the timeout / DL_HEDGE_TIMEOUT_DIVISOR, 
+ * if unknown) lets the next provider start */
+#define DL_HEDGE_PERCENTILE 0.95
+#define DL_HEDGE_TIMEOUT_DIVISOR 4
 
-        /* Make sure this is null at start */
-        capo->dlbuffer = NULL;
+/* Max. number of threads one async_download() parses with */
+#define DL_MAX_PARSE_THREADS 4
 
-        /* Configure this handle */
-        capo->dlbuffer = DL_setopt(eh, dlcache, capo->url, s,(void*)capo,timeout, endmark);
+//////////////////////////////////////
 
-        /* Add handle to multihandle */
-        curl_multi_add_handle(cm, eh);
+/* State of one async_download() */
+typedef struct {
+    GlyrQuery * s;
+    CURLM * cmHandle;
+    EventLoop * loop;
+    long abs_timeout;
 
-        /* This is set to true once DL_buffer is reached */
-        capo->was_buffered = FALSE;
+    /* If set the transfers run there, and cmHandle stays empty */
+    EngineClient * client;
 
-    }
-    return dlcache;
-}
+    AsyncDLCB callback;
+    AsyncParseCB parse_callback;
+    AsyncProviderCB next_provider;
+    void * userptr;
+
+    /* Runs parse_callback; created once needed */
+    GThreadPool * parse_pool;
+
+    GList * cb_list;
+
+    /* Storage for result items */
+    GList * item_list;
+
+    /* Once set to true this will terminate the download */
+    gboolean terminate;
+
+    /* When to try again to start queued transfers, in µs from now; -1 if none are queued */
+    gint64 retry_us;
+
+    /* Number of providers with anything pending, see update_provider_busy() */
+    gint busy_providers;
+} AsyncDownload;
 
 //////////////////////////////////////
 
-static GList * init_async_download(GList * url_list, GList * endmark_list, CURLM * cmHandle, GlyrQuery * s, int abs_timeout)
+/* Keep track of what a provider still has pending (a transfer, a shared download, 
+ * a parser or a cache hit to deliver). Follow-ups count for the first request of their provider.
+ * Called whenever one of those might have changed, so refill_slots() needs no scan */
+static void update_provider_busy(AsyncDownload * dl, cb_object * capo)
 {
-    GList * cb_list = NULL;
-    for(GList * elem = url_list; elem; elem = elem->next)
+    if(capo->source == NULL)
     {
-        if(is_blacklisted((gchar*)elem->data) == false)
-        {
-            cb_object * obj = g_malloc0(sizeof(cb_object));
-            obj->s = s;
-            obj->url = g_strdup((gchar*)(elem->data));
-            cb_list = g_list_prepend(cb_list,obj);
-            obj->consumed = FALSE;
+        return;
+    }
 
-            /* Get the endmark from the endmark list */
-            gint endmark_pos = g_list_position(url_list,elem);
-            GList * glist_m  = g_list_nth(endmark_list,endmark_pos);
-            gchar * endmark  = (glist_m==NULL) ? NULL : glist_m->data;
-            obj->cache = init_async_cache(cmHandle,obj,s,abs_timeout,endmark);
+    gboolean pending = (capo->handle != NULL || capo->flight != NULL || capo->parsing == TRUE ||
+                       (capo->cache_hit == TRUE && capo->was_buffered == FALSE));
+    if(pending == capo->pending)
+    {
+        return;
+    }
+    capo->pending = pending;
+
+    cb_object * origin = capo;
+    while(origin->parent != NULL)
+    {
+        origin = origin->parent;
+    }
+
+    if(pending == TRUE)
+    {
+        if(origin->pending_requests++ == 0)
+        {
+            dl->busy_providers++;
         }
     }
-    return cb_list;
+    else if(--origin->pending_requests == 0)
+    {
+        dl->busy_providers--;
+    }
 }
 
 //////////////////////////////////////
 
-static void destroy_async_download(GList * cb_list, CURLM * cmHandle, gboolean free_caches)
+/* Downloads may only be shared if they'd deliver the same */
+static gchar * flight_key(GlyrQuery * s, const gchar * url, const gchar * endmark)
 {
-    /* Free ressources */
-    curl_multi_cleanup(cmHandle);
+    return g_strdup_printf("%s\n%s\n%s\n%d\n%s",url,
+                           (s && s->useragent) ? s->useragent : GLYR_DEFAULT_USERAGENT,
+                           (s && s->proxy) ? s->proxy : "",
+                           (s) ? s->redirects : 2,
+                           (endmark) ? endmark : "");
+}
 
-    if(cb_list != NULL)
+//////////////////////////////////////
+
+/* Timeout in ms for a transfer of capo; 
+ * abs_timeout (in seconds) as long as nothing is known about its provider */
+static long adaptive_timeout(GlyrQuery * s, cb_object * capo, long abs_timeout)
+{
+    long timeout_ms = abs_timeout * 1000;
+    gint64 percentile = latency_percentile(capo->source,DL_LATENCY_PERCENTILE);
+    if(percentile >= 0)
     {
-        for (GList * elem = cb_list; elem; elem = elem->next)
-        { 
-            cb_object * item = elem->data;
-            if(item->handle != NULL)
-            {
-                curl_easy_cleanup(item->handle);
-            }
+        timeout_ms = CLAMP(percentile * DL_LATENCY_FACTOR,DL_MIN_TIMEOUT_MS,MAX(s->timeout * 1000,DL_MIN_TIMEOUT_MS));
+        glyr_message(4,s,"- Timeout for %s: %ldms (p99: %ldms)\n",capo->source->name,timeout_ms,(long)percentile);
+    }
+    return deadline_clamp_ms(s,timeout_ms);
+}
 
-            /* Also free unbuffered items, that don't appear in the queue,
-             * even if free_caches was set to FALSE 
-             */
-            if((free_caches == TRUE || item->was_buffered == FALSE)
-               && item->consumed == FALSE)
+//////////////////////////////////////
+
+/* Put it on the multihandle, if the limits of the host allow it.
+ * Otherwise it's queued, and tried again by start_queued() */
+static void start_transfer(AsyncDownload * dl, cb_object * capo)
+{
+    gint64 retry_us = 0;
+    if(capo->host == NULL)
+    {
+        capo->host = ratelimit_host_of(capo->url);
+    }
+
+    if(ratelimit_acquire(capo->host,&retry_us) == TRUE)
+    {
+        if(capo->queued == TRUE)
+        {
+            gint64 waited_ms = (g_get_monotonic_time() - capo->queued_since) / 1000;
+            stats_add(STATS_QUEUE_WAIT_MS,waited_ms);
+            stats_max(STATS_QUEUE_WAIT_MAX_MS,waited_ms);
+            capo->queued = FALSE;
+
+            /* The wait counts against the timeout too */
+            glong left_ms = MAX(dl->s->timeout * 1000L - waited_ms,1);
+            curl_easy_setopt(capo->handle,CURLOPT_TIMEOUT_MS,MIN(adaptive_timeout(dl->s,capo,dl->abs_timeout),left_ms));
+        }
+
+        capo->holds_slot = TRUE;
+        capo->started = g_get_monotonic_time();
+        capo->started_itemctr = dl->s->itemctr;
+        if(dl->client != NULL)
+        {
+            engine_client_add(dl->client,capo->handle);
+        }
+        else
+        {
+            curl_multi_add_handle(dl->cmHandle,capo->handle);
+        }
+    }
+    else
+    {
+        if(capo->queued == FALSE)
+        {
+            glyr_message(3,dl->s,"- Limit of %s reached, queueing: %s\n",capo->host,capo->url);
+            stats_add(STATS_TRANSFERS_QUEUED,1);
+            capo->queued_since = g_get_monotonic_time();
+            capo->queued = TRUE;
+        }
+
+        /* Wake up in time to let expire_queued() give up on it */
+        gint64 expires_us = capo->queued_since + (gint64)dl->s->timeout * G_USEC_PER_SEC - g_get_monotonic_time();
+        retry_us = CLAMP(expires_us,0,retry_us);
+        dl->retry_us = (dl->retry_us < 0) ? retry_us : MIN(dl->retry_us,retry_us);
+    }
+}
+
+//////////////////////////////////////
+
+/* Try to start everything that waits for the host limits */
+static void start_queued(AsyncDownload * dl)
+{
+    dl->retry_us = -1;
+    for(GList * elem = dl->cb_list; elem && GET_ATOMIC_SIGNAL_EXIT(dl->s) == FALSE; elem = elem->next)
+    {
+        cb_object * capo = elem->data;
+        if(capo->queued == TRUE)
+        {
+            start_transfer(dl,capo);
+        }
+    }
+}
+
+//////////////////////////////////////
+
+/* Done with the transfer; let others talk to this host */
+static void release_slot(cb_object * capo)
+{
+    if(capo->holds_slot == TRUE)
+    {
+        ratelimit_release(capo->host);
+        capo->holds_slot = FALSE;
+    }
+}
+
+//////////////////////////////////////
+
+/* A transfer stopped at the endmark on purpose: everything needed is there */
+static CURLcode transfer_result(cb_object * capo, CURLcode result)
+{
+    if(result == CURLE_WRITE_ERROR && capo->dlbuffer != NULL && capo->dlbuffer->endmark_hit == TRUE)
+    {
+        result = CURLE_OK;
+    }
+    return result;
+}
+
+//////////////////////////////////////
+
+/* Remember how a transfer of capo's provider went.
+ * Timeouts count for the latency too, so a provider that got slower gets more time again.
+ * Transfers we cancelled ourselves tell nothing about the provider */
+static void record_transfer(cb_object * capo, CURLcode result)
+{
+    double total_time = 0.0;
+    if(capo->source != NULL && capo->handle != NULL && 
+       curl_easy_getinfo(capo->handle,CURLINFO_TOTAL_TIME,&total_time) == CURLE_OK)
+    {
+        gint64 latency_ms = (gint64)(total_time * 1000);
+        CURLcode effective = transfer_result(capo,result);
+        if(effective == CURLE_OK || effective == CURLE_OPERATION_TIMEDOUT)
+        {
+            latency_record(capo->source,latency_ms);
+        }
+
+        if(effective != CURLE_WRITE_ERROR && effective != CURLE_ABORTED_BY_CALLBACK)
+        {
+            ranking_record_transfer(capo->source,effective == CURLE_OK,latency_ms);
+            metrics_add(capo->source,METRICS_ERRORS,effective != CURLE_OK);
+        }
+
+        curl_off_t received = 0;
+        curl_easy_getinfo(capo->handle,CURLINFO_SIZE_DOWNLOAD_T,&received);
+        metrics_add(capo->source,METRICS_REQUESTS,1);
+        metrics_add(capo->source,METRICS_BYTES,received);
+
+        if(effective == CURLE_OK)
+        {
+            metrics_observe_latency(capo->source,latency_ms);
+        }
+    }
+}
+
+//////////////////////////////////////
+
+// Init a callback object and a curl_easy_handle
+static GlyrMemCache * init_async_cache(AsyncDownload * dl, cb_object * capo, gchar * endmark, gboolean image)
+{
+    GlyrMemCache * dlcache = NULL;
+    if(capo && capo->url)
+    {
+        GlyrQuery * s = dl->s;
+
+        /* This is set to true once DL_buffer is reached */
+        capo->was_buffered = FALSE;
+
+        /* Make sure this is null at start */
+        capo->dlbuffer = NULL;
+
+        /* Needed again if we have to download it ourselves after all */
+        capo->endmark = endmark;
+
+        /* Images are checked while downloading, so those never come from the HTTP cache,
+         * and are not shared with others. Neither is what we gave up waiting for */
+        if(image == FALSE && capo->solo == FALSE)
+        {
+            gboolean fresh = FALSE;
+            dlcache = httpcache_lookup(capo->url,&fresh,&capo->validators);
+            if(dlcache != NULL && fresh == TRUE)
+            {
+                /* async_download() delivers it without any transfer */
+                DL_truncate_at_endmark(dlcache,endmark);
+                capo->cache_hit = TRUE;
+                return dlcache;
+            }
+
+            /* Outdated, but the server might tell us it's still valid */
+            capo->stale = dlcache;
+            dlcache = NULL;
+
+            /* Another query might download the very same right now */
+            gchar * key = flight_key(s,capo->url,endmark);
+            capo->flight = singleflight_join(key,dl->loop,&capo->flight_leader);
+            g_free(key);
+
+            if(capo->flight_leader == FALSE)
+            {
+                glyr_message(3,s,"- Waiting for identical download: %s\n",capo->url);
+                capo->flight_joined = g_get_monotonic_time();
+                DL_free(capo->stale);
+                capo->stale = NULL;
+                curl_slist_free_all(capo->validators);
+                capo->validators = NULL;
+                return NULL;
+            }
+        }
+
+        /* Init handle */
+        CURL *eh = curl_easy_init();
+
+        /* Init cache */
+        dlcache = DL_init();
+
+        /* Remind this handle */
+        capo->handle = eh;
+
+        /* Configure this handle */
+        capo->dlbuffer = DL_setopt(eh, dlcache, capo->url, s,(void*)capo,dl->abs_timeout, endmark);
+        capo->dlbuffer->check_image = image;
+        curl_easy_setopt(eh, CURLOPT_TIMEOUT_MS, adaptive_timeout(s,capo,dl->abs_timeout));
+        if(image == FALSE)
+        {
+            DL_setup_http_cache(eh,capo->validators,&capo->http_meta);
+        }
+
+        /* Add handle to multihandle, or wait till it's allowed */
+        start_transfer(dl,capo);
+    }
+    return dlcache;
+}
+
+//////////////////////////////////////
+
+/* A new cb_object for url, with its download started. NULL if url is blacklisted */
+static cb_object * add_download(AsyncDownload * dl, const gchar * url, gchar * endmark, MetaDataSource * source, gboolean image)
+{
+    cb_object * obj = NULL;
+    const gchar * stripped = STRIP_KNOWN_PAGE_MARK(url);
+    if(is_blacklisted((gchar*)stripped) == false)
+    {
+        obj = g_malloc0(sizeof(cb_object));
+        obj->s = dl->s;
+        obj->url = g_strdup(stripped);
+        obj->known_page = (stripped != url);
+        obj->consumed = FALSE;
+        obj->source = source;
+        obj->cache = init_async_cache(dl,obj,endmark,image);
+        update_provider_busy(dl,obj);
+    }
+    return obj;
+}
+
+//////////////////////////////////////
+
+static GList * init_async_download(AsyncDownload * dl, GList * url_list, GList * endmark_list, GList * source_list, gboolean images)
+{
+    GList * cb_list = NULL;
+    for(GList * elem = url_list; elem; elem = elem->next)
+    {
+        /* Get the endmark from the endmark list */
+        gint endmark_pos = g_list_position(url_list,elem);
+        GList * glist_m  = g_list_nth(endmark_list,endmark_pos);
+        gchar * endmark  = (glist_m==NULL) ? NULL : glist_m->data;
+
+        /* Same for the provider */
+        GList * glist_s = g_list_nth(source_list,endmark_pos);
+        MetaDataSource * source = (glist_s==NULL) ? NULL : glist_s->data;
+
+        cb_object * obj = add_download(dl,elem->data,endmark,source,images);
+        if(obj != NULL)
+        {
+            cb_list = g_list_prepend(cb_list,obj);
+        }
+    }
+    return cb_list;
+}
+
+//////////////////////////////////////
+
+gboolean fetch_followup(cb_object * capo, const gchar * url, const gchar * endmark, FollowupCB continuation, gpointer userdata, GDestroyNotify free_userdata)
+{
+    if(capo == NULL || url == NULL || continuation == NULL || is_blacklisted((gchar*)url) == true)
+    {
+        if(free_userdata != NULL && userdata != NULL)
+        {
+            free_userdata(userdata);
+        }
+        return FALSE;
+    }
+
+    cb_object * child = g_malloc0(sizeof(cb_object));
+    child->s = capo->s;
+    child->url = g_strdup(url);
+    child->parent = capo;
+    child->endmark = (gchar*)endmark;
+    child->source = capo->source;
+    child->continuation = continuation;
+    child->cont_userdata = userdata;
+    child->cont_free = free_userdata;
+
+    /* Scheduled by async_download() after the parser returned */
+    capo->followups = g_list_prepend(capo->followups,child);
+    return TRUE;
+}
+
+//////////////////////////////////////
+
+/* Put the follow-ups a parser requested on the multihandle,
+ * they're added to cb_list, so they're freed along with the rest */
+static void schedule_followups(AsyncDownload * dl, cb_object * capo, gboolean terminate)
+{
+    capo->followups = g_list_reverse(capo->followups);
+    for(GList * elem = capo->followups; elem; elem = elem->next)
+    {
+        cb_object * child = elem->data;
+        if(terminate == FALSE)
+        {
+            glyr_message(3,capo->s,"- Following up on: %s\n",child->url);
+            child->cache = init_async_cache(dl,child,child->endmark,FALSE);
+            update_provider_busy(dl,child);
+        }
+        dl->cb_list = g_list_prepend(dl->cb_list,child);
+    }
+
+    g_list_free(capo->followups);
+    capo->followups = NULL;
+}
+
+//////////////////////////////////////
+
+/* Leave all shared downloads, so nobody waits for us, or wakes up our loop */
+static void leave_flights(GList * cb_list, EventLoop * loop)
+{
+    for(GList * elem = cb_list; elem; elem = elem->next)
+    {
+        cb_object * item = elem->data;
+        if(item->flight != NULL)
+        {
+            if(item->flight_leader == TRUE)
+            {
+                singleflight_complete(item->flight,NULL,CURLE_ABORTED_BY_CALLBACK,TRUE);
+                singleflight_leave(item->flight,NULL);
+            }
+            else
+            {
+                singleflight_leave(item->flight,loop);
+            }
+            item->flight = NULL;
+        }
+    }
+}
+
+//////////////////////////////////////
+
+/* Abort all transfers still running once async_download() is done,
+ * before they bring in more data nobody asked for */
+static void cancel_transfers(AsyncDownload * dl)
+{
+    gint cancelled = 0;
+    gint64 saved = 0;
+
+    /* The engine lets go of our handles first; they're ours alone afterwards */
+    gboolean on_engine = (dl->client != NULL);
+    engine_client_free(dl->client);
+    dl->client = NULL;
+    for(GList * elem = dl->cb_list; elem; elem = elem->next)
+    {
+        cb_object * capo = elem->data;
+        if(capo->handle != NULL && capo->holds_slot == TRUE)
+        {
+            /* Content-Length is -1 if unknown */
+            curl_off_t expected = -1, received = 0;
+            curl_easy_getinfo(capo->handle,CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,&expected);
+            curl_easy_getinfo(capo->handle,CURLINFO_SIZE_DOWNLOAD_T,&received);
+            if(expected > received)
+            {
+                saved += expected - received;
+            }
+
+            metrics_add(capo->source,METRICS_REQUESTS,1);
+            metrics_add(capo->source,METRICS_BYTES,received);
+
+            if(on_engine == FALSE)
+            {
+                curl_multi_remove_handle(dl->cmHandle,capo->handle);
+            }
+            release_slot(capo);
+            cancelled++;
+        }
+    }
+
+    if(cancelled > 0)
+    {
+        glyr_message(3,dl->s,"- Cancelled %d transfer(s), saved %ld byte(s)\n",cancelled,(long)saved);
+        stats_add(STATS_BYTES_SAVED,saved);
+    }
+}
+
+//////////////////////////////////////
+
+static void destroy_async_download(GList * cb_list, CURLM * cmHandle, EventLoop * loop, gboolean free_caches)
+{
+    leave_flights(cb_list,loop);
+
+    /* Free ressources; cleanup might still call the socket callback */
+    curl_multi_cleanup(cmHandle);
+    eventloop_destroy(loop);
+
+    if(cb_list != NULL)
+    {
+        for (GList * elem = cb_list; elem; elem = elem->next)
+        { 
+            cb_object * item = elem->data;
+            if(item->handle != NULL)
+            {
+                curl_easy_cleanup(item->handle);
+            }
+            release_slot(item);
+            g_free(item->host);
+
+            /* Also free unbuffered items, that don't appear in the queue,
+             * even if free_caches was set to FALSE 
+             */
+            if((free_caches == TRUE || item->was_buffered == FALSE)
+               && item->consumed == FALSE)
             {
                 DL_free(item->cache);
                 item->cache = NULL;
             }
 
+            /* Follow-up that never got to its continuation */
+            if(item->cont_free != NULL && item->cont_userdata != NULL)
+            {
+                item->cont_free(item->cont_userdata);
+                item->cont_userdata = NULL;
+            }
+
+            /* HTTP cache leftovers */
+            DL_free(item->stale);
+            curl_slist_free_all(item->validators);
+            httpcache_meta_clear(&item->http_meta);
+
             g_free(item->dlbuffer);
             g_free(item->url);
         }
@@ -750,284 +1571,728 @@ static void destroy_async_download(GList * cb_list, CURLM * cmHandle, gboolean f
 }
 
 //////////////////////////////////////
-/* ----------------- THE HEART OF GOLD ------------------ */
+
+/* The parser is done, or there is none: Pass capo to the callback and keep what it returns */
+static void pass_to_callback(AsyncDownload * dl, cb_object * capo)
+{
+    /* How many items from the callback will actually be added */
+    gint to_add = 0;
+
+    /* Stop download after this came in */
+    bool stop_download = false;
+    GList * cb_results = NULL;
+
+    /* Call it if present */
+    if(dl->callback != NULL)
+    {
+        /* Add parsed results or nothing if parsed result is empty */
+        cb_results = dl->callback(capo,dl->userptr,&stop_download,&to_add);
+    }
+
+    /* The parser wants to see more pages before it can tell */
+    if(capo->followups != NULL)
+    {
+        schedule_followups(dl,capo,stop_download);
+    }
+
+    if(cb_results != NULL)
+    {
+        /* Fill in the source filed (dsrc) if not already done */
+        for(GList * elem = cb_results; elem; elem = elem->next)
+        {
+            GlyrMemCache * item = elem->data;
+            if(item && item->dsrc == NULL)
+            {
+                /* Plugin didn't do any special download */
+                item->dsrc = g_strdup(capo->url);
+            }
+            dl->item_list = g_list_prepend(dl->item_list,item);
+        }
+        g_list_free(cb_results);
+    }
+    else if(to_add != 0)
+    {
+        /* Add it as raw data */
+        dl->item_list = g_list_prepend(dl->item_list,capo->cache);
+    }
+    else
+    {
+        capo->consumed = TRUE;
+        DL_free(capo->cache);
+        capo->cache = NULL;
+    }
+
+    /* So, shall we stop? */
+    dl->terminate = stop_download;
+    update_provider_busy(dl,capo);
+}
+
 //////////////////////////////////////
-GList * async_download(GList * url_list, GList * endmark_list, GlyrQuery * s, long parallel_fac, long timeout_fac, AsyncDLCB asdl_callback, void * userptr, gboolean free_caches)
+
+/* Runs in a thread of dl->parse_pool; deliver_ready() picks the result up */
+static void parse_worker(gpointer data, gpointer user_data)
 {
-    /* Storage for result items */
-    GList * item_list = NULL;
+    cb_object * capo = data;
+    AsyncDownload * dl = user_data;
 
-    if(url_list != NULL && s != NULL)
+    capo->parsed = dl->parse_callback(capo,dl->userptr);
+    g_atomic_int_set(&capo->parse_ready,TRUE);
+    eventloop_wakeup(dl->loop);
+}
+
+//////////////////////////////////////
+
+/* Let the parse_callback work on capo while we go on downloading.
+ * Returns FALSE if no thread could be started, it needs to be passed on right away then */
+static gboolean start_parsing(AsyncDownload * dl, cb_object * capo)
+{
+    if(dl->parse_pool == NULL)
     {
-        /* total timeout and parallel tries */
-        long abs_timeout  = ABS(timeout_fac  * s->timeout);
-        long abs_parallel = ABS(parallel_fac * s->parallel);
+        dl->parse_pool = g_thread_pool_new(parse_worker,dl,DL_MAX_PARSE_THREADS,FALSE,NULL);
+        if(dl->parse_pool == NULL)
+        {
+            return FALSE;
+        }
+    }
 
-        /* select() control */
-        int max_fd, queue_msg, running_handles = -1;
-        long wait_time;
-        fd_set ReadFDS, WriteFDS, ErrorFDS;
+    capo->parsing = TRUE;
+    g_thread_pool_push(dl->parse_pool,capo,NULL);
+    return TRUE;
+}
 
-        /* Curl Multi Handles (~ container for easy handlers) */
-        CURLM   * cmHandle = curl_multi_init();
-        curl_multi_setopt(cmHandle, CURLMOPT_MAXCONNECTS,abs_parallel);
-        curl_multi_setopt(cmHandle, CURLMOPT_PIPELINING, 1L);
+//////////////////////////////////////
 
-        /* Once set to true this will terminate the download */
-        gboolean terminate = FALSE;
+/* Wait for the parser threads to finish, and throw away what they have been working on */
+static void stop_parsing(AsyncDownload * dl)
+{
+    if(dl->parse_pool == NULL)
+    {
+        return;
+    }
 
-        /* Now create cb_objects */
-        GList * cb_list = init_async_download(url_list,endmark_list,cmHandle,s,abs_timeout);
+    /* Jobs that did not start yet are dropped */
+    g_thread_pool_free(dl->parse_pool,TRUE,TRUE);
+    dl->parse_pool = NULL;
 
-        while(GET_ATOMIC_SIGNAL_EXIT(s) == FALSE && running_handles != 0 && terminate == FALSE)
+    for(GList * elem = dl->cb_list; elem; elem = elem->next)
+    {
+        cb_object * capo = elem->data;
+        if(capo->parsing == TRUE)
         {
-            CURLMcode merr = CURLM_CALL_MULTI_PERFORM;
-            while(merr == CURLM_CALL_MULTI_PERFORM)
+            for(GList * item = capo->parsed; item; item = item->next)
             {
-                merr = curl_multi_perform(cmHandle, &running_handles);
+                DL_free(item->data);
             }
-            if(merr != CURLM_OK)
+            g_list_free(capo->parsed);
+            capo->parsed = NULL;
+
+            /* Only freed along with cb_list */
+            if(capo->followups != NULL)
             {
-                glyr_message(1,s,"Error: curl_multi_perform() failed!");
-                return NULL;
+                schedule_followups(dl,capo,TRUE);
             }
 
-            if(running_handles != 0)
+            DL_free(capo->cache);
+            capo->cache = NULL;
+            capo->consumed = TRUE;
+            capo->parsing = FALSE;
+            update_provider_busy(dl,capo);
+        }
+    }
+}
+
+//////////////////////////////////////
+
+/* A download is complete (or came from the HTTP cache, or another query): Pass it to the callback */
+static void finish_download(AsyncDownload * dl, cb_object * capo, CURLcode result)
+{
+    /* Worth to be remembered? Or still valid? */
+    if(capo->handle != NULL && capo->dlbuffer != NULL && capo->dlbuffer->check_image == FALSE)
+    {
+        capo->cache = DL_finish_http_cache(capo->handle,capo->url,result,capo->cache,&capo->stale,&capo->http_meta);
+        DL_truncate_at_endmark(capo->cache,capo->endmark);
+        capo->dlbuffer->cache = capo->cache;
+    }
+
+    result = transfer_result(capo,result);
+
+    /* Others might wait for the very same */
+    if(capo->flight != NULL && capo->flight_leader == TRUE)
+    {
+        /* Cancelled by us, not by the server - the others should try themselves */
+        gboolean abandoned = (result == CURLE_WRITE_ERROR || result == CURLE_ABORTED_BY_CALLBACK);
+        singleflight_complete(capo->flight,capo->cache,result,abandoned);
+        singleflight_leave(capo->flight,NULL);
+        capo->flight = NULL;
+    }
+
+    /* It's useless if it's empty  */
+    if(capo->cache && capo->cache->data == NULL)
+    {
+        capo->consumed = TRUE;
+        DL_free(capo->cache);
+        capo->cache = NULL;
+    }
+
+    /* Too short to be checked while downloading */
+    if(capo->cache && capo->dlbuffer && DL_check_image(capo->dlbuffer,TRUE) == FALSE)
+    {
+        capo->consumed = TRUE;
+        DL_free(capo->cache);
+        capo->cache = NULL;
+    }
+
+    /* Mark this cb_object as  */
+    capo->was_buffered = TRUE;
+
+    /* capo contains now the downloaded cache, ready to parse */
+    if(result == CURLE_OK && capo->cache)
+    {
+        /* Set origin */
+        if(capo->cache->dsrc != NULL)
+        {
+            g_free(capo->cache->dsrc);
+        }
+        capo->cache->dsrc = g_strdup(capo->url);
+
+        /* Parse it in the background, unless there's nothing to parse for anymore */
+        gboolean background = (dl->parse_callback != NULL && dl->callback != NULL && dl->s->itemctr < dl->s->number);
+        if(background == FALSE || start_parsing(dl,capo) == FALSE)
+        {
+            pass_to_callback(dl,capo);
+        }
+    }
+    else
+    {
+        /* Something in this download was wrong. Tell us what. */
+        char * errstring = (char*)curl_easy_strerror(result);
+        glyr_message(3,capo->s,"- glyr: Downloaderror: %s [errno:%d]\n",
+                errstring ? errstring : "Unknown Error",
+                result);
+
+        glyr_message(3,capo->s,"  On URL: ");
+        glyr_message(3,capo->s,"%s\n",capo->url);
+
+        DL_free(capo->cache);
+        capo->cache = NULL;
+        capo->consumed = TRUE;
+    }
+    update_provider_busy(dl,capo);
+}
+
+//////////////////////////////////////
+
+/* Transfers that waited for their host longer than the timeout fail like timed out ones */
+static void expire_queued(AsyncDownload * dl)
+{
+    gint64 now = g_get_monotonic_time();
+    for(GList * elem = dl->cb_list; elem; elem = elem->next)
+    {
+        cb_object * capo = elem->data;
+        if(capo->queued == TRUE && now - capo->queued_since >= (gint64)dl->s->timeout * G_USEC_PER_SEC)
+        {
+            glyr_message(3,dl->s,"- Waited too long for %s, giving up: %s\n",capo->host,capo->url);
+            capo->queued = FALSE;
+            finish_download(dl,capo,CURLE_OPERATION_TIMEDOUT);
+            curl_easy_cleanup(capo->handle);
+            capo->handle = NULL;
+            update_provider_busy(dl,capo);
+        }
+    }
+}
+
+//////////////////////////////////////
+
+/* Take the result of a download another query did for us */
+static void land_flight(AsyncDownload * dl, cb_object * capo)
+{
+    CURLcode result = CURLE_OK;
+    gboolean abandoned = FALSE;
+    GlyrMemCache * body = singleflight_take(capo->flight,dl->loop,&result,&abandoned);
+    capo->flight = NULL;
+
+    if(abandoned == TRUE)
+    {
+        /* It gave up; do it ourselves then */
+        capo->cache = init_async_cache(dl,capo,capo->endmark,FALSE);
+    }
+    else
+    {
+        capo->cache = body;
+        finish_download(dl,capo,result);
+    }
+    update_provider_busy(dl,capo);
+}
+
+//////////////////////////////////////
+
+/* The leader takes longer than we'd wait for a transfer of ours; download it ourselves.
+ * The deadline ends the whole query anyway */
+static gboolean skip_flight(AsyncDownload * dl, cb_object * capo)
+{
+    if(g_get_monotonic_time() - capo->flight_joined < (gint64)dl->s->timeout * G_USEC_PER_SEC)
+    {
+        return FALSE;
+    }
+
+    glyr_message(3,dl->s,"- Waited too long for identical download, fetching it myself: %s\n",capo->url);
+    singleflight_leave(capo->flight,dl->loop);
+    capo->flight = NULL;
+    capo->solo = TRUE;
+    capo->cache = init_async_cache(dl,capo,capo->endmark,FALSE);
+    update_provider_busy(dl,capo);
+    return TRUE;
+}
+
+//////////////////////////////////////
+
+/* Pass everything that came without a transfer of ours to the callback: 
+ * From the HTTP cache, downloaded by another query, or parsed meanwhile.
+ * Includes follow-ups that were found there in turn */
+static void deliver_ready(AsyncDownload * dl)
+{
+    gboolean delivered = TRUE;
+    while(delivered == TRUE && dl->terminate == FALSE && GET_ATOMIC_SIGNAL_EXIT(dl->s) == FALSE)
+    {
+        delivered = FALSE;
+        for(GList * elem = dl->cb_list; elem && dl->terminate == FALSE; elem = elem->next)
+        {
+            cb_object * capo = elem->data;
+            if(capo->cache_hit == TRUE && capo->was_buffered == FALSE)
+            {
+                glyr_message(3,dl->s,"- Served from HTTP cache: %s\n",capo->url);
+                finish_download(dl,capo,CURLE_OK);
+                delivered = TRUE;
+            }
+            else if(capo->flight != NULL && capo->flight_leader == FALSE && singleflight_is_done(capo->flight))
+            {
+                land_flight(dl,capo);
+                delivered = TRUE;
+            }
+            else if(capo->flight != NULL && capo->flight_leader == FALSE && skip_flight(dl,capo))
             {
-                /* Set up fds */
-                FD_ZERO(&ReadFDS);
-                FD_ZERO(&WriteFDS);
-                FD_ZERO(&ErrorFDS);
+                delivered = TRUE;
+            }
+            else if(capo->parsing == TRUE && g_atomic_int_get(&capo->parse_ready) == TRUE)
+            {
+                capo->parsing = FALSE;
+                pass_to_callback(dl,capo);
+                delivered = TRUE;
+            }
+        }
+    }
+}
 
-                if (curl_multi_fdset(cmHandle, &ReadFDS, &WriteFDS, &ErrorFDS, &max_fd) ||
-                        curl_multi_timeout(cmHandle, &wait_time))
-                {
-                    glyr_message(1,s,"Error while selecting stream. Might be a bug.\n");
-                    return NULL;
-                }
+//////////////////////////////////////
 
-                if (wait_time == -1)
-                    wait_time = 100;
+/* Anything left to wait for? */
+static gboolean has_transfers(GList * cb_list)
+{
+    for(GList * elem = cb_list; elem; elem = elem->next)
+    {
+        cb_object * capo = elem->data;
+        if(capo->handle != NULL || capo->flight != NULL || capo->parsing == TRUE || 
+          (capo->cache_hit == TRUE && capo->was_buffered == FALSE))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
 
-                /* Nothing happens.. */
-                if (max_fd == -1)
-                {
-                    g_usleep(wait_time * 100);
-                }
-                else
-                {
-                    struct timeval Tmax;
-                    Tmax.tv_sec  = (wait_time/1000);
-                    Tmax.tv_usec = (wait_time%1000)*1000;
+//////////////////////////////////////
 
-                    /* Now block till something interesting happens with the download */
-                    if (select(max_fd+1, &ReadFDS, &WriteFDS, &ErrorFDS, &Tmax) == -1)
-                    {
-                        glyr_message(1,s,"Error: select(%i <=> %li): %i: %s\n",max_fd+1, wait_time, errno, strerror(errno));
-                        return NULL;
-                    }
-                }
+/* Next transfer that is done, from the engine or our own multihandle.
+ * It's no longer on either of them then */
+static gboolean next_done(AsyncDownload * dl, CURL ** easy_handle, CURLcode * result)
+{
+    if(dl->client != NULL)
+    {
+        return engine_client_next(dl->client,easy_handle,result);
+    }
+
+    gint queue_msg;
+    CURLMsg * msg;
+    while((msg = curl_multi_info_read(dl->cmHandle,&queue_msg)) != NULL)
+    {
+        if(msg->msg == CURLMSG_DONE)
+        {
+            *easy_handle = msg->easy_handle;
+            *result = msg->data.result;
+            curl_multi_remove_handle(dl->cmHandle,*easy_handle);
+            return TRUE;
+        }
+
+        /* Something in the multidownloading gone wrong */
+        glyr_message(1,dl->s,"Error: multiDownload-errorcode: %d\n",msg->msg);
+    }
+    return FALSE;
+}
+
+//////////////////////////////////////
+
+/* Ask for the next provider and start it. Returns it, or NULL if there's none left */
+static MetaDataSource * start_next_provider(AsyncDownload * dl)
+{
+    gchar * url = NULL, * endmark = NULL;
+    MetaDataSource * source = NULL;
+    while(dl->next_provider != NULL)
+    {
+        if(dl->next_provider(dl->userptr,&url,&endmark,&source) == FALSE)
+        {
+            /* Nobody left to ask */
+            dl->next_provider = NULL;
+        }
+        else
+        {
+            cb_object * obj = add_download(dl,url,endmark,source,FALSE);
+            if(obj != NULL)
+            {
+                dl->cb_list = g_list_prepend(dl->cb_list,obj);
+                return source;
             }
+        }
+    }
+    return NULL;
+}
 
+//////////////////////////////////////
 
-            /* select() returned. There might be some fresh flesh! - Check. */
-            CURLMsg * msg;
-            while (GET_ATOMIC_SIGNAL_EXIT(s) == FALSE &&
-                   terminate == FALSE && 
-                   (msg = curl_multi_info_read(cmHandle, &queue_msg)))
+/* Keep GlyrQuery.parallel providers busy, as long as there are items missing:
+ * Start the next one as soon as one is done, instead of waiting for all.
+ * Returns TRUE if something was started */
+static gboolean refill_slots(AsyncDownload * dl)
+{
+    gboolean started = FALSE;
+    while(dl->next_provider != NULL && dl->s->itemctr < dl->s->number && GET_ATOMIC_SIGNAL_EXIT(dl->s) == FALSE)
+    {
+        if(dl->busy_providers >= dl->s->parallel)
+        {
+            break;
+        }
+
+        MetaDataSource * source = start_next_provider(dl);
+        if(source == NULL)
+        {
+            break;
+        }
+
+        glyr_message(2,dl->s,"- Slot free, starting: %s\n",source->name);
+        started = TRUE;
+    }
+    return started;
+}
+
+//////////////////////////////////////
+
+/* Start the next provider for every transfer, that brought no item for too long.
+ * Every provider is hedged at most once */
+static void hedge_stalled(AsyncDownload * dl)
+{
+    if(dl->next_provider == NULL || dl->s->hedge == FALSE)
+    {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    for(GList * elem = dl->cb_list; elem && dl->next_provider && GET_ATOMIC_SIGNAL_EXIT(dl->s) == FALSE; elem = elem->next)
+    {
+        cb_object * capo = elem->data;
+
+        /* Follow-ups count for the first request of their provider */
+        cb_object * origin = capo;
+        while(origin->parent != NULL)
+        {
+            origin = origin->parent;
+        }
+
+        if(capo->source == NULL || capo->handle == NULL || capo->started == 0 || 
+           origin->hedged == TRUE || dl->s->itemctr != capo->started_itemctr)
+        {
+            continue;
+        }
+
+        gint64 threshold_ms = latency_percentile(capo->source,DL_HEDGE_PERCENTILE);
+        if(threshold_ms < 0)
+        {
+            threshold_ms = dl->s->timeout * 1000 / DL_HEDGE_TIMEOUT_DIVISOR;
+        }
+
+        if((now - capo->started) / 1000 >= threshold_ms)
+        {
+            origin->hedged = TRUE;
+
+            MetaDataSource * source = start_next_provider(dl);
+            if(source != NULL)
             {
-                /* That download is ready to be viewed */
-                if(msg->msg == CURLMSG_DONE)
-                {
-                    /* Easy handle of this particular DL */
-                    CURL *easy_handle = msg->easy_handle;
+                glyr_message(2,dl->s,"- Hedging: %s is slow, also asking %s\n",capo->source->name,source->name);
+                stats_add(STATS_HEDGES_STARTED,1);
+            }
+        }
+    }
+}
 
-                    /* Get the callback object associated with the curl handle
-                     * for some odd reason curl requires a char * pointer */
-                    cb_object * capo = NULL;
-                    curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE,(((char**)&capo)));
+//////////////////////////////////////
+/* ----------------- THE HEART OF GOLD ------------------ */
+//////////////////////////////////////
+GList * async_download(GList * url_list, GList * endmark_list, GList * source_list, GlyrQuery * s, long parallel_fac, long timeout_fac, AsyncDLCB asdl_callback, AsyncParseCB parse_callback, AsyncProviderCB provider_callback, void * userptr, gboolean free_caches, gboolean images)
+{
+    /* Storage for result items */
+    GList * item_list = NULL;
 
-                    /* It's useless if it's empty  */
-                    if(capo && capo->cache && capo->cache->data == NULL)
-                    {
-                        capo->consumed = TRUE;
-                        DL_free(capo->cache);
-                        capo->cache = NULL;
-                    }
+    if(url_list != NULL && s != NULL)
+    {
+        /* total timeout and parallel tries */
+        long abs_timeout  = ABS(timeout_fac  * s->timeout);
+        long abs_parallel = ABS(parallel_fac * s->parallel);
+
+        /* Curl Multi Handles (~ container for easy handlers) */
+        CURLM   * cmHandle = curl_multi_init();
+        connpool_setup_multi(cmHandle,abs_parallel);
+        curl_multi_setopt(cmHandle, CURLMOPT_PIPELINING, 1L);
 
-                    /* Mark this cb_object as  */
-                    capo->was_buffered = TRUE;
+        /* Tell us when a socket gets interesting */
+        EventLoop * loop = eventloop_new(cmHandle);
+        if(loop == NULL)
+        {
+            glyr_message(1,s,"Error: Unable to create eventloop: %s\n",strerror(errno));
+            curl_multi_cleanup(cmHandle);
+            return NULL;
+        }
 
-                    /* capo contains now the downloaded cache, ready to parse */
-                    if(msg->data.result == CURLE_OK && capo && capo->cache)
-                    {
-                        /* How many items from the callback will actually be added */
-                        gint to_add = 0;
+        AsyncDownload dl = {
+            .s = s,
+            .cmHandle = cmHandle,
+            .loop = loop,
+            .abs_timeout = abs_timeout,
+            .client = engine_client_new(s->engine,loop),
+            .callback = asdl_callback,
+            .parse_callback = parse_callback,
+            .next_provider = provider_callback,
+            .userptr = userptr,
+            .item_list = NULL,
+            .terminate = FALSE,
+            .retry_us = -1,
+            .busy_providers = 0
+        };
 
-                        /* Stop download after this came in */
-                        bool stop_download = false;
-                        GList * cb_results = NULL;
+        /* Now create cb_objects */
+        dl.cb_list = init_async_download(&dl,url_list,endmark_list,source_list,images);
 
-                        /* Set origin */
-                        if(capo->cache->dsrc != NULL)
-                        {
-                            g_free(capo->cache->dsrc);
-                        }
-                        capo->cache->dsrc = g_strdup(capo->url);
+        while(GET_ATOMIC_SIGNAL_EXIT(s) == FALSE && dl.terminate == FALSE)
+        {
+            /* Out of time; what was delivered so far has to do */
+            if(deadline_passed(s) == TRUE)
+            {
+                glyr_message(3,s,"- Deadline passed, cancelling the remaining downloads\n");
+                break;
+            }
 
-                        /* Call it if present */
-                        if(asdl_callback != NULL)
-                        {
-                            /* Add parsed results or nothing if parsed result is empty */
-                            cb_results = asdl_callback(capo,userptr,&stop_download,&to_add);
-                        }
+            /* No need to wait for those */
+            deliver_ready(&dl);
 
-                        if(cb_results != NULL)
-                        {
-                            /* Fill in the source filed (dsrc) if not already done */
-                            for(GList * elem = cb_results; elem; elem = elem->next)
-                            {
-                                GlyrMemCache * item = elem->data;
-                                if(item && item->dsrc == NULL)
-                                {
-                                    /* Plugin didn't do any special download */
-                                    item->dsrc = g_strdup(capo->url);
-                                }
-                                item_list = g_list_prepend(item_list,item);
-                            }
-                            g_list_free(cb_results);
-                        }
-                        else if(to_add != 0)
-                        {
-                            /* Add it as raw data */
-                            item_list = g_list_prepend(item_list,capo->cache);
-                        }
-                        else
-                        {
-                            capo->consumed = TRUE;
-                            DL_free(capo->cache);
-                            capo->cache = NULL;
-                        }
+            /* Providers that are done make room for the next ones;
+             * deliver what those might have brought from the HTTP cache right away */
+            if(dl.terminate == FALSE && refill_slots(&dl) == TRUE)
+            {
+                continue;
+            }
 
-                        /* So, shall we stop? */
-                        terminate = stop_download;
+            if(dl.terminate == TRUE || has_transfers(dl.cb_list) == FALSE)
+            {
+                break;
+            }
 
-                    }
-                    else
-                    {
-                        /* Something in this download was wrong. Tell us what. */
-                        char * errstring = (char*)curl_easy_strerror(msg->data.result);
-                        glyr_message(3,capo->s,"- glyr: Downloaderror: %s [errno:%d]\n",
-                                errstring ? errstring : "Unknown Error",
-                                msg->data.result);
-
-                        glyr_message(3,capo->s,"  On URL: ");
-                        glyr_message(3,capo->s,"%s\n",capo->url);
-
-                        DL_free(capo->cache);
-                        capo->cache = NULL;
-                        capo->consumed = TRUE;
-                    }
+            /* Maybe some host allows more transfers by now */
+            start_queued(&dl);
+            expire_queued(&dl);
 
-                    /* We're done with this one.. bybebye */
-                    curl_multi_remove_handle(cmHandle,easy_handle);
-                    curl_easy_cleanup(easy_handle);
-                    capo->handle = NULL;
-                }
-                else
+            /* Don't wait too long for slow providers, if wished */
+            hedge_stalled(&dl);
+
+            /* Now block till something interesting happens with the download,
+             * or the next queued transfer may start */
+            glong max_wait_ms = DL_MAX_WAIT_MS;
+            if(dl.retry_us >= 0)
+            {
+                max_wait_ms = CLAMP(dl.retry_us / 1000 + 1,1,DL_MAX_WAIT_MS);
+            }
+            max_wait_ms = deadline_clamp_ms(s,max_wait_ms);
+
+            CURLMcode loop_rc = eventloop_run_once(loop,max_wait_ms,NULL);
+            if(loop_rc != CURLM_OK)
+            {
+                glyr_message(1,s,"Error: curl_multi_socket_action() failed: %i: %s\n",loop_rc,curl_multi_strerror(loop_rc));
+                break;
+            }
+
+            /* Something happened. There might be some fresh flesh! - Check. */
+            CURL * easy_handle = NULL;
+            CURLcode result = CURLE_OK;
+            while (GET_ATOMIC_SIGNAL_EXIT(s) == FALSE &&
+                   dl.terminate == FALSE && 
+                   next_done(&dl,&easy_handle,&result) == TRUE)
+            {
+                /* Get the callback object associated with the curl handle
+                 * for some odd reason curl requires a char * pointer */
+                cb_object * capo = NULL;
+                curl_easy_getinfo(easy_handle, CURLINFO_PRIVATE,(((char**)&capo)));
+
+                if(capo != NULL)
                 {
-                    /* Something in the multidownloading gone wrong */
-                    glyr_message(1,s,"Error: multiDownload-errorcode: %d\n",msg->msg);
+                    release_slot(capo);
+                    record_transfer(capo,result);
+                    trace_transfer(s,easy_handle,(capo->source) ? capo->source->name : NULL,capo->started);
+                    finish_download(&dl,capo,result);
+                    capo->handle = NULL;
+                    update_provider_busy(&dl,capo);
                 }
+
+                /* We're done with this one.. bybebye */
+                curl_easy_cleanup(easy_handle);
             }
         }
-        destroy_async_download(cb_list,cmHandle,free_caches);
+        /* Nobody may touch cb_list anymore */
+        cancel_transfers(&dl);
+        stop_parsing(&dl);
+
+        stats_add(STATS_EVENTLOOP_WAKEUPS,eventloop_get_wakeups(loop));
+        glyr_message(4,s,"- Eventloop: %d wakeups for %d urls\n",eventloop_get_wakeups(loop),g_list_length(dl.cb_list));
+        destroy_async_download(dl.cb_list,cmHandle,loop,free_caches);
+        item_list = dl.item_list;
     }
     return item_list;
 }
 
 //////////////////////////////////////
 
-struct wrap_retrieve_pass_data
-{
-    gchar * url;
-    GlyrQuery * query;
-};
+/* Max. number of content type checks running at the same time */
+#define PROBE_MAX_PARALLEL 8
+
+//////////////////////////////////////
 
-static void * wrap_retrieve_content(gpointer data)
+static gboolean finish_content_probe(struct content_probe * probe, CURLcode rc, GlyrQuery * s)
 {
-    struct header_data * head = NULL;
-    if(data != NULL)
+    gboolean success = FALSE;
+
+    /* The write error is us, stopping after the headers */
+    if(rc == CURLE_OK || (rc == CURLE_WRITE_ERROR && probe->info.type != NULL))
     {
-        struct wrap_retrieve_pass_data * passed = data;
-        GlyrQuery * query = passed->query;
-        head = retrieve_content_info(passed->url,(gchar*)query->proxy,(gchar*)query->useragent,query);
-        g_free(passed);
-        passed = NULL;
+        /* Remove trailing newlines,carriage returns */
+        chomp_breakline(probe->info.type);
+        chomp_breakline(probe->info.format);
+        chomp_breakline(probe->info.extra);
+
+        if(g_strcmp0(probe->info.type,"image") == 0)
+        {
+            probe->item->img_format = g_strdup(probe->info.format);
+            success = TRUE;
+        }
+    }
+    else if(GET_ATOMIC_SIGNAL_EXIT(s) == FALSE)
+    {
+        glyr_message(1,s,"- DLError: %s [%d]\n",curl_easy_strerror(rc),rc);
     }
-    return head;
+
+    g_free(probe->info.format);
+    g_free(probe->info.type);
+    g_free(probe->info.extra);
+    return success;
 }
 
 //////////////////////////////////////
 
+/* Check the content type of all items in cache_list (which are URLs).
+ * All checks run on one multihandle, at most PROBE_MAX_PARALLEL at once */
 static void check_all_types_in_url_list(GList * cache_list, GlyrQuery * s)
 {
-    if(cache_list != NULL)
+    if(cache_list == NULL)
+        return;
+
+    CURLM * multi = curl_multi_init();
+    connpool_setup_multi(multi,PROBE_MAX_PARALLEL);
+    EventLoop * loop = eventloop_new(multi);
+    if(loop == NULL)
     {
-        GHashTable * thread_id_table = g_hash_table_new(g_direct_hash,g_direct_equal);
-        GList * thread_list = NULL;
+        curl_multi_cleanup(multi);
+        return;
+    }
 
-        glyr_message(2,s,"#[%02d/%02d] Checking image-types: [",s->itemctr,s->number);
+    glyr_message(2,s,"#[%02d/%02d] Checking image-types: [",s->itemctr,s->number);
 
-        for(GList * elem = cache_list; elem; elem = elem->next)
+    gchar * link_user_agent = g_strdup_printf("%s / linkvalidator",s->useragent);
+    GList * pending = cache_list;
+    GList * running = NULL;
+    gint running_handles = -1;
+
+    while(GET_ATOMIC_SIGNAL_EXIT(s) == FALSE && deadline_passed(s) == FALSE && (pending != NULL || running != NULL))
+    {
+        /* Fill up free slots */
+        while(pending != NULL && g_list_length(running) < PROBE_MAX_PARALLEL)
         {
-            GlyrMemCache * item = elem->data;
-            if(item != NULL)
+            GlyrMemCache * item = pending->data;
+            pending = pending->next;
+
+            if(item != NULL && item->data != NULL)
             {
-                struct wrap_retrieve_pass_data * passer = g_malloc0(sizeof(struct wrap_retrieve_pass_data));
-                passer->url   = item->data;
-                passer->query = s;
+                struct content_probe * probe = g_malloc0(sizeof(struct content_probe));
+                probe->item = item;
 
-                GThread * thread = g_thread_create((GThreadFunc)wrap_retrieve_content,passer,true,NULL);
-                if(thread != NULL)
+                if(init_content_probe(probe,s,link_user_agent) != NULL)
                 {
-                    thread_list = g_list_prepend(thread_list,thread);
+                    curl_multi_add_handle(multi,probe->handle);
+                    running = g_list_prepend(running,probe);
+                }
+                else
+                {
+                    g_free(probe);
                 }
-                g_hash_table_insert(thread_id_table,thread,item);
             }
         }
 
-        for(GList * thread = thread_list; thread; thread = thread->next)
+        CURLMcode loop_rc = eventloop_run_once(loop,deadline_clamp_ms(s,DL_MAX_WAIT_MS),&running_handles);
+        if(loop_rc != CURLM_OK)
+        {
+            glyr_message(1,s,"Error: curl_multi_socket_action() failed: %i: %s\n",loop_rc,curl_multi_strerror(loop_rc));
+            break;
+        }
+
+        CURLMsg * msg;
+        gint queue_msg;
+        while((msg = curl_multi_info_read(multi, &queue_msg)))
         {
-            gboolean success = FALSE;
-            struct header_data * info = g_thread_join(thread->data);
-            if(info != NULL)
+            if(msg->msg == CURLMSG_DONE)
             {
-                GlyrMemCache * linked_cache = g_hash_table_lookup(thread_id_table,thread->data);
-                if(linked_cache != NULL)
-                {
-                    if(g_strcmp0(info->type,"image") == 0)
-                    {
-                        linked_cache->img_format = g_strdup(info->format);
-                        success = TRUE;
-                    }
-                }
-                else
-                {
-                    glyr_message(1,s,"glyr: Uh oh.. empty link in hashtable..\n");
-                }
-                g_free(info->format);
-                g_free(info->type);
-                g_free(info->extra);
-                g_free(info);
-            }
+                struct content_probe * probe = NULL;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE,(char**)&probe);
 
-            glyr_message(2,s,"%c",(success) ? '.' : '!');
+                gboolean success = finish_content_probe(probe,msg->data.result,s);
+                glyr_message(2,s,"%c",(success) ? '.' : '!');
+
+                curl_multi_remove_handle(multi,msg->easy_handle);
+                curl_easy_cleanup(msg->easy_handle);
+                running = g_list_remove(running,probe);
+                g_free(probe);
+            }
         }
-        g_list_free(thread_list);
-        g_hash_table_destroy(thread_id_table);
-        glyr_message(2,s,"]");
     }
+
+    /* Stopped early? Cleanup the rest */
+    for(GList * elem = running; elem; elem = elem->next)
+    {
+        struct content_probe * probe = elem->data;
+        curl_multi_remove_handle(multi,probe->handle);
+        curl_easy_cleanup(probe->handle);
+        finish_content_probe(probe,CURLE_ABORTED_BY_CALLBACK,s);
+        g_free(probe);
+    }
+    g_list_free(running);
+
+    curl_multi_cleanup(multi);
+    eventloop_destroy(loop);
+    g_free(link_user_agent);
+
+    glyr_message(2,s,"]");
 }
 
 //////////////////////////////////////
@@ -1266,87 +2531,186 @@ static void fix_data_types(GList * list, MetaDataSource * src, GlyrQuery * query
 //////////////////////////////////////
 
 /* The actual call to the metadata provider here, coming from the downloader, triggered by start_engine() */
+/* What execute_query() passes to async_download() as userptr */
+typedef struct {
+    GlyrQuery * query;
+    MetaDataFetcher * fetcher;
+    gint * fired;
+
+    /* URL => MetaDataSource */
+    GHashTable * url_table;
+
+    /* URLs of providers fired while downloading, freed along with the others */
+    GList * fired_urls;
+} ProviderTable;
+
+//////////////////////////////////////
+
+/* The CPU-heavy part of call_provider_callback(): Parse and clean up.
+ * Runs in a parser thread of async_download(), so it may only read the query */
+static GList * parse_provider_results(cb_object * capo, void * userptr)
+{
+    /* Follow-ups belong to the source of the first request;
+     * url_table is not asked, fire_next_provider() changes it meanwhile */
+    cb_object * origin = capo;
+    while(origin->parent != NULL)
+    {
+        origin = origin->parent;
+    }
+
+    MetaDataSource * plugin = origin->source;
+    if(plugin == NULL)
+    {
+        return NULL;
+    }
+
+    /* Call the provider's parser, or the continuation it left us */
+    GList * raw_parsed_data = NULL;
+    gint64 parse_started = g_get_monotonic_time();
+    trace_fuzzy_start(capo->s);
+    if(capo->continuation != NULL)
+    {
+        raw_parsed_data = capo->continuation(capo,capo->cont_userdata);
+    }
+    else
+    {
+        raw_parsed_data = plugin->parser(capo);
+    }
+
+    gint64 fuzzy_spent = trace_fuzzy_stop();
+    trace_span(capo->s,GLYR_TRACE_PARSE,plugin->name,NULL,parse_started,g_get_monotonic_time(),g_list_length(raw_parsed_data));
+    if(fuzzy_spent > 0)
+    {
+        trace_span(capo->s,GLYR_TRACE_FUZZY,plugin->name,NULL,parse_started,parse_started + fuzzy_spent,-1);
+    }
+
+    /* Set the default type if not known otherwise */
+    fix_data_types(raw_parsed_data,plugin,capo->s);
+
+    /* Also do some duplicate check already */
+    gsize less = delete_dupes(raw_parsed_data,capo->s);
+    if(less > 0)
+    {
+        gsize items_now = g_list_length(raw_parsed_data) + g_atomic_int_get(&capo->s->itemctr) - less;
+        glyr_message(2,capo->s,"#[%02d/%02d] Inner check found %ld dupes\n",items_now,capo->s->number,less);
+        metrics_add(plugin,METRICS_REJECTED_DUPES,less);
+    }
+
+    /* Any items left to kill? */
+    if(g_list_length(raw_parsed_data) != 0)
+    {
+        /* We shouldn't check (e.g) lyrics if they are a valid URL ;-) */
+        if(capo->s->imagejob == TRUE)
+        {
+            /* Otherwise the format is checked on the download itself */
+            if(capo->s->sniff_formats == FALSE || capo->s->download == FALSE)
+            {
+                gint64 probe_started = g_get_monotonic_time();
+                gint before = g_list_length(raw_parsed_data);
+                raw_parsed_data = kick_out_wrong_formats(raw_parsed_data,capo->s);
+                metrics_add(plugin,METRICS_REJECTED_FORMAT,before - g_list_length(raw_parsed_data));
+                trace_span(capo->s,GLYR_TRACE_PROBE,plugin->name,NULL,probe_started,g_get_monotonic_time(),g_list_length(raw_parsed_data));
+            }
+        }
+        else /* We should look if charset conversion is requested */
+        {
+            normalize_utf8(raw_parsed_data);
+            if(plugin->encoding != NULL)
+            {
+                glyr_message(2,capo->s,"#[%02d/%02d] Attempting to convert charsets\n",g_list_length(raw_parsed_data),capo->s->number);
+                do_charset_conversion(plugin, raw_parsed_data);
+            }
+            gint before = g_list_length(raw_parsed_data);
+            raw_parsed_data = check_for_forced_utf8(capo->s,raw_parsed_data);
+            metrics_add(plugin,METRICS_REJECTED_UTF8,before - g_list_length(raw_parsed_data));
+        }
+    }
+    return raw_parsed_data;
+}
+
+//////////////////////////////////////
+
 static GList * call_provider_callback(cb_object * capo, void * userptr, bool * stop_download, gint * to_add)
 {
     GList * parsed = NULL;
     if(userptr != NULL)
     {
+        /* Follow-ups belong to the source of the first request */
+        cb_object * origin = capo;
+        while(origin->parent != NULL)
+        {
+            origin = origin->parent;
+        }
+
         /* Get MetaDataSource correlated to this URL */
-        GHashTable * assoc = (GHashTable*)userptr;
-        MetaDataSource * plugin = g_hash_table_lookup(assoc,capo->url);
+        ProviderTable * table = userptr;
+        MetaDataSource * plugin = g_hash_table_lookup(table->url_table,origin->url);
 
         if(plugin != NULL)
         {
             if(capo->s->itemctr < capo->s->number)
             {
-                /* Call the provider's parser */
-                GList * raw_parsed_data = plugin->parser(capo);
-
-                /* Set the default type if not known otherwise */
-                fix_data_types(raw_parsed_data,plugin,capo->s);
+                /* Parsed in the background already? */
+                GList * raw_parsed_data = capo->parsed;
+                capo->parsed = NULL;
 
-                /* Also do some duplicate check already */
-                gsize less = delete_dupes(raw_parsed_data,capo->s);
-                if(less > 0)
+                if(g_atomic_int_get(&capo->parse_ready) == FALSE)
                 {
-                    gsize items_now = g_list_length(raw_parsed_data) + capo->s->itemctr - less;
-                    glyr_message(2,capo->s,"#[%02d/%02d] Inner check found %ld dupes\n",items_now,capo->s->number,less);
+                    raw_parsed_data = parse_provider_results(capo,userptr);
                 }
 
                 /* Look up if items already in cache */
-                less = delete_already_cached_items(capo,&raw_parsed_data);
+                gint64 lookup_started = g_get_monotonic_time();
+                gsize less = delete_already_cached_items(capo,&raw_parsed_data);
+                if(capo->s->local_db != NULL && capo->s->db_autoread == TRUE)
+                {
+                    trace_span(capo->s,GLYR_TRACE_DB_LOOKUP,plugin->name,NULL,lookup_started,g_get_monotonic_time(),g_list_length(raw_parsed_data));
+                }
                 if(less > 0)
                 {
                     gsize items_now = g_list_length(raw_parsed_data) + capo->s->itemctr - less;
                     glyr_message(2,capo->s,"#[%02d/%02d] DB lookup found %ld dupes\n",items_now,capo->s->number,less);
+                    metrics_add(plugin,METRICS_REJECTED_CACHED,less);
                 }
 
                 /* Any items left to kill? */
                 if(g_list_length(raw_parsed_data) != 0)
                 {
-                    /* We shouldn't check (e.g) lyrics if they are a valid URL ;-) */
-                    if(capo->s->imagejob == TRUE)
+                    gint accepted = 0;
+                    for(GList * elem = raw_parsed_data; elem; elem = elem->next)
                     {
-                        raw_parsed_data = kick_out_wrong_formats(raw_parsed_data,capo->s);
-                    }
-                    else /* We should look if charset conversion is requested */
-                    {
-                        normalize_utf8(raw_parsed_data);
-                        if(plugin->encoding != NULL)
-                        {
-                            glyr_message(2,capo->s,"#[%02d/%02d] Attempting to convert charsets\n",g_list_length(raw_parsed_data),capo->s->number);
-                            do_charset_conversion(plugin, raw_parsed_data);
-                        }
-                        raw_parsed_data = check_for_forced_utf8(capo->s,raw_parsed_data);
-                    }
-
-                    if(g_list_length(raw_parsed_data) != 0)
-                    {
-                        for(GList * elem = raw_parsed_data; elem; elem = elem->next)
+                        GlyrMemCache * item = elem->data;
+                        if(item != NULL)
                         {
-                            GlyrMemCache * item = elem->data;
-                            if(item != NULL)
+                            if(capo->s->itemctr < capo->s->number)
                             {
-                                if(capo->s->itemctr < capo->s->number)
-                                {
-                                    /* Only reference to the plugin -> copy providername */
-                                    item->prov = g_strdup(plugin->name);
-                                    parsed = g_list_prepend(parsed,item);
-                                    capo->s->itemctr++;
-                                }
-                                else /* Not needed anymore. Forget this item */
-                                {
-                                    DL_free(item);
-                                    item = NULL;
+                                /* Only reference to the plugin -> copy providername */
+                                item->prov = g_strdup(plugin->name);
+                                parsed = g_list_prepend(parsed,item);
+                                g_atomic_int_inc(&capo->s->itemctr);
+                                accepted++;
+                            }
+                            else /* Not needed anymore. Forget this item */
+                            {
+                                DL_free(item);
+                                item = NULL;
 
-                                    /* Also skip other downloads */
-                                    *stop_download = TRUE;
-                                }
+                                /* Also skip other downloads */
+                                *stop_download = TRUE;
                             }
                         }
+                    }
 
-                        /* Forget those pointers */
-                        g_list_free(raw_parsed_data);
+                    /* Forget those pointers */
+                    g_list_free(raw_parsed_data);
+                    ranking_record_items(plugin,accepted);
+                    metrics_add(plugin,METRICS_ACCEPTED,accepted);
+
+                    /* Enough - cancel everything else still running, 
+                     * including the providers we hedged with, or that we hedged against */
+                    if(capo->s->itemctr >= capo->s->number)
+                    {
+                        *stop_download = TRUE;
                     }
                 }
             }
@@ -1357,6 +2721,14 @@ static GList * call_provider_callback(cb_object * capo, void * userptr, bool * s
         }
 
     }
+    /* Parsed in vain */
+    for(GList * elem = capo->parsed; elem; elem = elem->next)
+    {
+        DL_free(elem->data);
+    }
+    g_list_free(capo->parsed);
+    capo->parsed = NULL;
+
     /* We replace the cache with a new one -> free the old one */
     if(capo->cache != NULL)
     {
@@ -1375,6 +2747,108 @@ static GList * call_provider_callback(cb_object * capo, void * userptr, bool * s
 
 //////////////////////////////////////
 
+/* Does the splitted --from string select f? */
+static gboolean from_selects_provider(GList * tokens, MetaDataSource * f)
+{
+    /* You need to take a little break to read this through at once */
+    gboolean is_found    = FALSE;
+    gboolean is_excluded = FALSE;
+    gboolean all_occured = FALSE;
+
+    if(f->name != NULL)
+    {
+        gsize name_len = strlen(f->name);
+        for(GList * elem = tokens; elem; elem = elem->next)
+        {
+            gchar * token = elem->data;
+            gsize token_len = strlen(token);
+
+            gboolean minus;
+            if((minus = token[0] == '-') || token[0] == '+')
+                token++;
+
+            if(!g_ascii_strncasecmp(token,"all",token_len))
+                all_occured = TRUE;
+
+            if((token[0] == f->key && token_len == 1) || !g_ascii_strncasecmp(token,f->name,name_len))
+            {
+                is_excluded =  minus;
+                is_found    = !minus;
+            }
+        }
+    }
+    return (all_occured) ? (is_excluded == FALSE) : is_found;
+}
+
+//////////////////////////////////////
+
+/* from split at GLYR_DEFAULT_FROM_ARGUMENT_DELIM; free with glist_free_full() */
+static GList * from_tokenize(const gchar * from)
+{
+    GList * tokens = NULL;
+    gsize len = strlen(from);
+    gsize offset = 0;
+
+    gchar * token = NULL;
+    while((token = get_next_word(from,GLYR_DEFAULT_FROM_ARGUMENT_DELIM,&offset,len)))
+    {
+        tokens = g_list_prepend(tokens,token);
+    }
+
+    /* Later tokens win */
+    return g_list_reverse(tokens);
+}
+
+//////////////////////////////////////
+
+/* Split from only once, instead of on every provider_is_enabled() */
+ProviderMask * provider_mask_compile(const gchar * from)
+{
+    GList * sources = r_getSList();
+    gsize providers = g_list_length(sources);
+
+    ProviderMask * mask = g_malloc0(sizeof(ProviderMask) + (providers / 32 + 1) * sizeof(guint32));
+    mask->providers = providers;
+    mask->from = from;
+
+    if(from != NULL)
+    {
+        GList * tokens = from_tokenize(from);
+        for(GList * elem = sources; elem; elem = elem->next)
+        {
+            MetaDataSource * src = elem->data;
+            if(src != NULL && from_selects_provider(tokens,src) == TRUE)
+            {
+                mask->bits[src->id / 32] |= 1u << (src->id % 32);
+            }
+        }
+        glist_free_full(tokens,g_free);
+    }
+    return mask;
+}
+
+//////////////////////////////////////
+
+/* Is q->from_mask compiled from q->from, with all providers registered by now? */
+static gboolean provider_mask_is_current(GlyrQuery * q)
+{
+    ProviderMask * mask = q->from_mask;
+    return mask != NULL && mask->from == q->from && mask->providers == g_list_length(r_getSList());
+}
+
+//////////////////////////////////////
+
+void provider_mask_update(GlyrQuery * q)
+{
+    if(q != NULL && provider_mask_is_current(q) == FALSE)
+    {
+        g_free(q->from_mask);
+        q->from_mask = provider_mask_compile(q->from);
+    }
+}
+
+//////////////////////////////////////
+
 gboolean provider_is_enabled(GlyrQuery * q, MetaDataSource * f)
 {
     if(q->lang_aware_only &&
@@ -1391,43 +2865,18 @@ gboolean provider_is_enabled(GlyrQuery * q, MetaDataSource * f)
         return TRUE;
     }
 
-    /* You need to take a little break to read this through at once */
-    gboolean is_found    = FALSE;
-    gboolean is_excluded = FALSE;
-    gboolean all_occured = FALSE;
-
-    /* split string */
-    if(f->name != NULL)
+    /* Only read here, this might run in several threads at once */
+    ProviderMask * mask = q->from_mask;
+    if(mask != NULL && mask->from == q->from && (gsize)f->id < mask->providers)
     {
-        gsize name_len = strlen(f->name);
-        gsize len = strlen(q->from);
-        gsize offset = 0;
-
-        gchar * token = NULL;
-        while((token = get_next_word(q->from,GLYR_DEFAULT_FROM_ARGUMENT_DELIM,&offset,len)))
-        {
-            if(token != NULL)
-            {
-                gsize token_len = strlen(token);
-                gchar * back = token;
-
-                gboolean minus;
-                if((minus = token[0] == '-') || token[0] == '+')
-                    token++;
-
-                if(!g_ascii_strncasecmp(token,"all",token_len))
-                    all_occured = TRUE;
-
-                if((token[0] == f->key && token_len == 1) || !g_ascii_strncasecmp(token,f->name,name_len))
-                {
-                    is_excluded =  minus;
-                    is_found    = !minus;
-                }
-                g_free(back);
-            }
-        }
+        return (mask->bits[f->id / 32] & (1u << (f->id % 32))) != 0;
     }
-    return (all_occured) ? (is_excluded == FALSE) : is_found;
+
+    /* GlyrQuery.from was set directly, without glyr_opt_from(): do it the slow way */
+    GList * tokens = from_tokenize(q->from);
+    gboolean selected = from_selects_provider(tokens,f);
+    glist_free_full(tokens,g_free);
+    return selected;
 }
 
 //////////////////////////////////////
@@ -1441,41 +2890,64 @@ static gfloat calc_rating(gfloat qsratio, gint quality, gint speed)
 
 //////////////////////////////////////
 
-static GList * get_queued(GlyrQuery * s, MetaDataFetcher * fetcher, gint * fired)
+/* The best rated provider that was not fired yet, and mark it as fired. 
+ * Its position in fetcher->provider is stored in *fired_pos */
+static MetaDataSource * get_next_provider(GlyrQuery * s, MetaDataFetcher * fetcher, gint * fired, gint * fired_pos)
 {
-    GList * source_list = NULL;
-    for(gint it = 0; it < s->parallel; it++)
-    {
-        gint pos = 0;
-        gint max_pos = -1;
-        gfloat max = G_MINFLOAT;
+    gint pos = 0;
+    gint max_pos = -1;
+    gfloat max = G_MINFLOAT;
+    MetaDataSource * next = NULL;
 
-        for(GList * elem = fetcher->provider; elem; elem = elem->next, ++pos)
+    for(GList * elem = fetcher->provider; elem; elem = elem->next, ++pos)
+    {
+        MetaDataSource * src = elem->data;
+        if(provider_is_enabled(s,src) == TRUE)
         {
-            MetaDataSource * src = elem->data;
-            if(provider_is_enabled(s,src) == TRUE)
+            if(fired[pos] == 0)
             {
-                if(fired[pos] == 0)
+                /* Builtin values, corrected by what we saw of the provider */
+                gint quality = src->quality, speed = src->speed;
+                ranking_adjust(src,&quality,&speed);
+
+                gfloat rating = calc_rating(s->qsratio,quality,speed);
+                if(rating > max)
                 {
-                    gfloat rating = calc_rating(s->qsratio,src->quality,src->speed);
-                    if(rating > max)
-                    {
-                        max = rating;
-                        max_pos = pos;
-                    }
+                    max = rating;
+                    max_pos = pos;
                 }
             }
         }
+    }
 
-        if(max_pos != -1)
+    if(max_pos != -1)
+    {
+        GList * wanted = g_list_nth(fetcher->provider,max_pos);
+        if(wanted != NULL)
         {
-            GList * wanted = g_list_nth(fetcher->provider,max_pos);
-            if(wanted != NULL)
-            {
-                MetaDataSource * src = wanted->data;
-                source_list = g_list_prepend(source_list,src);
-            }
-            fired[max_pos]++;
+            next = wanted->data;
+        }
+        fired[max_pos]++;
+    }
+
+    if(fired_pos != NULL)
+    {
+        *fired_pos = max_pos;
+    }
+    return next;
+}
+
+//////////////////////////////////////
+
+static GList * get_queued(GlyrQuery * s, MetaDataFetcher * fetcher, gint * fired)
+{
+    GList * source_list = NULL;
+    for(gint it = 0; it < s->parallel; it++)
+    {
+        MetaDataSource * src = get_next_provider(s,fetcher,fired,NULL);
+        if(src != NULL)
+        {
+            source_list = g_list_prepend(source_list,src);
         }
     }
 
@@ -1488,6 +2960,26 @@ static GList * get_queued(GlyrQuery * s, MetaDataFetcher * fetcher, gint * fired
 
 //////////////////////////////////////
 
+/* Fire all providers of fetcher in the batches get_queued() makes, without downloading anything.
+ * Returns how many were fired; for glyr_testing_queue_providers() */
+gint queue_all_providers(GlyrQuery * s, MetaDataFetcher * fetcher)
+{
+    gint list_len = g_list_length(fetcher->provider);
+    gint fired[list_len + 1];
+    memset(fired,0,(list_len + 1) * sizeof(gint));
+
+    gint fired_total = 0;
+    GList * batch = NULL;
+    while((batch = get_queued(s,fetcher,fired)) != NULL)
+    {
+        fired_total += g_list_length(batch);
+        g_list_free(batch);
+    }
+    return fired_total;
+}
+
+//////////////////////////////////////
+
 gboolean is_in_result_list(GlyrMemCache * cache, GList * result_list)
 {
     gboolean result = FALSE;
@@ -1507,10 +2999,84 @@ gboolean is_in_result_list(GlyrMemCache * cache, GList * result_list)
 
 //////////////////////////////////////
 
-static void execute_query(GlyrQuery * query, MetaDataFetcher * fetcher, GList * source_list, gboolean * stop_me, GList ** result_list)
+/* The URL to download for item, NULL if there's none.
+ * *offline is set if it generates its content itself */
+static gchar * get_provider_url(GlyrQuery * query, MetaDataSource * item, gboolean * offline)
+{
+    gchar * prepared = NULL;
+    *offline = FALSE;
+
+    /* get the url of this MetaDataSource */
+    const gchar * lookup_url = item->get_url(query);
+    if(lookup_url != NULL)
+    {
+        if(g_ascii_strncasecmp(lookup_url,OFFLINE_PROVIDER,(sizeof OFFLINE_PROVIDER) - 1) != 0)
+        {
+            /* make a sane URL out of it */
+            prepared = prepare_url(lookup_url,query,TRUE);
+
+            /* If the URL was dyn. allocated, we should go and free it */
+            if(item->free_url == TRUE)
+            {
+                g_free((gchar*)lookup_url);
+            }
+        }
+        else
+        {
+            /* This providers offers some autogenerated content */
+            *offline = TRUE;
+        }
+    }
+    return prepared;
+}
+
+//////////////////////////////////////
+
+/* AsyncProviderCB: Fire the next best provider that downloads something */
+static gboolean fire_next_provider(void * userptr, gchar ** url, gchar ** endmark, MetaDataSource ** source)
+{
+    ProviderTable * table = userptr;
+    GList * skipped = NULL;
+    gboolean found = FALSE;
+
+    MetaDataSource * next = NULL;
+    gint fired_pos = -1;
+    while(found == FALSE && (next = get_next_provider(table->query,table->fetcher,table->fired,&fired_pos)) != NULL)
+    {
+        gboolean offline = FALSE;
+        gchar * prepared = get_provider_url(table->query,next,&offline);
+        if(prepared != NULL)
+        {
+            g_hash_table_insert(table->url_table,(gpointer)STRIP_KNOWN_PAGE_MARK(prepared),next);
+            table->fired_urls = g_list_prepend(table->fired_urls,prepared);
+
+            *url = prepared;
+            *endmark = next->endmarker;
+            *source = next;
+            found = TRUE;
+        }
+        else if(offline == TRUE)
+        {
+            /* Those are run by execute_query() itself; let them run with the next batch */
+            skipped = g_list_prepend(skipped,GINT_TO_POINTER(fired_pos));
+        }
+    }
+
+    for(GList * elem = skipped; elem; elem = elem->next)
+    {
+        table->fired[GPOINTER_TO_INT(elem->data)]--;
+    }
+    g_list_free(skipped);
+    return found;
+}
+
+//////////////////////////////////////
+
+static void execute_query(GlyrQuery * query, MetaDataFetcher * fetcher, GList * source_list, gint * fired, gboolean * stop_me, GList ** result_list)
 {
     GList * url_list = NULL;
     GList * endmarks = NULL;
+    GList * sources = NULL;
     GList * offline_provider = NULL;
     GHashTable * url_table = g_hash_table_new(g_str_hash,g_str_equal);
 
@@ -1520,37 +3086,31 @@ static void execute_query(GlyrQuery * query, MetaDataFetcher * fetcher, GList *
         MetaDataSource * item = source->data;
         if(item != NULL)
         {
-            /* get the url of this MetaDataSource */
-            const gchar * lookup_url = item->get_url(query);
-
-            /* Add this to the list */
-            if(lookup_url != NULL)
+            gboolean offline = FALSE;
+            gchar * prepared = get_provider_url(query,item,&offline);
+            if(prepared != NULL)
             {
-                if(g_ascii_strncasecmp(lookup_url,OFFLINE_PROVIDER,(sizeof OFFLINE_PROVIDER) - 1) != 0)
-                {
-                    /* make a sane URL out of it */
-                    const gchar * prepared = prepare_url(lookup_url,query,TRUE);
-
-                    /* add it to the hash table and relate it to the MetaDataSource */
-                    g_hash_table_insert(url_table,(gpointer)prepared,(gpointer)item);
-                    url_list = g_list_prepend(url_list,(gpointer)prepared);
-                    endmarks = g_list_prepend(endmarks,(gpointer)item->endmarker);
-
-                    /* If the URL was dyn. allocated, we should go and free it */
-                    if(item->free_url == TRUE)
-                    {
-                        g_free((gchar*)lookup_url);
-                    }
-                }
-                else
-                {
-                    /* This providers offers some autogenerated content */
-                    offline_provider = g_list_prepend(offline_provider,item);
-                }
+                /* add it to the hash table and relate it to the MetaDataSource */
+                g_hash_table_insert(url_table,(gpointer)STRIP_KNOWN_PAGE_MARK(prepared),(gpointer)item);
+                url_list = g_list_prepend(url_list,(gpointer)prepared);
+                endmarks = g_list_prepend(endmarks,(gpointer)item->endmarker);
+                sources = g_list_prepend(sources,item);
+            }
+            else if(offline == TRUE)
+            {
+                offline_provider = g_list_prepend(offline_provider,item);
             }
         }
     }
 
+    ProviderTable table = {
+        .query = query,
+        .fetcher = fetcher,
+        .fired = fired,
+        .url_table = url_table,
+        .fired_urls = NULL
+    };
+
     GList * sub_result_list = NULL;
     gsize url_list_length = g_list_length(url_list);
     if(url_list_length != 0 || g_list_length(offline_provider) != 0)
@@ -1586,7 +3146,7 @@ static void execute_query(GlyrQuery * query, MetaDataFetcher * fetcher, GList *
                     GLYR_ERROR result = GLYRE_OK;
                     if(query->callback.download != NULL)
                     {
-                        result = query->callback.download(off_elem->data,query);
+                        result = query->callback.download(off_elem->data,CALLBACK_QUERY(query));
                     }
 
                     if(result != GLYRE_STOP_PRE && result != GLYRE_SKIP)
@@ -1610,12 +3170,16 @@ static void execute_query(GlyrQuery * query, MetaDataFetcher * fetcher, GList *
         {
             raw_parsed = async_download(url_list,
                     endmarks,
+                    sources,
                     query,
                     url_list_length / query->timeout  + 1,
                     MIN((gint)(url_list_length / query->parallel + 3), query->number + 2),
                     call_provider_callback,    
-                    url_table,                 
-                    TRUE);                    
+                    parse_provider_results,
+                    fire_next_provider,
+                    &table,                 
+                    TRUE,
+                    FALSE);                    
         }
 
         /* Now finalize our retrieved items */
@@ -1634,7 +3198,9 @@ static void execute_query(GlyrQuery * query, MetaDataFetcher * fetcher, GList *
             if(g_list_length(raw_parsed) != 0)
             {
                 /* Call finalize to sanitize data, or download given URLs */
+                gint64 finalize_started = g_get_monotonic_time();
                 ready_caches = fetcher->finalize(query, raw_parsed,stop_me, result_list);
+                trace_span(query,GLYR_TRACE_FINALIZE,NULL,NULL,finalize_started,g_get_monotonic_time(),g_list_length(ready_caches));
 
                 /* Raw data not needed anymore */
                 g_list_free(raw_parsed);
@@ -1654,7 +3220,9 @@ static void execute_query(GlyrQuery * query, MetaDataFetcher * fetcher, GList *
 
     /* Free ressources */
     glist_free_full(url_list,g_free);
+    glist_free_full(table.fired_urls,g_free);
     g_list_free(endmarks);
+    g_list_free(sources);
     g_list_free(offline_provider);
     g_hash_table_destroy(url_table);
 
@@ -1701,8 +3269,10 @@ GList * start_engine(GlyrQuery * query, MetaDataFetcher * fetcher, GLYR_ERROR *
         /* Print what provider were triggered */
         print_trigger(query,src_list);
 
-        /* Send this list of sources to the download manager */
-        execute_query(query,fetcher,src_list, &stop_now, &result_list);
+        /* Send this list of sources to the download manager,
+         * which fires the next ones itself whenever one is done.
+         * We only get here again if too few items survived finalize() */
+        execute_query(query,fetcher,src_list,fired,&stop_now,&result_list);
 
         /* Do not report errors */
         something_was_searched = TRUE;
@@ -1710,8 +3280,8 @@ GList * start_engine(GlyrQuery * query, MetaDataFetcher * fetcher, GLYR_ERROR *
         /* Next list please */
         g_list_free(src_list);
 
-        /* Check is exit was signaled */
-        stop_now = (GET_ATOMIC_SIGNAL_EXIT(query)) ? TRUE : stop_now;
+        /* Check is exit was signaled, or if we're out of time */
+        stop_now = (GET_ATOMIC_SIGNAL_EXIT(query) || deadline_passed(query)) ? TRUE : stop_now;
     }
 
     if(something_was_searched == FALSE)
@@ -1750,23 +3320,7 @@ void update_md5sum(GlyrMemCache * c)
 
 void glist_free_full(GList * List, void (* free_func)(void * ptr))
 {
-#if GLIB_CHECK_VERSION(2,28,0)
-
-    /* Use official version */
     g_list_free_full(List,free_func);
-#else
-
-    /* Fallback to simple own implementation  */
-    for(GList * elem = List; elem; elem = elem->next)
-    {
-        if(free_func != NULL)
-        {
-            free_func(elem->data);
-        }
-
-    }
-    g_list_free(List);
-#endif
 }
 
 //////////////////////////////////////
@@ -24,6 +24,7 @@
 #include "types.h"
 #include "apikeys.h"
 #include "config.h"
+#include "httpcache.h"
 
 /* Global */
 #include <string.h>
@@ -41,6 +42,15 @@
 
 #define G_LOG_DOMAIN "Glyr"
 
+/* Checked by CMake too, but better fail here than with cryptic errors later */
+#if LIBCURL_VERSION_NUM < 0x073d00
+    #error "libglyr needs libcurl >= 7.61.0"
+#endif
+
+#if !GLIB_CHECK_VERSION(2,28,0)
+    #error "libglyr needs glib >= 2.28"
+#endif
+
 /* libglyr uses checksums to filter double items
  * Also you can use those as easy comparasion method
  * There is no valid reason to diasable this actually
@@ -50,13 +60,23 @@
 /* Returned by get_url() in case of offline provider */
 #define OFFLINE_PROVIDER "autogenerated_content"
 
+/* get_url() may prefix its URL with this, if it leads to the final page right away
+ * (e.g. the info page of a cached MusicBrainz ID), so its parser can skip the search.
+ * It is cut off again, and cb_object.known_page is set instead */
+#define KNOWN_PAGE_MARK "glyr-known-page:"
+#define STRIP_KNOWN_PAGE_MARK(URL) (g_str_has_prefix(URL,KNOWN_PAGE_MARK) ? (URL) + (sizeof KNOWN_PAGE_MARK) - 1 : (URL))
+
 /* This needs to be updated in case of new image getters.. this is a bit silly */
 #define TYPE_IS_IMAGE(TYPE) (TYPE == GLYR_GET_COVERART || TYPE == GLYR_GET_ARTIST_PHOTOS || TYPE == GLYR_GET_BACKDROPS)
 
-/* Get signal_exit with atomic operations */
-#define GET_ATOMIC_SIGNAL_EXIT(QUERY)   (g_atomic_int_get(&((QUERY)->signal_exit)))
+/* Get signal_exit with atomic operations; copies made by glyr_get_multi() also obey their origin */
+#define GET_ATOMIC_SIGNAL_EXIT(QUERY)   (g_atomic_int_get(&((QUERY)->signal_exit)) || \
+                                         ((QUERY)->origin != NULL && g_atomic_int_get(&((QUERY)->origin->signal_exit))))
 #define SET_ATOMIC_SIGNAL_EXIT(QUERY,V) (g_atomic_int_set(&((QUERY)->signal_exit),V))
 
+/* The query the user knows about, passed to the callbacks */
+#define CALLBACK_QUERY(QUERY) (((QUERY)->origin != NULL) ? (QUERY)->origin : (QUERY))
+
 /* Feels a little hackish - but works with extremely high probability :-) */
 #define QUERY_INITIALIZER 0xDEADBEEF
 #define QUERY_IS_INITALIZED(Q) (Q && Q->is_initalized == QUERY_INITIALIZER)
@@ -74,10 +94,34 @@ typedef struct {
     GlyrQuery * query;
     char * endmarker;
 
+    /* Handle this buffer is filled by (for Content-Length) */
+    CURL * handle;
+
+    /* Allocated bytes of cache->data */
+    gsize capacity;
+
+    /* Everything before this offset was already searched for endmarker */
+    gsize scan_offset;
+
+    /* The transfer was stopped since endmarker was found */
+    gboolean endmark_hit;
+
+    /* This is an image download; check its header once it's there */
+    gboolean check_image;
+    gboolean format_checked;
+    gboolean size_checked;
+
 } DLBufferContainer;
 
 /*------------------------------------------------------*/
 
+struct cb_object;
+
+/* Second stage of a provider, see fetch_followup() */
+typedef GList * (*FollowupCB)(struct cb_object * capo, gpointer userdata);
+
+/*------------------------------------------------------*/
+
 // Internal calback object, used for cover, lyrics and other
 // This is only used inside the core and the plugins
 // Other parts of the program shall not use this struct
@@ -106,6 +150,69 @@ typedef struct cb_object
     // DLBuffer data
     DLBufferContainer * dlbuffer;
 
+    // Set on follow-up downloads: the object whose parser requested it,
+    // and what to call instead of the parser once it's there.
+    struct cb_object * parent;
+    FollowupCB continuation;
+    gpointer cont_userdata;
+    GDestroyNotify cont_free;
+
+    // The provider's URL was marked with KNOWN_PAGE_MARK
+    gboolean known_page;
+
+    // Follow-ups requested by the parser, not yet scheduled
+    GList * followups;
+
+    // HTTP cache: the stored response if it needs to be revalidated,
+    // the headers to do so, and what the server said about caching
+    GlyrMemCache * stale;
+    struct curl_slist * validators;
+    HttpCacheMeta http_meta;
+
+    // Served from the HTTP cache, without any transfer
+    gboolean cache_hit;
+
+    // Counted as pending by update_provider_busy(); 
+    // on the first request of a provider: how many of its requests are
+    gboolean pending;
+    gint pending_requests;
+
+    // Set if the same download is shared with other queries;
+    // only the leader actually downloads it.
+    // Followers wait since flight_joined (monotonic µs) for at most GlyrQuery.timeout,
+    // then download it on their own (solo)
+    struct _Flight * flight;
+    gboolean flight_leader;
+    gint64 flight_joined;
+    gboolean solo;
+
+    // Endmark this was downloaded with
+    gchar * endmark;
+
+    // Host limits (see ratelimit.h): the transfer waits to be started
+    // since queued_since (monotonic µs), or holds a slot of host
+    gchar * host;
+    gboolean queued;
+    gint64 queued_since;
+    gboolean holds_slot;
+
+    // Provider this was requested for, NULL if none;
+    // its timeout is derived from the provider's latency
+    struct MetaDataSource * source;
+
+    // When the transfer was put on the multihandle (monotonic µs),
+    // and how many items the query had by then; 
+    // hedged is set on the first request of a provider, once it was hedged
+    gint64 started;
+    gint started_itemctr;
+    gboolean hedged;
+
+    // Handed to a parser thread of async_download();
+    // parsed holds its results once parse_ready was set
+    gboolean parsing;
+    volatile gint parse_ready;
+    GList * parsed;
+
 } cb_object;
 
 /*------------------------------------------------------*/
@@ -166,15 +273,43 @@ typedef struct MetaDataSource
 
     GLYR_DATA_TYPE data_type; /* Default datatype this provider delievers */
 
+    gint id; /* Position in the list of all providers, set on registration */
+
 } MetaDataSource;
 
 /*------------------------------------------------------*/
 
 typedef GList*(*AsyncDLCB)(cb_object*,void *,bool*,gint*);
-GList * async_download(GList * url_list, GList * endmark_list, GlyrQuery * s, long parallel_fac, long timeout_fac, AsyncDLCB callback, void * userptr, gboolean free_caches);
+
+/* Called in a worker thread with the userptr of async_download() once a download is complete,
+ * before the AsyncDLCB is called for it on the thread of async_download(), with the result in capo->parsed.
+ * Meant for the CPU-heavy part, so other transfers are serviced meanwhile.
+ * It may only change capo and whatever it returns, and runs concurrently with other ones.
+ */
+typedef GList*(*AsyncParseCB)(cb_object*,void *);
+
+/* Called with the userptr of async_download() whenever a provider finished
+ * and less than GlyrQuery.parallel are left, or if a transfer is slow and GlyrQuery.hedge is set.
+ * Shall give the url, endmark and source of the next provider to start,
+ * or return FALSE if there's none. The url stays owned by the callee.
+ */
+typedef gboolean(*AsyncProviderCB)(void *,gchar**,gchar**,MetaDataSource**);
+
+GList * async_download(GList * url_list, GList * endmark_list, GList * source_list, GlyrQuery * s, long parallel_fac, long timeout_fac, AsyncDLCB callback, AsyncParseCB parse_callback, AsyncProviderCB next_provider, void * userptr, gboolean free_caches, gboolean images);
 GList * start_engine(GlyrQuery * query, MetaDataFetcher * fetcher, GLYR_ERROR * err);
 GlyrMemCache * download_single(const char* url, GlyrQuery * s, const char * end);
 
+/* Non-blocking alternative to download_single() for parsers:
+ * url is downloaded on the same multihandle once the parser returned,
+ * stopping at endmark like download_single() does (may be NULL; it needs
+ * to stay valid during the query, a literal is fine),
+ * then continuation is called with the page in capo->cache.
+ * Whatever it returns is treated like the parser's results.
+ * free_userdata (may be NULL) is called on userdata in any case.
+ * Returns TRUE if the download was queued.
+ */
+gboolean fetch_followup(cb_object * capo, const gchar * url, const gchar * endmark, FollowupCB continuation, gpointer userdata, GDestroyNotify free_userdata);
+
 /*------------------------------------------------------*/
 
 GlyrMemCache * DL_init(void);
@@ -182,6 +317,9 @@ GlyrMemCache * DL_copy(GlyrMemCache * cache);
 void DL_free(GlyrMemCache *cache);
 void DL_set_data(GlyrMemCache * cache, const gchar * data, gint len);
 
+/* Pass body to DL_buffer() in pieces of chunk bytes, like curl would, see glyr_testing_buffer() */
+GlyrMemCache * DL_buffer_replay(const gchar * body, gsize size, gsize chunk, const gchar * endmarker);
+
 /*------------------------------------------------------*/
 
 void update_md5sum(GlyrMemCache * c);
@@ -192,6 +330,34 @@ void glist_free_full(GList * List, void (* free_func)(void * ptr));
 gboolean size_is_okay(int sZ, int min, int max);
 gboolean is_in_result_list(GlyrMemCache * cache, GList * result_list);
 gboolean provider_is_enabled(GlyrQuery * q, MetaDataSource * f);
+
+/* glyr_opt_from() compiled to one bit per MetaDataSource.id */
+typedef struct {
+    /* What it was compiled from, and how many providers there were */
+    const gchar * from;
+    gsize providers;
+    guint32 bits[];
+} ProviderMask;
+
+ProviderMask * provider_mask_compile(const gchar * from);
+
+/* Recompile q->from_mask if q->from changed or providers were registered since.
+ * Only called where the query may be changed: glyr_opt_from(), glyr_query_init() and on entry of glyr_get();
+ * provider_is_enabled() itself only reads it */
+void provider_mask_update(GlyrQuery * q);
+gint queue_all_providers(GlyrQuery * s, MetaDataFetcher * fetcher);
 gboolean continue_search(gint current, GlyrQuery * s);
 
+/* Time left until GlyrQuery.deadline runs out in ms, -1 if there is none.
+ * deadline_clamp_ms() cuts a timeout to it, but never to 0 (no timeout for curl) */
+gint64 deadline_remaining_ms(GlyrQuery * s);
+gboolean deadline_passed(GlyrQuery * s);
+glong deadline_clamp_ms(GlyrQuery * s, glong timeout_ms);
+
+/* Does the work for one query of batch_run(): glyr_get() for glyr_get_batch() */
+typedef GlyrMemCache * (*BatchRunner)(GlyrQuery * query, GLYR_ERROR * error, int * length, void * runner_data);
+
+/* glyr_get_batch() with what runs for each query left open, e.g. for glyr_testing_fetch_batch() */
+GLYR_ERROR batch_run(GlyrQuery ** queries, size_t n, int max_parallel, BatchRunner runner, void * runner_data, GlyrBatchCallback callback, void * userptr);
+
 #endif
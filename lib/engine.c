@@ -0,0 +1,275 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include "engine.h"
+#include "connpool.h"
+#include "stats.h"
+#include "core.h"
+
+/* Max. time the engine sleeps, if curl does not want to be called earlier */
+#define ENGINE_MAX_WAIT_MS 250
+
+struct _Engine
+{
+    CURLM * multi;
+    EventLoop * loop;
+    GThread * thread;
+
+    /* EngineCommand, read by the thread */
+    GAsyncQueue * commands;
+
+    /* CURL => EngineClient; only touched by the thread */
+    GHashTable * handles;
+
+    volatile gint quit;
+};
+
+struct _EngineClient
+{
+    Engine * engine;
+    EventLoop * loop;
+
+    /* EngineDone */
+    GAsyncQueue * done;
+
+    /* Gets the client itself pushed once it is detached */
+    GAsyncQueue * detached;
+};
+
+/* handle is NULL if client is to be detached */
+typedef struct {
+    EngineClient * client;
+    CURL * handle;
+} EngineCommand;
+
+typedef struct {
+    CURL * handle;
+    CURLcode result;
+} EngineDone;
+
+/*-----------------------------------------------------------------*/
+
+static gboolean remove_if_owned(gpointer handle, gpointer client, gpointer user_data)
+{
+    EngineCommand * cmd = user_data;
+    if(client == cmd->client)
+    {
+        curl_multi_remove_handle(cmd->client->engine->multi,handle);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*-----------------------------------------------------------------*/
+
+static void run_commands(Engine * engine)
+{
+    EngineCommand * cmd;
+    while((cmd = g_async_queue_try_pop(engine->commands)) != NULL)
+    {
+        if(cmd->handle != NULL)
+        {
+            g_hash_table_insert(engine->handles,cmd->handle,cmd->client);
+            curl_multi_add_handle(engine->multi,cmd->handle);
+        }
+        else
+        {
+            g_hash_table_foreach_remove(engine->handles,remove_if_owned,cmd);
+            g_async_queue_push(cmd->client->detached,cmd->client);
+        }
+        g_free(cmd);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Hand finished transfers back to their clients */
+static void collect_done(Engine * engine)
+{
+    gint queue_msg;
+    CURLMsg * msg;
+    while((msg = curl_multi_info_read(engine->multi,&queue_msg)) != NULL)
+    {
+        if(msg->msg == CURLMSG_DONE)
+        {
+            EngineDone * done = g_malloc0(sizeof(EngineDone));
+            done->handle = msg->easy_handle;
+            done->result = msg->data.result;
+
+            EngineClient * client = g_hash_table_lookup(engine->handles,done->handle);
+            g_hash_table_remove(engine->handles,done->handle);
+            curl_multi_remove_handle(engine->multi,done->handle);
+
+            if(client != NULL)
+            {
+                g_async_queue_push(client->done,done);
+                eventloop_wakeup(client->loop);
+            }
+            else
+            {
+                g_free(done);
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+static gpointer engine_worker(gpointer data)
+{
+    Engine * engine = data;
+    while(g_atomic_int_get(&engine->quit) == FALSE)
+    {
+        run_commands(engine);
+
+        CURLMcode loop_rc = eventloop_run_once(engine->loop,ENGINE_MAX_WAIT_MS,NULL);
+        if(loop_rc != CURLM_OK)
+        {
+            glyr_message(-1,NULL,"Error: curl_multi_socket_action() failed: %i: %s\n",loop_rc,curl_multi_strerror(loop_rc));
+        }
+
+        collect_done(engine);
+    }
+    return NULL;
+}
+
+/*-----------------------------------------------------------------*/
+
+Engine * engine_new(gint max_connections)
+{
+    Engine * engine = g_malloc0(sizeof(Engine));
+    engine->multi = curl_multi_init();
+    connpool_setup_multi(engine->multi,max_connections);
+    curl_multi_setopt(engine->multi, CURLMOPT_PIPELINING, 1L);
+
+    engine->loop = eventloop_new(engine->multi);
+    engine->commands = g_async_queue_new();
+    engine->handles = g_hash_table_new(g_direct_hash,g_direct_equal);
+
+    if(engine->loop != NULL)
+    {
+        engine->thread = g_thread_create(engine_worker,engine,TRUE,NULL);
+    }
+
+    if(engine->thread == NULL)
+    {
+        engine_destroy(engine);
+        return NULL;
+    }
+    return engine;
+}
+
+/*-----------------------------------------------------------------*/
+
+void engine_destroy(Engine * engine)
+{
+    if(engine != NULL)
+    {
+        if(engine->thread != NULL)
+        {
+            g_atomic_int_set(&engine->quit,TRUE);
+            eventloop_wakeup(engine->loop);
+            g_thread_join(engine->thread);
+        }
+
+        stats_add(STATS_EVENTLOOP_WAKEUPS,eventloop_get_wakeups(engine->loop));
+
+        curl_multi_cleanup(engine->multi);
+        eventloop_destroy(engine->loop);
+        g_async_queue_unref(engine->commands);
+        g_hash_table_destroy(engine->handles);
+        g_free(engine);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+static void push_command(EngineClient * client, CURL * handle)
+{
+    EngineCommand * cmd = g_malloc0(sizeof(EngineCommand));
+    cmd->client = client;
+    cmd->handle = handle;
+    g_async_queue_push(client->engine->commands,cmd);
+    eventloop_wakeup(client->engine->loop);
+}
+
+/*-----------------------------------------------------------------*/
+
+EngineClient * engine_client_new(Engine * engine, EventLoop * loop)
+{
+    if(engine == NULL)
+    {
+        return NULL;
+    }
+
+    EngineClient * client = g_malloc0(sizeof(EngineClient));
+    client->engine = engine;
+    client->loop = loop;
+    client->done = g_async_queue_new();
+    client->detached = g_async_queue_new();
+    return client;
+}
+
+/*-----------------------------------------------------------------*/
+
+void engine_client_add(EngineClient * client, CURL * handle)
+{
+    if(client != NULL && handle != NULL)
+    {
+        push_command(client,handle);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+gboolean engine_client_next(EngineClient * client, CURL ** handle, CURLcode * result)
+{
+    EngineDone * done = (client) ? g_async_queue_try_pop(client->done) : NULL;
+    if(done == NULL)
+    {
+        return FALSE;
+    }
+
+    *handle = done->handle;
+    *result = done->result;
+    g_free(done);
+    return TRUE;
+}
+
+/*-----------------------------------------------------------------*/
+
+void engine_client_free(EngineClient * client)
+{
+    if(client != NULL)
+    {
+        push_command(client,NULL);
+        g_async_queue_pop(client->detached);
+
+        EngineDone * done;
+        while((done = g_async_queue_try_pop(client->done)) != NULL)
+        {
+            g_free(done);
+        }
+
+        g_async_queue_unref(client->done);
+        g_async_queue_unref(client->detached);
+        g_free(client);
+    }
+}
@@ -0,0 +1,59 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_ENGINE_H
+#define GLYR_ENGINE_H
+
+#include <glib.h>
+#include <curl/curl.h>
+
+#include "eventloop.h"
+
+/* One multihandle, driven by an EventLoop in a thread of its own,
+ * that the transfers of many queries run on (see glyr_get_batch()).
+ * Its connection limit holds for all of them together,
+ * and connections are reused across them.
+ * The queries hand their easy handles over as EngineClient, and get them back once done.
+ */
+typedef struct _Engine Engine;
+typedef struct _EngineClient EngineClient;
+
+/* At most max_connections connections at once; more transfers wait inside curl.
+ * NULL if the thread could not be started */
+Engine * engine_new(gint max_connections);
+
+/* All clients need to be freed before */
+void engine_destroy(Engine * engine);
+
+/* loop is woken up whenever one of the client's transfers is done */
+EngineClient * engine_client_new(Engine * engine, EventLoop * loop);
+
+/* Takes the easy handle away until engine_client_next() returns it.
+ * Until then only curl_easy_cleanup() may touch it, after engine_client_free() */
+void engine_client_add(EngineClient * client, CURL * handle);
+
+/* A transfer that is done, without waiting; FALSE if there is none */
+gboolean engine_client_next(EngineClient * client, CURL ** handle, CURLcode * result);
+
+/* Blocks till the engine let go of all handles of client, then frees it.
+ * Handles neither returned nor done yet are the caller's to clean up */
+void engine_client_free(EngineClient * client);
+
+#endif
@@ -0,0 +1,383 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#ifdef __linux__
+    #define EVENTLOOP_USE_EPOLL
+    #include <sys/epoll.h>
+#else
+    #include <poll.h>
+#endif
+
+#include "eventloop.h"
+
+/* Max. number of events fetched by one wakeup */
+#define EVENTLOOP_MAX_EVENTS 64
+
+struct _EventLoop
+{
+    CURLM * multi;
+
+    /* Absolute time (monotonic, in µs) curl wants to be called,
+     * or -1 if there is no timeout pending */
+    gint64 timer_expire;
+
+    /* Number of returns from epoll_wait/poll */
+    gint wakeups;
+
+    /* Last running_handles count curl gave us */
+    gint running;
+
+    /* Self-pipe, see eventloop_wakeup() */
+    int wake_fds[2];
+
+#ifdef EVENTLOOP_USE_EPOLL
+    int epoll_fd;
+#else
+    /* curl_socket_t => CURL_POLL_* */
+    GHashTable * sockets;
+#endif
+};
+
+/*-----------------------------------------------------------------*/
+
+static int socket_cb(CURL * easy, curl_socket_t sock, int what, void * userp, void * socketp)
+{
+    EventLoop * loop = userp;
+
+#ifdef EVENTLOOP_USE_EPOLL
+    if(what == CURL_POLL_REMOVE)
+    {
+        /* Might be closed already; we don't care about the result */
+        epoll_ctl(loop->epoll_fd,EPOLL_CTL_DEL,sock,NULL);
+        curl_multi_assign(loop->multi,sock,NULL);
+    }
+    else
+    {
+        struct epoll_event ev;
+        memset(&ev,0,sizeof(struct epoll_event));
+        ev.data.fd = sock;
+        ev.events  = ((what & CURL_POLL_IN)  ? EPOLLIN  : 0) |
+                     ((what & CURL_POLL_OUT) ? EPOLLOUT : 0);
+
+        /* socketp is just used as "already known" marker */
+        if(socketp == NULL)
+        {
+            if(epoll_ctl(loop->epoll_fd,EPOLL_CTL_ADD,sock,&ev) == -1 && errno == EEXIST)
+            {
+                epoll_ctl(loop->epoll_fd,EPOLL_CTL_MOD,sock,&ev);
+            }
+            curl_multi_assign(loop->multi,sock,loop);
+        }
+        else
+        {
+            epoll_ctl(loop->epoll_fd,EPOLL_CTL_MOD,sock,&ev);
+        }
+    }
+#else
+    if(what == CURL_POLL_REMOVE)
+    {
+        g_hash_table_remove(loop->sockets,GINT_TO_POINTER(sock));
+    }
+    else
+    {
+        g_hash_table_insert(loop->sockets,GINT_TO_POINTER(sock),GINT_TO_POINTER(what));
+    }
+#endif
+    return 0;
+}
+
+/*-----------------------------------------------------------------*/
+
+static int timer_cb(CURLM * multi, long timeout_ms, void * userp)
+{
+    EventLoop * loop = userp;
+    if(timeout_ms < 0)
+    {
+        loop->timer_expire = -1;
+    }
+    else
+    {
+        loop->timer_expire = g_get_monotonic_time() + (gint64)timeout_ms * 1000;
+    }
+    return 0;
+}
+
+/*-----------------------------------------------------------------*/
+
+static CURLMcode do_action(EventLoop * loop, curl_socket_t sock, int ev_bitmask)
+{
+    int running = 0;
+    CURLMcode rc = curl_multi_socket_action(loop->multi,sock,ev_bitmask,&running);
+    if(rc == CURLM_OK)
+    {
+        loop->running = running;
+    }
+    return rc;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Fire curl's timeout if it expired in the meantime */
+static CURLMcode check_timer(EventLoop * loop)
+{
+    if(loop->timer_expire >= 0 && loop->timer_expire <= g_get_monotonic_time())
+    {
+        /* timer_cb might set a new one */
+        loop->timer_expire = -1;
+        return do_action(loop,CURL_SOCKET_TIMEOUT,0);
+    }
+    return CURLM_OK;
+}
+
+/*-----------------------------------------------------------------*/
+
+static gboolean init_wake_pipe(EventLoop * loop)
+{
+    if(pipe(loop->wake_fds) == -1)
+        return FALSE;
+
+    for(int i = 0; i < 2; i++)
+    {
+        fcntl(loop->wake_fds[i],F_SETFL,fcntl(loop->wake_fds[i],F_GETFL) | O_NONBLOCK);
+    }
+    return TRUE;
+}
+
+/*-----------------------------------------------------------------*/
+
+static void drain_wake_pipe(EventLoop * loop)
+{
+    char buf[64];
+    while(read(loop->wake_fds[0],buf,sizeof(buf)) > 0)
+        ;
+}
+
+/*-----------------------------------------------------------------*/
+
+EventLoop * eventloop_new(CURLM * multi)
+{
+    if(multi == NULL)
+        return NULL;
+
+    EventLoop * loop = g_malloc0(sizeof(EventLoop));
+    loop->multi = multi;
+    loop->timer_expire = -1;
+    loop->running = -1;
+
+    if(init_wake_pipe(loop) == FALSE)
+    {
+        g_free(loop);
+        return NULL;
+    }
+
+#ifdef EVENTLOOP_USE_EPOLL
+    loop->epoll_fd = epoll_create(EVENTLOOP_MAX_EVENTS);
+    if(loop->epoll_fd == -1)
+    {
+        close(loop->wake_fds[0]);
+        close(loop->wake_fds[1]);
+        g_free(loop);
+        return NULL;
+    }
+
+    struct epoll_event ev;
+    memset(&ev,0,sizeof(struct epoll_event));
+    ev.data.fd = loop->wake_fds[0];
+    ev.events = EPOLLIN;
+    epoll_ctl(loop->epoll_fd,EPOLL_CTL_ADD,loop->wake_fds[0],&ev);
+#else
+    loop->sockets = g_hash_table_new(g_direct_hash,g_direct_equal);
+#endif
+
+    curl_multi_setopt(multi,CURLMOPT_SOCKETFUNCTION,socket_cb);
+    curl_multi_setopt(multi,CURLMOPT_SOCKETDATA,loop);
+    curl_multi_setopt(multi,CURLMOPT_TIMERFUNCTION,timer_cb);
+    curl_multi_setopt(multi,CURLMOPT_TIMERDATA,loop);
+    return loop;
+}
+
+/*-----------------------------------------------------------------*/
+
+void eventloop_destroy(EventLoop * loop)
+{
+    if(loop != NULL)
+    {
+#ifdef EVENTLOOP_USE_EPOLL
+        close(loop->epoll_fd);
+#else
+        g_hash_table_destroy(loop->sockets);
+#endif
+        close(loop->wake_fds[0]);
+        close(loop->wake_fds[1]);
+        g_free(loop);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+gint eventloop_get_wakeups(EventLoop * loop)
+{
+    return (loop) ? loop->wakeups : 0;
+}
+
+/*-----------------------------------------------------------------*/
+
+void eventloop_wakeup(EventLoop * loop)
+{
+    if(loop != NULL)
+    {
+        /* If the pipe is full, there's a wakeup pending anyway.
+         * On other errors we notice it after max_wait_ms at the latest. */
+        char c = 0;
+        while(write(loop->wake_fds[1],&c,1) == -1 && errno == EINTR)
+            ;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+CURLMcode eventloop_run_once(EventLoop * loop, glong max_wait_ms, gint * running)
+{
+    CURLMcode rc = CURLM_OK;
+    if(loop == NULL)
+        return CURLM_BAD_HANDLE;
+
+    /* Calculate how long we may sleep */
+    glong wait_ms = max_wait_ms;
+    if(loop->timer_expire >= 0)
+    {
+        /* Rounded up, or the last millisecond would be spent spinning */
+        gint64 diff = (loop->timer_expire - g_get_monotonic_time() + 999) / 1000;
+        wait_ms = CLAMP(diff,0,max_wait_ms);
+    }
+
+    /* curl wants to be called right now */
+    if(wait_ms == 0)
+    {
+        if((rc = check_timer(loop)) != CURLM_OK)
+            return rc;
+
+        if(running != NULL && loop->running != -1)
+            *running = loop->running;
+
+        return CURLM_OK;
+    }
+
+#ifdef EVENTLOOP_USE_EPOLL
+    struct epoll_event events[EVENTLOOP_MAX_EVENTS];
+    int n = epoll_wait(loop->epoll_fd,events,EVENTLOOP_MAX_EVENTS,wait_ms);
+    loop->wakeups++;
+
+    if(n == -1 && errno != EINTR)
+        return CURLM_INTERNAL_ERROR;
+
+    for(int i = 0; i < n; i++)
+    {
+        if(events[i].data.fd == loop->wake_fds[0])
+        {
+            drain_wake_pipe(loop);
+            continue;
+        }
+
+        int mask = 0;
+        if(events[i].events & EPOLLIN)
+            mask |= CURL_CSELECT_IN;
+        if(events[i].events & EPOLLOUT)
+            mask |= CURL_CSELECT_OUT;
+        if(events[i].events & (EPOLLERR | EPOLLHUP))
+            mask |= CURL_CSELECT_ERR;
+
+        if((rc = do_action(loop,events[i].data.fd,mask)) != CURLM_OK)
+            return rc;
+    }
+#else
+    guint n_fds = g_hash_table_size(loop->sockets);
+    struct pollfd * fds = g_malloc0((n_fds + 1) * sizeof(struct pollfd));
+
+    GHashTableIter iter;
+    gpointer key, value;
+    guint i = 0;
+
+    g_hash_table_iter_init(&iter,loop->sockets);
+    while(g_hash_table_iter_next(&iter,&key,&value))
+    {
+        int what = GPOINTER_TO_INT(value);
+        fds[i].fd = GPOINTER_TO_INT(key);
+        fds[i].events = ((what & CURL_POLL_IN)  ? POLLIN  : 0) |
+                        ((what & CURL_POLL_OUT) ? POLLOUT : 0);
+        i++;
+    }
+
+    /* Last slot is the self-pipe */
+    fds[n_fds].fd = loop->wake_fds[0];
+    fds[n_fds].events = POLLIN;
+
+    int n = poll(fds,n_fds + 1,wait_ms);
+    loop->wakeups++;
+
+    if(n == -1 && errno != EINTR)
+    {
+        g_free(fds);
+        return CURLM_INTERNAL_ERROR;
+    }
+
+    /* socket_cb may alter the table, so only work on the copy */
+    for(i = 0; n > 0 && i < n_fds; i++)
+    {
+        if(fds[i].revents != 0)
+        {
+            int mask = 0;
+            if(fds[i].revents & POLLIN)
+                mask |= CURL_CSELECT_IN;
+            if(fds[i].revents & POLLOUT)
+                mask |= CURL_CSELECT_OUT;
+            if(fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+                mask |= CURL_CSELECT_ERR;
+
+            if((rc = do_action(loop,fds[i].fd,mask)) != CURLM_OK)
+            {
+                g_free(fds);
+                return rc;
+            }
+        }
+    }
+
+    if(fds[n_fds].revents != 0)
+    {
+        drain_wake_pipe(loop);
+    }
+    g_free(fds);
+#endif
+
+    if((rc = check_timer(loop)) != CURLM_OK)
+        return rc;
+
+    if(running != NULL && loop->running != -1)
+        *running = loop->running;
+
+    return CURLM_OK;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,53 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_EVENTLOOP_H
+#define GLYR_EVENTLOOP_H
+
+#include <glib.h>
+#include <curl/curl.h>
+
+/* Drives a CURLM via curl_multi_socket_action().
+ * curl tells us which sockets it is interested in (CURLMOPT_SOCKETFUNCTION)
+ * and when it wants to be called on timeout (CURLMOPT_TIMERFUNCTION),
+ * so we only wake up when something actually happened.
+ * Uses epoll on Linux, poll() everywhere else.
+ */
+typedef struct _EventLoop EventLoop;
+
+EventLoop * eventloop_new(CURLM * multi);
+void eventloop_destroy(EventLoop * loop);
+
+/* Wait at most max_wait_ms for activity and hand it to curl.
+ * running is updated with the number of still running transfers,
+ * once curl reported it. Returns what curl_multi_socket_action() failed with,
+ * or CURLM_INTERNAL_ERROR if waiting itself failed (errno tells why then).
+ */
+CURLMcode eventloop_run_once(EventLoop * loop, glong max_wait_ms, gint * running);
+
+/* How often did we return from the kernel? (For debugging) */
+gint eventloop_get_wakeups(EventLoop * loop);
+
+/* Make a (blocking) eventloop_run_once() return as soon as possible.
+ * This is the only function that may be called from another thread.
+ */
+void eventloop_wakeup(EventLoop * loop);
+
+#endif
@@ -25,6 +25,18 @@
 #include "core.h"
 #include "register_plugins.h"
 #include "blacklist.h"
+#include "connpool.h"
+#include "engine.h"
+#include "httpcache.h"
+#include "stats.h"
+#include "ratelimit.h"
+#include "latency.h"
+#include "ranking.h"
+#include "mbidcache.h"
+#include "resultcache.h"
+#include "trace.h"
+#include "metrics.h"
+#include "cache_intern.h"
 #include "cache.h"
 
 //* ------------------------------------------------------- */
@@ -47,7 +59,8 @@ static const char * err_strings[] =
     [GLYRE_STOP_POST] = "Stopped by callback (POST)",               
     [GLYRE_STOP_PRE] = "Stopped by callback (PRE)",   
     [GLYRE_NO_INIT] = "Library is not yet initialized, use glyr_init()",
-    [GLYRE_WAS_STOPPED] = "Library was stopped by glyr_signal_exit()"      
+    [GLYRE_WAS_STOPPED] = "Library was stopped by glyr_signal_exit()",
+    [GLYRE_DEADLINE] = "Deadline passed, results may be incomplete"
 };
 
 static const char * type_strings[] = 
@@ -109,7 +122,6 @@ gchar * guess_language(void)
     /* Default to 'en' in any case */
     gchar * result_lang = g_strdup("en");
 
-#if GLIB_CHECK_VERSION(2,28,0)
     gboolean break_out = FALSE;
 
     /* Please never ever free this */
@@ -149,33 +161,6 @@ gchar * guess_language(void)
         g_strfreev(variants);
     }
 
-#elif GLIB_CHECK_VERSION(2,26,0)
-
-    /* Fallback to simpler version of the above, 
-     * g_get_locale_variants is not there in this version
-     */
-    const gchar * const * possible_locales = g_get_language_names();
-    if(possible_locales != NULL)
-    {
-        /* might be a bit weird */
-        for(gint i = 0; possible_locales[i]; i++)
-        {
-            if(g_ascii_strncasecmp("en",possible_locales[i],2) != 0 &&
-                    g_ascii_strncasecmp("C", possible_locales[i],1) != 0)
-            {
-                g_free(result_lang);
-                result_lang = g_strdup(possible_locales[i]);
-                break;
-            }
-        }
-    }
-#else 
-    /* Fallback for version prior GLib 2.26:
-     * Fallback to "en" always.
-     * Gaaah... shame on you if this happens to you ;-)
-     */
-#endif
-
     /* Properly terminate string */
     END_STRING(result_lang,'_');
     END_STRING(result_lang,'@');
@@ -266,6 +251,20 @@ GLYR_ERROR glyr_opt_dlcallback(GlyrQuery * settings, DL_callback dl_cb, void * u
 
 /*-----------------------------------------------*/
 
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_opt_trace_callback(GlyrQuery * settings, GlyrTraceCallback trace_cb, void * userp)
+{
+    if(settings)
+    {
+        settings->trace.span         = trace_cb;
+        settings->trace.user_pointer = userp;
+        return GLYRE_OK;
+    }
+    return GLYRE_EMPTY_STRUCT;
+}
+
+/*-----------------------------------------------*/
+
 __attribute__((visibility("default")))
 GLYR_ERROR glyr_opt_type(GlyrQuery * s, GLYR_GET_TYPE type)
 {
@@ -419,6 +418,37 @@ GLYR_ERROR glyr_opt_lang_aware_only(GlyrQuery * s, bool lang_aware_only)
 
 /*-----------------------------------------------*/
 
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_opt_sniff_formats(GlyrQuery * s, bool sniff_formats)
+{
+    if(s == NULL) return GLYRE_EMPTY_STRUCT;
+    s->sniff_formats = sniff_formats;
+    return GLYRE_OK;
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_opt_hedge(GlyrQuery * s, bool hedge)
+{
+    if(s == NULL) return GLYRE_EMPTY_STRUCT;
+    s->hedge = hedge;
+    return GLYRE_OK;
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_opt_deadline(GlyrQuery * s, int ms)
+{
+    if(s == NULL) return GLYRE_EMPTY_STRUCT;
+    if(ms < 0) return GLYRE_BAD_VALUE;
+    s->deadline = ms;
+    return GLYRE_OK;
+}
+
+/*-----------------------------------------------*/
+
 __attribute__((visibility("default")))
 GLYR_ERROR glyr_opt_number(GlyrQuery * s, unsigned int num)
 {
@@ -446,6 +476,9 @@ GLYR_ERROR glyr_opt_from(GlyrQuery * s, const char * from)
     if(from != NULL)
     {
         glyr_set_info(s,4,from);
+
+        /* Do the parsing once, not for every provider in every query */
+        provider_mask_update(s);
         return GLYRE_OK;
     }
     return GLYRE_BAD_VALUE;
@@ -591,6 +624,8 @@ static void set_query_on_defaults(GlyrQuery * glyrs)
     glyrs->local_db = NULL;
     glyrs->callback.download = NULL;
     glyrs->callback.user_pointer = NULL;
+    glyrs->trace.span = NULL;
+    glyrs->trace.user_pointer = NULL;
     glyrs->musictree_path = NULL;
     glyrs->q_errno = GLYRE_OK;
 
@@ -614,6 +649,12 @@ static void set_query_on_defaults(GlyrQuery * glyrs)
     glyrs->force_utf8 = GLYR_DEFAULT_FORCE_UTF8;
     glyrs->lang = GLYR_DEFAULT_LANG;
     glyrs->lang_aware_only = GLYR_DEFAULT_LANG_AWARE_ONLY;
+    glyrs->sniff_formats = GLYR_DEFAULT_SNIFF_FORMATS;
+    glyrs->hedge = GLYR_DEFAULT_HEDGE;
+    glyrs->deadline = GLYR_DEFAULT_DEADLINE;
+    glyrs->deadline_at = 0;
+    glyrs->origin = NULL;
+    glyrs->engine = NULL;
     glyrs->signal_exit = FALSE;
     glyrs->itemctr = 0;
 
@@ -630,6 +671,7 @@ void glyr_query_init(GlyrQuery * glyrs)
     if(glyrs != NULL)
     {
         set_query_on_defaults(glyrs);
+        provider_mask_update(glyrs);
     }
 }
 
@@ -648,6 +690,7 @@ void glyr_query_destroy(GlyrQuery * sets)
                 sets->info[i] = NULL;
             }
         }
+        g_free(sets->from_mask);
 
         /* Reset query so it can be used again */
         set_query_on_defaults(sets);
@@ -707,6 +750,107 @@ GlyrMemCache * glyr_cache_new(void)
 
 /*-----------------------------------------------*/
 
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_set_connection_pool(int max_connections, int max_idle)
+{
+    if(max_connections <= 0 || max_idle < 0)
+        return GLYRE_BAD_VALUE;
+
+    connpool_set_limits(max_connections,max_idle);
+    return GLYRE_OK;
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_set_http_cache(const char * path, size_t max_size, int default_ttl)
+{
+    if(path == NULL)
+    {
+        httpcache_close();
+        return GLYRE_OK;
+    }
+
+    if(max_size == 0)
+        max_size = GLYR_DEFAULT_HTTP_CACHE_SIZE;
+
+    if(default_ttl < 0)
+        default_ttl = GLYR_DEFAULT_HTTP_CACHE_TTL;
+
+    return httpcache_open(path,max_size,default_ttl) ? GLYRE_OK : GLYRE_BAD_VALUE;
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_set_result_cache(size_t max_size, int ttl)
+{
+    resultcache_configure(max_size,ttl);
+    return GLYRE_OK;
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_set_host_limit(const char * host, double requests_per_second, int burst, int max_parallel)
+{
+    if(burst <= 0)
+        burst = GLYR_DEFAULT_HOST_BURST;
+
+    ratelimit_set(host,requests_per_second,burst,max_parallel);
+    return GLYRE_OK;
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+void glyr_stats_get(GlyrStats * stats)
+{
+    stats_get(stats);
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+void glyr_stats_reset(void)
+{
+    stats_reset();
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GlyrProviderMetrics * glyr_metrics_snapshot(void)
+{
+    return metrics_snapshot();
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+void glyr_metrics_free(GlyrProviderMetrics * metrics)
+{
+    metrics_free_snapshot(metrics);
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+void glyr_metrics_reset(void)
+{
+    metrics_reset();
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+char * glyr_metrics_to_prometheus(GlyrProviderMetrics * metrics)
+{
+    return metrics_to_prometheus(metrics);
+}
+
+/*-----------------------------------------------*/
+
 // !! NOT THREADSAFE !! //
 __attribute__((visibility("default")))
 void glyr_init(void)
@@ -736,9 +880,15 @@ void glyr_init(void)
         /* Register plugins */
         register_fetcher_plugins();
 
+        /* One slot per provider */
+        metrics_init(g_list_length(r_getSList()));
+
         /* Init the smallest blacklist in the world :-) */
         blacklist_build();
 
+        /* Share connections, DNS and TLS sessions between queries */
+        connpool_init();
+
         is_initalized = TRUE;
     }
 }
@@ -752,6 +902,18 @@ void glyr_cleanup(void)
 {
     if(is_initalized == TRUE)
     {
+        /* Close all pooled connections */
+        connpool_destroy();
+
+        /* And the HTTP cache, if any */
+        httpcache_close();
+        ratelimit_destroy();
+        latency_destroy();
+        ranking_destroy();
+        mbidcache_destroy();
+        resultcache_destroy();
+        metrics_destroy();
+
         /* Curl no longer needed */
         curl_global_cleanup();
 
@@ -835,6 +997,59 @@ static void set_error(GLYR_ERROR err_in, GlyrQuery * query, GLYR_ERROR * err_out
 
 /*-----------------------------------------------*/
 
+/* Results from resultcache.h are passed to the callback, like the finalizers do.
+ * Returns what the callback left of the list */
+static GlyrMemCache * pass_cached_results(GlyrQuery * query, GlyrMemCache * head, gint * length)
+{
+    gboolean stopped = FALSE;
+    GlyrMemCache * item = head;
+    *length = 0;
+
+    while(item != NULL)
+    {
+        GlyrMemCache * next = item->next;
+        GLYR_ERROR response = GLYRE_OK;
+        if(stopped == FALSE && query->callback.download != NULL)
+        {
+            response = query->callback.download(item,CALLBACK_QUERY(query));
+        }
+
+        if(stopped == TRUE || response == GLYRE_SKIP || response == GLYRE_STOP_PRE)
+        {
+            /* Unlink and forget */
+            if(item->prev != NULL)
+            {
+                item->prev->next = next;
+            }
+            else
+            {
+                head = next;
+            }
+
+            if(next != NULL)
+            {
+                next->prev = item->prev;
+            }
+
+            item->next = item->prev = NULL;
+            DL_free(item);
+        }
+        else
+        {
+            length[0]++;
+        }
+
+        if(response == GLYRE_STOP_POST || response == GLYRE_STOP_PRE)
+        {
+            stopped = TRUE;
+        }
+        item = next;
+    }
+    return head;
+}
+
+/*-----------------------------------------------*/
+
 __attribute__((visibility("default")))
 GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
 {
@@ -852,11 +1067,39 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
 
     if(query != NULL)
     {
+        gint64 query_started = g_get_monotonic_time();
         if(g_ascii_strncasecmp(query->lang,"auto",4) == 0)
         {
             glyr_opt_lang(query,"auto");
         }
 
+        /* Asked for the very same a moment ago? */
+        gint cached_length = 0;
+        GlyrMemCache * cached = resultcache_lookup(query,&cached_length);
+        if(cached != NULL)
+        {
+            glyr_message(2,query,"- Served %d item(s) from result cache\n",cached_length);
+            cached = pass_cached_results(query,cached,&cached_length);
+            if(length != NULL)
+            {
+                *length = cached_length;
+            }
+
+            trace_span(query,GLYR_TRACE_QUERY,NULL,NULL,query_started,g_get_monotonic_time(),cached_length);
+            SET_ATOMIC_SIGNAL_EXIT(query,0);
+            return cached;
+        }
+
+        /* In case glyr_opt_from() was called before glyr_init() */
+        provider_mask_update(query);
+
+        /* Everything below takes its time from here */
+        query->deadline_at = 0;
+        if(query->deadline > 0)
+        {
+            query->deadline_at = g_get_monotonic_time() + (gint64) query->deadline * 1000;
+        }
+
         GList * result = NULL;
         set_error(GLYRE_UNKNOWN_GET, query, e);
 
@@ -900,6 +1143,12 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
 
                     /* Now start your engines, gentlemen */
                     result = start_engine(query,item,e);
+
+                    /* Let the next run profit of what we learned about the providers */
+                    if(query->local_db != NULL)
+                    {
+                        db_save_provider_stats(query->local_db,item->type);
+                    }
                     break;
                 }
                 else
@@ -909,8 +1158,16 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
             }
         }
 
+        /* Ran out of time? Whatever was found until then is still returned */
+        if(query->q_errno == GLYRE_OK && deadline_passed(query))
+        {
+            glyr_message(2,query,"- Deadline of %dms passed; returning what was found so far.\n",query->deadline);
+            set_error(GLYRE_DEADLINE, query, e);
+        }
+
         /* Make this query reusable */
         query->itemctr = 0;
+        query->deadline_at = 0;
 
         /* Start of the returned list */
         GlyrMemCache * head = NULL;
@@ -928,9 +1185,10 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
         }
 
         /* Set the length */
+        gint found = g_list_length(result);
         if(length != NULL)
         {
-            *length = g_list_length(result);
+            *length = found;
         }
 
         /* free if empty */
@@ -938,6 +1196,7 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
         {
             /* Count inserstions */
             gint db_inserts = 0;
+            gint64 insert_started = g_get_monotonic_time();
 
             /* link caches to each other */
             for(GList * elem = result; elem; elem = elem->next)
@@ -956,6 +1215,7 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
             if(db_inserts > 0)
             {
                 glyr_message(2,query,"--- Inserted %d item%s into db.\n",db_inserts,(db_inserts == 1) ? "" : "s");
+                trace_span(query,GLYR_TRACE_DB_INSERT,NULL,NULL,insert_started,g_get_monotonic_time(),db_inserts);
             }
 
             /* Finish. */
@@ -964,11 +1224,18 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
                 head = g_list_first(result)->data;
             }
 
+            /* Only complete results may stand in for a search */
+            if(g_list_length(result) == (guint)query->number)
+            {
+                resultcache_store(query,head);
+            }
+
             g_list_free(result);
             result = NULL;
         }
 
         /* Done! */
+        trace_span(query,GLYR_TRACE_QUERY,NULL,NULL,query_started,g_get_monotonic_time(),found);
         SET_ATOMIC_SIGNAL_EXIT(query,0);
         return head;
     }
@@ -980,6 +1247,258 @@ GlyrMemCache * glyr_get(GlyrQuery * query, GLYR_ERROR * e, int * length)
 
 /*-----------------------------------------------*/
 
+/* One query of batch_run() */
+typedef struct {
+    GlyrQuery * query;
+    GlyrMemCache * results;
+    GLYR_ERROR error;
+    int length;
+
+    BatchRunner runner;
+    void * runner_data;
+
+    /* Set once the callback stopped the batch */
+    volatile gint * stopped;
+} BatchJob;
+
+/*-----------------------------------------------*/
+
+/* Runs in a thread of the pool, the results are handed back via done_queue */
+static void batch_worker(gpointer data, gpointer done_queue)
+{
+    BatchJob * job = data;
+    if(g_atomic_int_get(job->stopped) == FALSE)
+    {
+        job->results = job->runner(job->query,&job->error,&job->length,job->runner_data);
+    }
+    else
+    {
+        job->error = GLYRE_WAS_STOPPED;
+    }
+    g_async_queue_push(done_queue,job);
+}
+
+/*-----------------------------------------------*/
+
+GLYR_ERROR batch_run(GlyrQuery ** queries, size_t n, int max_parallel, BatchRunner runner, void * runner_data, GlyrBatchCallback callback, void * userptr)
+{
+    if(max_parallel <= 0)
+    {
+        max_parallel = GLYR_DEFAULT_BATCH_PARALLEL;
+    }
+
+    /* The transfers of all queries share one multihandle, and its connections.
+     * Without it (no thread left?) every query gets one of its own, as in glyr_get() */
+    Engine * engine = engine_new(connpool_get_max_connections());
+    if(engine == NULL)
+    {
+        glyr_message(-1,NULL,"Warning: Unable to start the download engine, running queries on their own.\n");
+    }
+
+    GLYR_ERROR result = GLYRE_OK;
+    volatile gint stopped = FALSE;
+    BatchJob * jobs = g_malloc0(MAX(n,1) * sizeof(BatchJob));
+    GAsyncQueue * done_queue = g_async_queue_new();
+    GThreadPool * pool = g_thread_pool_new(batch_worker,done_queue,MIN((gsize)max_parallel,MAX(n,1)),FALSE,NULL);
+
+    gsize pushed = 0;
+    for(gsize i = 0; i < n; i++)
+    {
+        if(queries[i] != NULL)
+        {
+            queries[i]->engine = engine;
+            jobs[i].query = queries[i];
+            jobs[i].runner = runner;
+            jobs[i].runner_data = runner_data;
+            jobs[i].stopped = &stopped;
+            g_thread_pool_push(pool,&jobs[i],NULL);
+            pushed++;
+        }
+    }
+
+    /* Deliver in this thread, whatever is done first */
+    for(gsize i = 0; i < pushed; i++)
+    {
+        BatchJob * job = g_async_queue_pop(done_queue);
+        if(callback != NULL && g_atomic_int_get(&stopped) == FALSE)
+        {
+            GLYR_ERROR rc = callback(job->query,job->results,job->error,job->length,userptr);
+            if(rc == GLYRE_STOP_PRE || rc == GLYRE_STOP_POST)
+            {
+                /* Running queries are stopped, waiting ones not started at all */
+                g_atomic_int_set(&stopped,TRUE);
+                result = rc;
+                for(gsize j = 0; j < n; j++)
+                {
+                    if(jobs[j].query != NULL)
+                    {
+                        glyr_signal_exit(jobs[j].query);
+                    }
+                }
+            }
+        }
+        else
+        {
+            glyr_free_list(job->results);
+        }
+    }
+
+    g_thread_pool_free(pool,FALSE,TRUE);
+    g_async_queue_unref(done_queue);
+
+    /* Make the queries usable again, like glyr_get() does */
+    for(gsize i = 0; i < n; i++)
+    {
+        if(jobs[i].query != NULL)
+        {
+            jobs[i].query->engine = NULL;
+            if(stopped == TRUE)
+            {
+                SET_ATOMIC_SIGNAL_EXIT(jobs[i].query,0);
+            }
+        }
+    }
+
+    engine_destroy(engine);
+    g_free(jobs);
+    return result;
+}
+
+/*-----------------------------------------------*/
+
+static GlyrMemCache * batch_get(GlyrQuery * query, GLYR_ERROR * error, int * length, void * runner_data)
+{
+    return glyr_get(query,error,length);
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_get_batch(GlyrQuery ** queries, size_t n, int max_parallel, GlyrBatchCallback callback, void * userptr)
+{
+    if(is_initalized == FALSE)
+    {
+        return GLYRE_NO_INIT;
+    }
+
+    if(queries == NULL)
+    {
+        return GLYRE_EMPTY_STRUCT;
+    }
+
+    return batch_run(queries,n,max_parallel,batch_get,NULL,callback,userptr);
+}
+
+/*-----------------------------------------------*/
+
+/* Fill dst with the same settings as src; both need to be destroyed on their own */
+static void query_copy(GlyrQuery * dst, GlyrQuery * src)
+{
+    *dst = *src;
+    dst->from_mask = NULL;
+    dst->itemctr = 0;
+    dst->signal_exit = 0;
+    dst->origin = src;
+    dst->engine = NULL;
+
+    for(gsize i = 0; i < 10; i++)
+    {
+        dst->info[i] = NULL;
+        if(src->info[i] != NULL)
+        {
+            glyr_set_info(dst,i,src->info[i]);
+        }
+    }
+    provider_mask_update(dst);
+}
+
+/*-----------------------------------------------*/
+
+/* What glyr_get_multi() passes to glyr_get_batch() */
+typedef struct {
+    GlyrQuery * queries;
+    GlyrMemCache ** results;
+    int * lengths;
+    GLYR_ERROR * errors;
+} MultiResults;
+
+/*-----------------------------------------------*/
+
+static GLYR_ERROR multi_collect(GlyrQuery * query, GlyrMemCache * results, GLYR_ERROR error, int length, void * userptr)
+{
+    MultiResults * multi = userptr;
+    gsize i = query - multi->queries;
+
+    multi->results[i] = results;
+    if(multi->lengths != NULL)
+    {
+        multi->lengths[i] = length;
+    }
+    if(multi->errors != NULL)
+    {
+        multi->errors[i] = error;
+    }
+    return GLYRE_OK;
+}
+
+/*-----------------------------------------------*/
+
+__attribute__((visibility("default")))
+GLYR_ERROR glyr_get_multi(GlyrQuery * settings, const GLYR_GET_TYPE * types, size_t n, GlyrMemCache ** results, int * lengths, GLYR_ERROR * errors)
+{
+    if(is_initalized == FALSE || QUERY_IS_INITALIZED(settings) == FALSE)
+    {
+        return GLYRE_NO_INIT;
+    }
+
+    if(types == NULL || results == NULL)
+    {
+        return GLYRE_EMPTY_STRUCT;
+    }
+
+    /* One query per type, all with the settings of the one given */
+    GlyrQuery * queries = g_malloc0(MAX(n,1) * sizeof(GlyrQuery));
+    GlyrQuery ** query_ptrs = g_malloc0(MAX(n,1) * sizeof(GlyrQuery*));
+    for(gsize i = 0; i < n; i++)
+    {
+        query_copy(&queries[i],settings);
+        glyr_opt_type(&queries[i],types[i]);
+        query_ptrs[i] = &queries[i];
+
+        results[i] = NULL;
+        if(lengths != NULL)
+        {
+            lengths[i] = 0;
+        }
+        if(errors != NULL)
+        {
+            errors[i] = GLYRE_OK;
+        }
+    }
+
+    /* All at once, so they can share whatever they download in common */
+    MultiResults multi = {
+        .queries = queries,
+        .results = results,
+        .lengths = lengths,
+        .errors  = errors
+    };
+    GLYR_ERROR result = glyr_get_batch(query_ptrs,n,MAX(n,1),multi_collect,&multi);
+
+    /* Make settings usable again, like glyr_get() does */
+    SET_ATOMIC_SIGNAL_EXIT(settings,0);
+
+    for(gsize i = 0; i < n; i++)
+    {
+        glyr_query_destroy(&queries[i]);
+    }
+    g_free(query_ptrs);
+    g_free(queries);
+    return result;
+}
+
+/*-----------------------------------------------*/
+
 __attribute__((visibility("default")))
 int glyr_cache_write(GlyrMemCache * data, const char * path)
 {
@@ -1187,6 +1706,10 @@ void glyr_cache_print(GlyrMemCache * cacheditem)
         else
         {
             glyr_message(-1,NULL,"\nFRMT: %s",cacheditem->img_format);
+            if(cacheditem->img_width > 0 && cacheditem->img_height > 0)
+            {
+                glyr_message(-1,NULL,"\nSIZE: %dx%d",cacheditem->img_width,cacheditem->img_height);
+            }
             glyr_message(-1,NULL,"\nDATA: <not printable>");
         }
         glyr_message(-1,NULL,"\n");
@@ -74,6 +74,130 @@ void glyr_init(void);
  **/
 void glyr_cleanup(void);
 
+/**
+ * glyr_set_connection_pool:
+ * @max_connections: Max. number of connections a single query, or a glyr_get_batch() as a whole, may open at once (default: 32)
+ * @max_idle: Seconds an idle connection may be reused, 0 for libcurl's default (default: 120)
+ *
+ * All queries share one cache of DNS entries and TLS sessions,
+ * so subsequent queries to the same provider skip the lookup and most of the handshake.
+ * Open connections themselves are only reused within one query, or one glyr_get_batch().
+ * This sets the bounds of these connections. It affects all queries started afterwards.
+ *
+ * Returns: an error ID
+ */
+GLYR_ERROR glyr_set_connection_pool(int max_connections, int max_idle);
+
+/**
+ * glyr_set_http_cache:
+ * @path: An existing directory to store the cache in, or NULL to disable it (default: NULL)
+ * @max_size: Max. size of all stored responses in bytes, 0 for the default (64MB)
+ * @default_ttl: Seconds a response is considered fresh if the server does not tell, -1 for the default (3600)
+ *
+ * Enables a cache of raw HTTP responses shared by all queries, stored in #GLYR_HTTP_CACHE_FILENAME.
+ * Fresh responses are taken from there without asking the server at all,
+ * outdated ones are revalidated via If-None-Match/If-Modified-Since.
+ * Images are never stored there. If it grows over @max_size the least recently used responses are deleted.
+ *
+ * Do not confuse this with glyr_db_init(), which stores the final items.
+ * 
+ * Returns: an error ID
+ */
+GLYR_ERROR glyr_set_http_cache(const char * path, size_t max_size, int default_ttl);
+
+/**
+ * glyr_set_result_cache:
+ * @max_size: Max. size of all kept results in bytes, 0 to disable it (default: 0)
+ * @ttl: Seconds results are kept, -1 for the default (60)
+ *
+ * Enables a cache of the results of glyr_get() in memory, shared by all queries.
+ * A query asking for the same as one before (same type, artist, album, title, providers, 
+ * language, number of items and whether to download) gets a copy of its results, without searching again.
+ * Only queries that found as many items as asked for are remembered.
+ * If the results grow over @max_size the least recently used ones are dropped.
+ *
+ * This is cheaper than glyr_db_init(), but it's lost once the program ends.
+ * See glyr_stats_get() for how often it was useful.
+ * 
+ * Returns: an error ID
+ */
+GLYR_ERROR glyr_set_result_cache(size_t max_size, int ttl);
+
+/**
+ * glyr_set_host_limit:
+ * @host: Hostname like "musicbrainz.org", or NULL to set the default for all hosts.
+ * @requests_per_second: Max. number of requests started per second, may be fractional; 0 for no limit.
+ * @burst: How many requests may be started at once after a pause, 0 for the default (1).
+ * @max_parallel: Max. number of transfers running at the same time; 0 for no limit.
+ *
+ * Some providers (like musicbrainz or last.fm) ban clients that ask too often.
+ * The limits set here are shared by all queries of the process, unlike glyr_opt_parallel().
+ * Transfers over the limits are not dropped, but wait till it's their turn;
+ * see @queue_wait_ms of glyr_stats_get().
+ *
+ * By default nothing is limited. 
+ * Hosts are compared as they appear in the URL, redirects are not considered.
+ *
+ * Returns: an error ID
+ */
+GLYR_ERROR glyr_set_host_limit(const char * host, double requests_per_second, int burst, int max_parallel);
+
+/**
+ * glyr_stats_get:
+ * @stats: A GlyrStats to fill.
+ *
+ * Get some statistics about the download engine, summed up over all queries.
+ * For example, the ratio of @flights_joined to @flights_started tells how often
+ * concurrent queries shared a download instead of doing it twice.
+ */
+void glyr_stats_get(GlyrStats * stats);
+
+/**
+ * glyr_stats_reset:
+ *
+ * Set all counters of glyr_stats_get() to 0.
+ */
+void glyr_stats_reset(void);
+
+/**
+ * glyr_metrics_snapshot:
+ *
+ * Get the counters kept for each provider: downloads, errors, bytes, 
+ * what happened to the items it found and how long its downloads took.
+ * Unlike glyr_info_get(), nothing is loaded from a database; all is counted since glyr_init().
+ * The counters are updated without locking, so this may be called anytime, even while queries run.
+ *
+ * Returns: a doubly linked list with one #GlyrProviderMetrics per provider; free it with glyr_metrics_free().
+ */
+GlyrProviderMetrics * glyr_metrics_snapshot(void);
+
+/**
+ * glyr_metrics_free:
+ * @metrics: What glyr_metrics_snapshot() returned.
+ *
+ * Free a snapshot of glyr_metrics_snapshot().
+ */
+void glyr_metrics_free(GlyrProviderMetrics * metrics);
+
+/**
+ * glyr_metrics_reset:
+ *
+ * Set all counters of glyr_metrics_snapshot() to 0.
+ */
+void glyr_metrics_reset(void);
+
+/**
+ * glyr_metrics_to_prometheus:
+ * @metrics: What glyr_metrics_snapshot() returned.
+ *
+ * Convert a snapshot to the text format prometheus and compatible tools scrape.
+ * The metrics are named glyr_provider_*, labeled by provider and getter; 
+ * latencies are given in seconds, as prometheus wants them.
+ *
+ * Returns: a newly allocated string.
+ */
+char * glyr_metrics_to_prometheus(GlyrProviderMetrics * metrics);
+
 
 /**
  * glyr_get:
@@ -91,6 +215,127 @@ void glyr_cleanup(void);
  */
 GlyrMemCache * glyr_get(GlyrQuery * settings, GLYR_ERROR * error, int * length);
 
+/**
+ * glyr_get_batch:
+ * @queries: An array of queries, filled like for glyr_get(). %NULL elements are skipped.
+ * @n: Number of elements in @queries
+ * @max_parallel: How many queries to run at the same time, <= 0 for #GLYR_DEFAULT_BATCH_PARALLEL
+ * @callback: Called with the results of every query once it is done, may be %NULL.
+ * @userptr: Passed to @callback
+ *
+ * Run many queries at once, e.g. to look up a whole music collection.
+ * The transfers of all queries run on one shared download engine (one multihandle and event loop, in a thread of its own).
+ * Its connections are limited by glyr_set_connection_pool() for the whole batch, not per query,
+ * and reused from one query to the next; transfers over the limit wait for a free connection,
+ * which counts against the timeout of their query.
+ * Choosing providers and parsing still happens per query, in a pool of @max_parallel threads,
+ * which mostly sleep while their transfers run on the engine.
+ * Besides that the queries share what every glyr_get() shares: cached DNS entries and TLS sessions,
+ * the HTTP cache, identical downloads running at the same time, and the limits set by glyr_set_host_limit().
+ *
+ * @callback is always called from the thread that called glyr_get_batch(), 
+ * in the order the queries finish, so it needs no locking. 
+ * If it's %NULL, the results are freed right away.
+ * Returns once all queries are done.
+ *
+ * Returns: GLYRE_OK, GLYRE_STOP_PRE or GLYRE_STOP_POST if @callback stopped the batch, or an error.
+ */
+GLYR_ERROR glyr_get_batch(GlyrQuery ** queries, size_t n, int max_parallel, GlyrBatchCallback callback, void * userptr);
+
+/**
+ * glyr_get_multi:
+ * @settings: The setting struct controlling glyr, like for glyr_get(). Its type is ignored.
+ * @types: What to search for, e.g. GLYR_GET_COVERART and GLYR_GET_LYRICS
+ * @n: Number of elements in @types
+ * @results: An array of @n elements, filled with what was found for the type at the same index. Free each one with glyr_free_list().
+ * @lengths: An optional array of @n elements, filled with the length of each result list, or %NULL
+ * @errors: An optional array of @n elements, filled with the error glyr_get() reported for each type, or %NULL
+ *
+ * Search all of @types for the same artist/album/title in one go.
+ * All types are searched at the same time, each with a copy of @settings (see glyr_get_batch()).
+ * Downloads they have in common (the same artistpage, or the same MusicBrainz lookup) 
+ * are only done once if they run at the same moment, or if glyr_set_http_cache() is enabled.
+ * Otherwise they may be repeated for every type.
+ * glyr_signal_exit() on @settings stops all types.
+ *
+ * <note>
+ * <para>
+ * The callbacks set via glyr_opt_dlcallback() and glyr_opt_trace_callback() get @settings passed,
+ * but are called from several threads at once.
+ * </para>
+ * </note>
+ *
+ * Returns: GLYRE_OK if all types were searched, or an error
+ */
+GLYR_ERROR glyr_get_multi(GlyrQuery * settings, const GLYR_GET_TYPE * types, size_t n, GlyrMemCache ** results, int * lengths, GLYR_ERROR * errors);
+
+/**
+ * glyr_get_async:
+ * @settings: The setting struct controlling glyr, like for glyr_get()
+ *
+ * Start @settings without blocking, e.g. from a GUI mainloop.
+ * Watch glyr_async_get_fd() for readability, then call glyr_async_step() and glyr_async_collect().
+ * 
+ * <note>
+ * <para>
+ * The query runs in a thread of its own, so a callback set via glyr_opt_dlcallback() is called from there.
+ * Don't touch @settings until glyr_async_free() was called.
+ * </para>
+ * </note>
+ *
+ * Returns: a handle to pass to glyr_async_free() at the end, or %NULL on error.
+ */
+GlyrAsync * glyr_get_async(GlyrQuery * settings);
+
+/**
+ * glyr_async_get_fd:
+ * @async: A handle of glyr_get_async()
+ *
+ * The returned filedescriptor becomes readable once new items were found, or the query is done.
+ * Do not read from or close it yourself, use glyr_async_step().
+ *
+ * Returns: a filedescriptor suitable for poll() or select(), or -1
+ */
+int glyr_async_get_fd(GlyrAsync * async);
+
+/**
+ * glyr_async_step:
+ * @async: A handle of glyr_get_async()
+ *
+ * Call this once the filedescriptor got readable. Never blocks.
+ *
+ * Returns: true if the query is done, i.e. nothing new will be found.
+ */
+bool glyr_async_step(GlyrAsync * async);
+
+/**
+ * glyr_async_collect:
+ * @async: A handle of glyr_get_async()
+ * @length: An optional pointer storing the length of the returned list, or %NULL
+ *
+ * Take all items found since the last call. Never blocks.
+ *
+ * Returns: a doubly linked list of #GlyrMemCache you need to free with glyr_free_list(), or %NULL if nothing new was found.
+ */
+GlyrMemCache * glyr_async_collect(GlyrAsync * async, int * length);
+
+/**
+ * glyr_async_get_error:
+ * @async: A handle of glyr_get_async()
+ *
+ * Returns: the error glyr_get() reported, GLYRE_OK as long as the query runs
+ */
+GLYR_ERROR glyr_async_get_error(GlyrAsync * async);
+
+/**
+ * glyr_async_free:
+ * @async: A handle of glyr_get_async()
+ *
+ * Stop the query if it's still running, wait for it, and free @async along with all items not collected.
+ * The query passed to glyr_get_async() can be used or destroyed afterwards.
+ */
+void glyr_async_free(GlyrAsync * async);
+
 /**
  * glyr_query_init:
  * @query: The GlyrQuery to initialize to defaultsettings.
@@ -299,6 +544,32 @@ void glyr_cache_print(GlyrMemCache * cache);
 */
 GLYR_ERROR glyr_opt_dlcallback(GlyrQuery * settings, DL_callback dl_cb, void * userp);
 
+/**
+* glyr_opt_trace_callback:
+* @settings: The GlyrQuery settings struct to store this option in.
+* @trace_cb: The callback to register, or NULL to disable tracing.
+* @userp: A pointer to a custom variable you can access inside the callback via <structfield>s->trace.user_pointer</structfield>
+*
+* The callback should have the following form:
+* <informalexample>
+* <programlisting>
+* void my_tracer(const GlyrTraceSpan * span, struct GlyrQuery * s);
+* </programlisting>
+* </informalexample>
+*
+* It is called once a step of glyr_get() is done: every download with its network phases 
+* (name lookup, connect, TLS, waiting for the answer and the transfer, as measured by libcurl),
+* the parser of each provider and the time it spent in fuzzy string comparisons, 
+* the format checks of image URLs, the database lookups and inserts, merging the results and the query as a whole.
+* See #GLYR_TRACE_PHASE. All timestamps are taken from the same monotonic clock.
+*
+* Calls are never made concurrently, but they may come from glyr's worker threads;
+* keep the callback short, since the query waits for it.
+*
+* Returns: an error ID
+*/
+GLYR_ERROR glyr_opt_trace_callback(GlyrQuery * settings, GlyrTraceCallback trace_cb, void * userp);
+
 /**
 * glyr_opt_type:
 * @s: The GlyrQuery settings struct to store this option in.
@@ -430,7 +701,8 @@ GLYR_ERROR glyr_opt_title(GlyrQuery * s,  char * title);
 *
 * <note>
 * <para>
-* This is only taken as a hint, returned images are not necessarily higher than this size, but should be around it.
+* This is only taken as a hint by the providers. If glyr_opt_download() is true, downloads of JPEG, PNG and GIF images 
+* that are smaller are cancelled as soon as their header is there. The mean of width and height is compared.
 * </para>
 * </note>
 * 
@@ -445,7 +717,8 @@ GLYR_ERROR glyr_opt_img_minsize(GlyrQuery * s, int size);
 *
 * <note>
 * <para>
-* This is only taken as a hint, returned images are not necessarily below this size, but should be around it.
+* This is only taken as a hint by the providers. If glyr_opt_download() is true, downloads of JPEG, PNG and GIF images 
+* that are bigger are cancelled as soon as their header is there. The mean of width and height is compared.
 * </para>
 * </note>
 * 
@@ -470,6 +743,13 @@ GLYR_ERROR glyr_opt_parallel(GlyrQuery * s, unsigned long parallel_jobs);
 * @timeout: Maximum number of seconds to wait before canceling a download.
 *
 * Default is 20 seconds
+*
+* <note>
+* <para>
+* Once a provider answered a few times, its downloads are cancelled earlier:
+* After three times the time 99% of its latest downloads took, but never later than @timeout.
+* </para>
+* </note>
 * 
 * Returns: an error ID
 */
@@ -525,6 +805,55 @@ GLYR_ERROR glyr_opt_lang(GlyrQuery * s, char * langcode);
 */
 GLYR_ERROR glyr_opt_lang_aware_only(GlyrQuery * s, bool lang_aware_only);
 
+/**
+* glyr_opt_sniff_formats:
+* @s: The GlyrQuery settings struct to store this option in.
+* @sniff_formats: Boolean, set to true to check the imageformat on the download itself.
+*
+* By default libglyr asks the server for the Content-Type of every image before downloading it,
+* to filter the formats given by glyr_opt_allowed_formats().
+* If this is set to true (and glyr_opt_download() is true too), this extra request is skipped;
+* instead the format is guessed by the first bytes of the actual download, which is cancelled 
+* right away if the format is not allowed.
+* This halves the number of requests for image-getters.
+*
+* Returns: an error ID
+*/
+GLYR_ERROR glyr_opt_sniff_formats(GlyrQuery * s, bool sniff_formats);
+
+/**
+* glyr_opt_hedge:
+* @s: The GlyrQuery settings struct to store this option in.
+* @hedge: Boolean, set to true to start the next provider early if one is slow.
+*
+* Normally the next provider is only asked once one of the glyr_opt_parallel() running providers is done,
+* so if all of them hang you wait for their full timeout.
+* With this set to true, the next best provider is started right away if a download brought 
+* no new item within the time 95% of the downloads of its provider took so far (a quarter of glyr_opt_timeout(), if unknown).
+* All remaining downloads are cancelled as soon as glyr_opt_number() items are there.
+*
+* Default is false.
+*
+* Returns: an error ID
+*/
+GLYR_ERROR glyr_opt_hedge(GlyrQuery * s, bool hedge);
+
+/**
+* glyr_opt_deadline:
+* @s: The GlyrQuery settings struct to store this option in.
+* @ms: The time glyr_get() may take at most in milliseconds, 0 for no limit.
+*
+* glyr_opt_timeout() only limits single downloads, so a query asking many providers may take much longer.
+* With a deadline, all downloads, format checks and retries of one glyr_get() share this amount of time;
+* once it's over, the remaining downloads are cancelled and the items found until then are returned.
+* In this case glyr_get() sets its error to GLYRE_DEADLINE, even if there are results.
+*
+* Default is 0.
+*
+* Returns: an error ID
+*/
+GLYR_ERROR glyr_opt_deadline(GlyrQuery * s, int ms);
+
 /**
 * glyr_opt_number:
 * @s: The GlyrQuery settings struct to store this option in.
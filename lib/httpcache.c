@@ -0,0 +1,430 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <string.h>
+#include <sqlite3.h>
+
+#include "httpcache.h"
+#include "core.h"
+
+/* Wait this many ms if another process holds the lock */
+#define HTTPCACHE_BUSY_WAIT 5000
+
+/* A single response may not take more than 1/n of the cache */
+#define HTTPCACHE_MAX_ENTRY_FRACTION 4
+
+/* Number of rows deleted at once while evicting */
+#define HTTPCACHE_EVICT_BATCH 16
+
+/*-----------------------------------------------------------------*/
+
+static const char * table_def = 
+    "PRAGMA synchronous = 1;                                            \n"
+    "PRAGMA temp_store = 2;                                             \n"
+    "CREATE TABLE IF NOT EXISTS responses(                              \n"
+    "    url           TEXT PRIMARY KEY,                                \n"
+    "    etag          TEXT,                                            \n"
+    "    last_modified TEXT,                                            \n"
+    "    expires       INTEGER,                                         \n"
+    "    last_used     INTEGER,                                         \n"
+    "    size          INTEGER,                                         \n"
+    "    body          BLOB                                             \n"
+    ");                                                                 \n"
+    "CREATE INDEX IF NOT EXISTS index_last_used ON responses(last_used);\n";
+
+static sqlite3 * cache_db = NULL;
+static gsize cache_max_size = 0;
+static gint cache_default_ttl = 0;
+
+/* Queries may run in several threads */
+static GStaticMutex cache_lock = G_STATIC_MUTEX_INIT;
+
+/*-----------------------------------------------------------------*/
+
+static gint64 now_seconds(void)
+{
+    return g_get_real_time() / G_USEC_PER_SEC;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Explicit hints of the server win, otherwise use the default_ttl */
+static gint64 compute_expires(HttpCacheMeta * meta, gint64 now)
+{
+    if(meta->no_cache)
+        return now;
+
+    if(meta->max_age_expires > 0)
+        return meta->max_age_expires;
+
+    if(meta->header_expires > 0)
+        return meta->header_expires;
+
+    return now + cache_default_ttl;
+}
+
+/*-----------------------------------------------------------------*/
+
+static void close_db(void)
+{
+    if(cache_db != NULL)
+    {
+        if(sqlite3_close(cache_db) != SQLITE_OK)
+        {
+            glyr_message(-1,NULL,"Closing HTTP cache failed: %s\n",sqlite3_errmsg(cache_db));
+        }
+        cache_db = NULL;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+gboolean httpcache_open(const gchar * path, gsize max_size, gint default_ttl)
+{
+    gboolean result = FALSE;
+    if(path == NULL || g_file_test(path,G_FILE_TEST_IS_DIR) == FALSE)
+    {
+        glyr_message(-1,NULL,"Warning: %s is not a directory; Creating HTTP cache failed.\n",path);
+        return FALSE;
+    }
+
+    g_static_mutex_lock(&cache_lock);
+    close_db();
+
+    gchar * db_file_path = g_build_filename(path,GLYR_HTTP_CACHE_FILENAME,NULL);
+    if(sqlite3_open_v2(db_file_path,&cache_db,
+                SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+                NULL) == SQLITE_OK)
+    {
+        char * err_msg = NULL;
+        sqlite3_busy_timeout(cache_db,HTTPCACHE_BUSY_WAIT);
+        if(sqlite3_exec(cache_db,table_def,NULL,NULL,&err_msg) == SQLITE_OK)
+        {
+            cache_max_size = max_size;
+            cache_default_ttl = default_ttl;
+            result = TRUE;
+        }
+        else
+        {
+            glyr_message(-1,NULL,"Creating HTTP cache failed: %s\n",err_msg);
+            sqlite3_free(err_msg);
+            close_db();
+        }
+    }
+    else
+    {
+        glyr_message(-1,NULL,"Opening HTTP cache failed: %s\n",sqlite3_errmsg(cache_db));
+        sqlite3_close(cache_db);
+        cache_db = NULL;
+    }
+
+    g_free(db_file_path);
+    g_static_mutex_unlock(&cache_lock);
+    return result;
+}
+
+/*-----------------------------------------------------------------*/
+
+void httpcache_close(void)
+{
+    g_static_mutex_lock(&cache_lock);
+    close_db();
+    g_static_mutex_unlock(&cache_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+gboolean httpcache_is_enabled(void)
+{
+    g_static_mutex_lock(&cache_lock);
+    gboolean result = (cache_db != NULL);
+    g_static_mutex_unlock(&cache_lock);
+    return result;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Mark url as recently used; cache_lock must be held */
+static void touch_entry(const gchar * url, gint64 now)
+{
+    sqlite3_stmt * stmt = NULL;
+    if(sqlite3_prepare_v2(cache_db,"UPDATE responses SET last_used = ? WHERE url = ?;",-1,&stmt,NULL) == SQLITE_OK)
+    {
+        sqlite3_bind_int64(stmt,1,now);
+        sqlite3_bind_text(stmt,2,url,-1,SQLITE_STATIC);
+        sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+}
+
+/*-----------------------------------------------------------------*/
+
+static struct curl_slist * append_validator(struct curl_slist * list, const gchar * name, const gchar * value)
+{
+    if(value != NULL)
+    {
+        gchar * header = g_strdup_printf("%s: %s",name,value);
+        list = curl_slist_append(list,header);
+        g_free(header);
+    }
+    return list;
+}
+
+/*-----------------------------------------------------------------*/
+
+GlyrMemCache * httpcache_lookup(const gchar * url, gboolean * fresh, struct curl_slist ** validators)
+{
+    GlyrMemCache * result = NULL;
+    *fresh = FALSE;
+    *validators = NULL;
+
+    if(url == NULL)
+        return NULL;
+
+    g_static_mutex_lock(&cache_lock);
+    if(cache_db != NULL)
+    {
+        sqlite3_stmt * stmt = NULL;
+        if(sqlite3_prepare_v2(cache_db,"SELECT etag,last_modified,expires,body FROM responses WHERE url = ?;",-1,&stmt,NULL) == SQLITE_OK)
+        {
+            sqlite3_bind_text(stmt,1,url,-1,SQLITE_STATIC);
+            if(sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                gint64 now = now_seconds();
+                *fresh = (now < sqlite3_column_int64(stmt,2));
+                if(*fresh == FALSE)
+                {
+                    *validators = append_validator(*validators,"If-None-Match",(const gchar*)sqlite3_column_text(stmt,0));
+                    *validators = append_validator(*validators,"If-Modified-Since",(const gchar*)sqlite3_column_text(stmt,1));
+                }
+
+                /* Stale, and no way to ask if it's still valid: useless */
+                if(*fresh == TRUE || *validators != NULL)
+                {
+                    const void * blob = sqlite3_column_blob(stmt,3);
+                    gint size = sqlite3_column_bytes(stmt,3);
+
+                    /* Remember NUL for strings */
+                    gchar * data = g_malloc(size + 1);
+                    memcpy(data,blob,size);
+                    data[size] = 0;
+
+                    result = DL_init();
+                    DL_set_data(result,data,size);
+                }
+            }
+            sqlite3_finalize(stmt);
+
+            if(result != NULL)
+            {
+                touch_entry(url,now_seconds());
+            }
+        }
+    }
+    g_static_mutex_unlock(&cache_lock);
+    return result;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Throw out the least recently used entries, till we fit; cache_lock must be held */
+static void evict_entries(void)
+{
+    for(;;)
+    {
+        sqlite3_stmt * stmt = NULL;
+        sqlite3_int64 total_size = 0;
+        if(sqlite3_prepare_v2(cache_db,"SELECT COALESCE(SUM(size),0) FROM responses;",-1,&stmt,NULL) == SQLITE_OK &&
+           sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            total_size = sqlite3_column_int64(stmt,0);
+        }
+        sqlite3_finalize(stmt);
+
+        if(total_size <= (sqlite3_int64)cache_max_size)
+            break;
+
+        gchar * sql = sqlite3_mprintf("DELETE FROM responses WHERE url IN "
+                                      "(SELECT url FROM responses ORDER BY last_used ASC LIMIT %d);",
+                                      HTTPCACHE_EVICT_BATCH);
+        gint rc = sqlite3_exec(cache_db,sql,NULL,NULL,NULL);
+        sqlite3_free(sql);
+
+        if(rc != SQLITE_OK || sqlite3_changes(cache_db) == 0)
+            break;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void httpcache_store(const gchar * url, GlyrMemCache * body, HttpCacheMeta * meta)
+{
+    if(url == NULL || body == NULL || body->data == NULL || meta == NULL || meta->no_store == TRUE)
+        return;
+
+    g_static_mutex_lock(&cache_lock);
+    if(cache_db != NULL && body->size <= cache_max_size / HTTPCACHE_MAX_ENTRY_FRACTION)
+    {
+        sqlite3_stmt * stmt = NULL;
+        if(sqlite3_prepare_v2(cache_db,
+                    "INSERT OR REPLACE INTO responses(url,etag,last_modified,expires,last_used,size,body) VALUES(?,?,?,?,?,?,?);",
+                    -1,&stmt,NULL) == SQLITE_OK)
+        {
+            gint64 now = now_seconds();
+            sqlite3_bind_text(stmt,1,url,-1,SQLITE_STATIC);
+            sqlite3_bind_text(stmt,2,meta->etag,-1,SQLITE_STATIC);
+            sqlite3_bind_text(stmt,3,meta->last_modified,-1,SQLITE_STATIC);
+            sqlite3_bind_int64(stmt,4,compute_expires(meta,now));
+            sqlite3_bind_int64(stmt,5,now);
+            sqlite3_bind_int64(stmt,6,body->size);
+            sqlite3_bind_blob(stmt,7,body->data,body->size,SQLITE_STATIC);
+
+            if(sqlite3_step(stmt) != SQLITE_DONE)
+            {
+                glyr_message(1,NULL,"Storing response in HTTP cache failed: %s\n",sqlite3_errmsg(cache_db));
+            }
+        }
+        sqlite3_finalize(stmt);
+        evict_entries();
+    }
+    g_static_mutex_unlock(&cache_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+void httpcache_refresh(const gchar * url, HttpCacheMeta * meta)
+{
+    if(url == NULL || meta == NULL)
+        return;
+
+    g_static_mutex_lock(&cache_lock);
+    if(cache_db != NULL)
+    {
+        sqlite3_stmt * stmt = NULL;
+        if(sqlite3_prepare_v2(cache_db,
+                    "UPDATE responses SET expires = ?, last_used = ?, "
+                    "etag = COALESCE(?,etag), last_modified = COALESCE(?,last_modified) "
+                    "WHERE url = ?;",
+                    -1,&stmt,NULL) == SQLITE_OK)
+        {
+            gint64 now = now_seconds();
+            sqlite3_bind_int64(stmt,1,compute_expires(meta,now));
+            sqlite3_bind_int64(stmt,2,now);
+            sqlite3_bind_text(stmt,3,meta->etag,-1,SQLITE_STATIC);
+            sqlite3_bind_text(stmt,4,meta->last_modified,-1,SQLITE_STATIC);
+            sqlite3_bind_text(stmt,5,url,-1,SQLITE_STATIC);
+            sqlite3_step(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
+    g_static_mutex_unlock(&cache_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+static void parse_cache_control(HttpCacheMeta * meta, const gchar * value)
+{
+    gchar ** directives = g_strsplit(value,",",0);
+    for(gint i = 0; directives[i] != NULL; i++)
+    {
+        gchar * directive = g_strstrip(directives[i]);
+        if(g_ascii_strcasecmp(directive,"no-store") == 0)
+        {
+            meta->no_store = TRUE;
+        }
+        else if(g_ascii_strcasecmp(directive,"no-cache") == 0)
+        {
+            meta->no_cache = TRUE;
+        }
+        else if(g_ascii_strncasecmp(directive,"max-age=",8) == 0)
+        {
+            gint64 max_age = g_ascii_strtoll(directive + 8,NULL,10);
+            if(max_age > 0)
+                meta->max_age_expires = now_seconds() + max_age;
+            else
+                meta->no_cache = TRUE;
+        }
+    }
+    g_strfreev(directives);
+}
+
+/*-----------------------------------------------------------------*/
+
+size_t httpcache_header_cb(char * buffer, size_t size, size_t nitems, void * userdata)
+{
+    size_t realsize = size * nitems;
+    HttpCacheMeta * meta = userdata;
+    if(meta != NULL && buffer != NULL)
+    {
+        gchar * line = g_strstrip(g_strndup(buffer,realsize));
+
+        /* Headers of a new response (after a redirect), forget the old ones */
+        if(g_ascii_strncasecmp(line,"HTTP/",5) == 0)
+        {
+            httpcache_meta_clear(meta);
+        }
+        else
+        {
+            gchar * value = strchr(line,':');
+            if(value != NULL)
+            {
+                *value++ = 0;
+                value = g_strstrip(value);
+                g_strstrip(line);
+
+                if(g_ascii_strcasecmp(line,"ETag") == 0)
+                {
+                    g_free(meta->etag);
+                    meta->etag = g_strdup(value);
+                }
+                else if(g_ascii_strcasecmp(line,"Last-Modified") == 0)
+                {
+                    g_free(meta->last_modified);
+                    meta->last_modified = g_strdup(value);
+                }
+                else if(g_ascii_strcasecmp(line,"Expires") == 0)
+                {
+                    time_t expires = curl_getdate(value,NULL);
+                    meta->header_expires = (expires > 0) ? expires : 0;
+                }
+                else if(g_ascii_strcasecmp(line,"Cache-Control") == 0)
+                {
+                    parse_cache_control(meta,value);
+                }
+            }
+        }
+        g_free(line);
+    }
+    return realsize;
+}
+
+/*-----------------------------------------------------------------*/
+
+void httpcache_meta_clear(HttpCacheMeta * meta)
+{
+    if(meta != NULL)
+    {
+        g_free(meta->etag);
+        g_free(meta->last_modified);
+        memset(meta,0,sizeof(HttpCacheMeta));
+    }
+}
+
+/*-----------------------------------------------------------------*/
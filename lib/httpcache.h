@@ -0,0 +1,62 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_HTTPCACHE_H
+#define GLYR_HTTPCACHE_H
+
+#include <glib.h>
+#include <curl/curl.h>
+#include "types.h"
+
+/* What a response told us about caching it.
+ * Filled by httpcache_header_cb(), zero-initialize before use.
+ */
+typedef struct {
+    gchar * etag;
+    gchar * last_modified;
+    gint64 max_age_expires; /* now + max-age, 0 if not given */
+    gint64 header_expires;  /* Expires:, 0 if not given      */
+    gboolean no_store;
+    gboolean no_cache;
+} HttpCacheMeta;
+
+/* Process wide cache of raw responses (not of the final items, see cache.h)
+ * Opens or creates it in the directory path, a previously opened one is closed.
+ * max_size is in bytes, default_ttl is used if the server gives no hint.
+ */
+gboolean httpcache_open(const gchar * path, gsize max_size, gint default_ttl);
+void httpcache_close(void);
+gboolean httpcache_is_enabled(void);
+
+/* Look up the body stored for url, NULL if none (or it's useless).
+ * If *fresh is FALSE afterwards it needs to be revalidated by sending 
+ * the headers in *validators (free with curl_slist_free_all())
+ */
+GlyrMemCache * httpcache_lookup(const gchar * url, gboolean * fresh, struct curl_slist ** validators);
+
+/* Store a complete response, or just update its freshness after a 304 */
+void httpcache_store(const gchar * url, GlyrMemCache * body, HttpCacheMeta * meta);
+void httpcache_refresh(const gchar * url, HttpCacheMeta * meta);
+
+/* CURLOPT_HEADERFUNCTION, pass a HttpCacheMeta as CURLOPT_HEADERDATA */
+size_t httpcache_header_cb(char * buffer, size_t size, size_t nitems, void * userdata);
+void httpcache_meta_clear(HttpCacheMeta * meta);
+
+#endif
@@ -0,0 +1,195 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <string.h>
+#include "imgprobe.h"
+
+/*-----------------------------------------------------------------*/
+
+static const struct {
+    const gchar * format;
+    const gchar * magic;
+    gsize magic_len;
+} magic_table[] = {
+    {"jpeg", "\xFF\xD8\xFF",                      3},
+    {"png",  "\x89PNG\r\n\x1A\n",                 8},
+    {"gif",  "GIF87a",                            6},
+    {"gif",  "GIF89a",                            6},
+    {"tiff", "II*\x00",                           4},
+    {"tiff", "MM\x00*",                           4}
+};
+
+/*-----------------------------------------------------------------*/
+
+const gchar * imgprobe_sniff_format(const guchar * data, gsize len)
+{
+    if(data != NULL)
+    {
+        for(gsize i = 0; i < G_N_ELEMENTS(magic_table); i++)
+        {
+            if(len >= magic_table[i].magic_len &&
+               memcmp(data,magic_table[i].magic,magic_table[i].magic_len) == 0)
+            {
+                return magic_table[i].format;
+            }
+        }
+    }
+    return NULL;
+}
+
+/*-----------------------------------------------------------------*/
+
+#define READ_BE16(P) (((P)[0] << 8) | (P)[1])
+#define READ_LE16(P) (((P)[1] << 8) | (P)[0])
+#define READ_BE32(P) (((guint32)(P)[0] << 24) | ((P)[1] << 16) | ((P)[2] << 8) | (P)[3])
+
+/*-----------------------------------------------------------------*/
+
+/* Walk the segments till the first SOFn marker.
+ * Those may come after a quite large EXIF segment (thumbnails), sadly.
+ */
+static ImgProbeResult probe_jpeg(const guchar * data, gsize len, gint * width, gint * height)
+{
+    /* Skip the SOI */
+    gsize pos = 2;
+    for(;;)
+    {
+        /* Any number of 0xFF may be used as padding */
+        while(pos + 1 < len && data[pos] == 0xFF && data[pos+1] == 0xFF)
+        {
+            pos++;
+        }
+
+        /* Marker and segment length */
+        if(pos + 4 > len)
+        {
+            return IMGPROBE_NEED_MORE;
+        }
+
+        if(data[pos] != 0xFF)
+        {
+            return IMGPROBE_UNKNOWN;
+        }
+
+        guchar marker = data[pos+1];
+
+        /* Standalone markers (TEM, RSTn) have no length */
+        if(marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+        {
+            pos += 2;
+            continue;
+        }
+
+        /* EOI or SOS without any SOF before */
+        if(marker == 0xD9 || marker == 0xDA)
+        {
+            return IMGPROBE_UNKNOWN;
+        }
+
+        /* SOF0-SOF15, except DHT, JPG and DAC */
+        if(marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+        {
+            if(pos + 9 > len)
+            {
+                return IMGPROBE_NEED_MORE;
+            }
+
+            *height = READ_BE16(data + pos + 5);
+            *width  = READ_BE16(data + pos + 7);
+            return IMGPROBE_FOUND;
+        }
+
+        gsize segment_len = READ_BE16(data + pos + 2);
+        if(segment_len < 2)
+        {
+            return IMGPROBE_UNKNOWN;
+        }
+        pos += 2 + segment_len;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+/* IHDR is always the first chunk */
+static ImgProbeResult probe_png(const guchar * data, gsize len, gint * width, gint * height)
+{
+    if(len < 24)
+    {
+        return IMGPROBE_NEED_MORE;
+    }
+
+    if(memcmp(data + 12,"IHDR",4) != 0)
+    {
+        return IMGPROBE_UNKNOWN;
+    }
+
+    *width  = (gint)READ_BE32(data + 16);
+    *height = (gint)READ_BE32(data + 20);
+    return IMGPROBE_FOUND;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Logical screen size, right after the signature */
+static ImgProbeResult probe_gif(const guchar * data, gsize len, gint * width, gint * height)
+{
+    if(len < 10)
+    {
+        return IMGPROBE_NEED_MORE;
+    }
+
+    *width  = READ_LE16(data + 6);
+    *height = READ_LE16(data + 8);
+    return IMGPROBE_FOUND;
+}
+
+/*-----------------------------------------------------------------*/
+
+ImgProbeResult imgprobe_get_dimensions(const guchar * data, gsize len, gint * width, gint * height)
+{
+    if(data == NULL || width == NULL || height == NULL)
+    {
+        return IMGPROBE_UNKNOWN;
+    }
+
+    if(len < IMGPROBE_MAGIC_LEN)
+    {
+        return IMGPROBE_NEED_MORE;
+    }
+
+    const gchar * format = imgprobe_sniff_format(data,len);
+    if(g_strcmp0(format,"jpeg") == 0)
+    {
+        return probe_jpeg(data,len,width,height);
+    }
+    else if(g_strcmp0(format,"png") == 0)
+    {
+        return probe_png(data,len,width,height);
+    }
+    else if(g_strcmp0(format,"gif") == 0)
+    {
+        return probe_gif(data,len,width,height);
+    }
+
+    /* TIFF keeps its size somewhere in an IFD - not worth it */
+    return IMGPROBE_UNKNOWN;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,46 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_IMGPROBE_H
+#define GLYR_IMGPROBE_H
+
+#include <glib.h>
+
+/* Bytes needed to tell all known formats apart */
+#define IMGPROBE_MAGIC_LEN 8
+
+/* Guess the imageformat by the first bytes of the data.
+ * Returns a static string in the same notation as the MIME subtype
+ * ("jpeg","png","gif","tiff"), or NULL if unknown or len is too small.
+ */
+const gchar * imgprobe_sniff_format(const guchar * data, gsize len);
+
+typedef enum {
+    IMGPROBE_NEED_MORE, /* Header is not complete yet         */
+    IMGPROBE_FOUND,     /* width and height were filled       */
+    IMGPROBE_UNKNOWN    /* Unknown format or broken header    */
+} ImgProbeResult;
+
+/* Read the size in pixels from the header of a JPEG, PNG or GIF.
+ * data may be incomplete, call again with more data on IMGPROBE_NEED_MORE.
+ */
+ImgProbeResult imgprobe_get_dimensions(const guchar * data, gsize len, gint * width, gint * height);
+
+#endif
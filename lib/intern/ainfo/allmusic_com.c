@@ -47,13 +47,25 @@ static GlyrMemCache * parse_bio_page(GlyrMemCache * to_parse, gchar * url)
 
 /*-------------------------------------*/
 
+static GList * parse_followed_bio_page(cb_object * capo, gpointer userdata)
+{
+	GList * result_list = NULL;
+	GlyrMemCache * result = parse_bio_page(capo->cache,capo->url);
+	if(result != NULL)
+	{
+		result_list = g_list_prepend(result_list,result);
+	}
+	return result_list;
+}
+
+/*-------------------------------------*/
+
 #define ROOT "<div id=\"tabs\">"
 #define ROOT_URL "http://www.allmusic.com/artist/"
 #define END_OF_ROOT "\">"
 
-static GlyrMemCache * find_long_version(GlyrQuery * s, GlyrMemCache * to_parse)
+static void find_long_version(cb_object * capo, GlyrMemCache * to_parse)
 {
-	GlyrMemCache * result = NULL;
 	gchar * root = strstr(to_parse->data,ROOT);
 	if(root != NULL)
 	{
@@ -63,18 +75,12 @@ static GlyrMemCache * find_long_version(GlyrQuery * s, GlyrMemCache * to_parse)
 			char * url = g_strdup_printf(ROOT_URL"%s",url_id);
 			if(url != NULL)
 			{
-				GlyrMemCache * dl = download_single(url,s,NULL);
-				if(dl != NULL)
-				{
-					result = parse_bio_page(dl,url);
-					DL_free(dl);
-				}
+				fetch_followup(capo,url,NULL,parse_followed_bio_page,NULL,NULL);
 				g_free(url);
 			}
 			g_free(url_id);
 		}
 	}
-	return result;
 }
 
 /*-------------------------------------*/
@@ -105,17 +111,13 @@ static gboolean approve_content(GlyrQuery * query, gchar * ref)
 
 static GList * ainfo_allmusic_parse(cb_object * capo)
 {
-	GList * result_list = NULL;
+	gint scheduled = 0;
 
 	/* Are we already on the biopage? */
 	if(strstr(capo->cache->data, "<!--Begin Biography -->"))
 	{
-		GlyrMemCache * info_long = find_long_version(capo->s,capo->cache);
-		if(info_long != NULL)
-		{
-			result_list = g_list_prepend(result_list,info_long);
-		}
-		return result_list;
+		find_long_version(capo,capo->cache);
+		return NULL;
 	}
 
 	gchar * search_begin = NULL;
@@ -128,7 +130,7 @@ static GList * ainfo_allmusic_parse(cb_object * capo)
 
 	gsize nodelen = (sizeof SEARCH_NODE) - 1;
 	gchar * node  = search_begin;
-	while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + nodelen,SEARCH_NODE)))
+	while(continue_search(scheduled,capo->s) && (node = strstr(node + nodelen,SEARCH_NODE)))
 	{
 		gchar * end_of_url = strstr(node,SEARCH_DELIM);
 		if(approve_content(capo->s,end_of_url) == TRUE)
@@ -137,22 +139,16 @@ static GList * ainfo_allmusic_parse(cb_object * capo)
 			if(url != NULL)
 			{
 				gchar * biography_url = g_strdup_printf("%s/biography",url);
-				GlyrMemCache * dl_cache = download_single(biography_url,capo->s,NULL);
-				if(dl_cache != NULL)
+				if(fetch_followup(capo,biography_url,NULL,parse_followed_bio_page,NULL,NULL))
 				{
-					GlyrMemCache * content = parse_bio_page(dl_cache,biography_url);
-					if(content != NULL)
-					{
-						result_list = g_list_prepend(result_list,content);
-					}
-					DL_free(dl_cache);
+					scheduled++;
 				}
 				g_free(biography_url);
 				g_free(url);
 			}
 		}
 	}
-	return result_list;
+	return NULL;
 }
 
 /*-------------------------------------*/
@@ -21,6 +21,10 @@
 #include "musicbrainz.h"
 #include "../../stringlib.h"
 #include "../../core.h"
+#include "../../mbidcache.h"
+
+/* The info page of an entity, with include */
+#define INFO_PAGE_URL "http://musicbrainz.org/ws/1/%s/%s?type=xml&inc=%s"
 
 /*--------------------------------------------------------*/
 
@@ -48,12 +52,40 @@ gint please_what_type(GlyrQuery * s)
 
 /*--------------------------------------------------------*/
 
-const gchar * generic_musicbrainz_url(GlyrQuery * sets)
+/* What please_what_type() is called by musicbrainz */
+static const gchar * get_entity(GlyrQuery * s)
+{
+    switch(please_what_type(s))
+    {
+        case GLYR_TYPE_TAG_TITLE:
+            return "track";
+        case GLYR_TYPE_TAG_ALBUM:
+            return "release";
+        case GLYR_TYPE_TAG_ARTIST:
+            return "artist";
+        default:
+            return NULL;
+    }
+}
+
+/*--------------------------------------------------------*/
+
+/* The search for the mbid, or its info page right away if it's known already */
+const gchar * generic_musicbrainz_url(GlyrQuery * sets, const gchar * include)
 {
     const gchar * wrap_a = sets->artist ? "${artist}" : "";
     const gchar * wrap_b = sets->album  ? "${album}"  : "";
     const gchar * wrap_t = sets->title  ? "${title}"  : "";
 
+    const gchar * entity = get_entity(sets);
+    gchar * mbid = mbidcache_lookup(sets,entity);
+    if(mbid != NULL)
+    {
+        gchar * info_page_url = g_strdup_printf(KNOWN_PAGE_MARK INFO_PAGE_URL,entity,mbid,include);
+        g_free(mbid);
+        return info_page_url;
+    }
+
     switch(please_what_type(sets))
     {
         case GLYR_TYPE_TAG_TITLE :
@@ -135,39 +167,55 @@ const gchar * get_mbid_from_xml(GlyrQuery * s, GlyrMemCache * c, gint * offset)
 
 /*--------------------------------------------------------*/
 
-/* Returns only a parseable memcache */
-GlyrMemCache * generic_musicbrainz_parse(cb_object * capo, gint * last_mbid, const gchar * include)
+/* Schedules the info page of every matching mbid.
+ * continuation is called with each of them.
+ * If capo is the info page already (see generic_musicbrainz_url()), 
+ * this returns what continuation returned for it */
+GList * generic_musicbrainz_parse(cb_object * capo, const gchar * include, FollowupCB continuation)
 {
-    gsize offset = 0;
+    if(capo->known_page == TRUE)
+    {
+        return continuation(capo,NULL);
+    }
+
+    gint last_mbid = 0;
+    gint scheduled = 0;
+    gint candidates = 0;
+    gchar * first_mbid = NULL;
     const gchar * mbid = NULL;
-    GlyrMemCache * info = NULL;
+    const gchar * type = get_entity(capo->s);
 
-    while(offset < capo->cache->size && info==NULL && (mbid = get_mbid_from_xml(capo->s,capo->cache,last_mbid)))
+    while(continue_search(scheduled,capo->s) && (mbid = get_mbid_from_xml(capo->s,capo->cache,&last_mbid)))
     {
-        if(mbid != NULL)
+        if(candidates++ == 0)
         {
-            const gchar * type = NULL;
-            switch(please_what_type(capo->s))
-            {
-                case GLYR_TYPE_TAG_TITLE:
-                    type = "track";
-                    break;
-                case GLYR_TYPE_TAG_ALBUM:
-                    type = "release";
-                    break;
-                case GLYR_TYPE_TAG_ARTIST:
-                    type = "artist";
-                    break;
-            }
+            first_mbid = g_strdup(mbid);
+        }
 
-            gchar * info_page_url = g_strdup_printf("http://musicbrainz.org/ws/1/%s/%s?type=xml&inc=%s",type,mbid,include);
-            if(info_page_url)
+        gchar * info_page_url = g_strdup_printf(INFO_PAGE_URL,type,mbid,include);
+        if(info_page_url)
+        {
+            if(fetch_followup(capo,info_page_url,NULL,continuation,NULL,NULL))
             {
-                info = download_single(info_page_url,capo->s,NULL);
-                g_free(info_page_url);
+                scheduled++;
             }
-            g_free((gchar*)mbid);
+            g_free(info_page_url);
+        }
+        g_free((gchar*)mbid);
+    }
+
+    /* Only an unambiguous match may be remembered, 
+     * since the cached ID replaces the whole search next time */
+    if(candidates == 1)
+    {
+        /* mbid is NULL if all of them were looked at already */
+        const gchar * another = (mbid != NULL) ? get_mbid_from_xml(capo->s,capo->cache,&last_mbid) : NULL;
+        if(another == NULL)
+        {
+            mbidcache_store(capo->s,type,first_mbid);
         }
+        g_free((gchar*)another);
     }
-    return info;
+    g_free(first_mbid);
+    return NULL;
 }
@@ -47,26 +47,27 @@ const gchar * generic_picsearch_url(GlyrQuery * s, const char * fmt)
 #define IMG_HOOK_BEGIN "<a rel=\"nofollow\" href=\""
 #define IMG_HOOK_ENDIN "\"><img src=\""
 
-static GlyrMemCache * parse_details_page(GlyrMemCache * to_parse)
+static GList * parse_details_page(cb_object * capo, gpointer userdata)
 {
-	GlyrMemCache * result = NULL;
+	GList * result_list = NULL;
+	GlyrMemCache * to_parse = capo->cache;
 	if(to_parse != NULL)
 	{
         char * start = strstr(to_parse->data,IMG_HOOK);
         if(start != NULL)
         {
             char * img_url = get_search_value(start,IMG_HOOK_BEGIN,IMG_HOOK_ENDIN);
-            puts(img_url);
             if(img_url != NULL)
             {
-                result = DL_init();
+                GlyrMemCache * result = DL_init();
                 result->data = img_url;
                 result->size = strlen(img_url);
                 result->dsrc = g_strdup(to_parse->dsrc);
+                result_list = g_list_prepend(result_list,result);
             }
         }
     }
-    return result;
+    return result_list;
 }
 
 /* ------------------------- */
@@ -76,8 +77,6 @@ static GlyrMemCache * parse_details_page(GlyrMemCache * to_parse)
 
 GList * generic_picsearch_parse(cb_object * capo)
 {
-    GList * result_list = NULL;
-
     gchar * node = capo->cache->data;
     gint nodelen = (sizeof NODE) - 1;
 
@@ -97,21 +96,14 @@ GList * generic_picsearch_parse(cb_object * capo)
             gchar * full_url = g_strdup_printf("www.picsearch.com%s",details_url);
             if(full_url != NULL)
             {
-                GlyrMemCache * to_parse = download_single(full_url,capo->s,NULL);
-                if(to_parse != NULL)
+                if(fetch_followup(capo,full_url,NULL,parse_details_page,NULL,NULL))
                 {
-                    GlyrMemCache * result = parse_details_page(to_parse);
-                    if(result != NULL)
-                    {
-                        result_list = g_list_prepend(result_list,result);
-                        items++;
-                    }
-                    DL_free(to_parse);
+                    items++;
                 }
                 g_free(full_url);
             }
             g_free(details_url);
         }
     }
-    return result_list;
+    return NULL;
 }
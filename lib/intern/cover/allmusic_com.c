@@ -71,6 +71,20 @@ static GlyrMemCache * parse_cover_page(GlyrMemCache * dl_cache)
 
 /*--------------------------------------*/
 
+static GList * parse_followed_cover_page(cb_object * capo, gpointer userdata)
+{
+	GList * result_list = NULL;
+	GlyrMemCache * result = parse_cover_page(capo->cache);
+	if(result != NULL && result->data)
+	{
+		result->dsrc = g_strdup(capo->url);
+		result_list = g_list_prepend(result_list,result);
+	}
+	return result_list;
+}
+
+/*--------------------------------------*/
+
 #define TITLE_TAG "<a href=\"\">Title</a></th>"
 static GList * cover_allmusic_parse(cb_object * capo)
 {
@@ -92,7 +106,8 @@ static GList * cover_allmusic_parse(cb_object * capo)
 
 	gsize nodelen = (sizeof SEARCH_NODE) - 1;
 	gchar *  node = search_begin;
-	while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + nodelen,SEARCH_NODE)))
+	gint scheduled = 0;
+	while(continue_search(scheduled,capo->s) && (node = strstr(node + nodelen,SEARCH_NODE)))
 	{
 		gchar * url = get_search_value(node,SEARCH_NODE,SEARCH_DELM);
 		if(url != NULL)
@@ -103,16 +118,9 @@ static GList * cover_allmusic_parse(cb_object * capo)
 			{
 				if(levenshtein_strnormcmp(capo->s,capo->s->artist,artist) <= capo->s->fuzzyness)
 				{
-					GlyrMemCache * dl_cache = download_single(url,capo->s,"<div class=\"artist\">");
-					if(dl_cache != NULL)
+					if(fetch_followup(capo,url,"<div class=\"artist\">",parse_followed_cover_page,NULL,NULL))
 					{
-						GlyrMemCache * result = parse_cover_page(dl_cache);
-						if(result != NULL && result->data)
-						{
-							result->dsrc = g_strdup(url);
-							result_list = g_list_prepend(result_list,result);
-						}
-						DL_free(dl_cache);
+						scheduled++;
 					}
 				}
 				g_free(artist);
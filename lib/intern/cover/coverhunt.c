@@ -58,13 +58,44 @@ static gboolean check_size(const char * art_root, const char *hw, cb_object * ca
 #define IMG_START "<img src=\""
 #define NODE_BEGIN "<a href=\"/go/"
 
+static GList * parse_artwork_page(cb_object * capo, gpointer userdata)
+{
+	GList * result_list = NULL;
+	gchar * artwork = strstr(capo->cache->data, "<div class=\"artwork\">");
+	if(artwork != NULL)
+	{
+		if(check_size(artwork,"height=",capo) && check_size(artwork,"width=",capo))
+		{
+			gchar * img_start = strstr(artwork,IMG_START);
+			if(img_start != NULL)
+			{
+				img_start += (sizeof IMG_START) - 1;
+				gchar * img_end = strstr(img_start,"\" ");
+				if(img_end != NULL)
+				{
+					gchar * url = copy_value(img_start,img_end);
+					if(url != NULL)
+					{
+						GlyrMemCache * shell = DL_init();
+						shell->data = url;
+						shell->size = img_end - img_start;
+						shell->dsrc = g_strdup(capo->url);
+						result_list = g_list_prepend(result_list,shell);
+					}
+				}
+			}
+		}
+	}
+	return result_list;
+}
+
 /* Take the first link we find.
  * coverhunt sadly offers  no way to check if the
  * image is really related to the query we're searching for
  */
 static GList * cover_coverhunt_parse(cb_object *capo)
 {
-	GList * result_list = NULL;
+	gint scheduled = 0;
 
 	/* navigate to start of search results */
 	gchar * table_start;
@@ -74,7 +105,7 @@ static GList * cover_coverhunt_parse(cb_object *capo)
 		return NULL;
 	}
 
-	while(continue_search(g_list_length(result_list),capo->s) && (table_start = strstr(table_start + 1,NODE_BEGIN)))
+	while(continue_search(scheduled,capo->s) && (table_start = strstr(table_start + 1,NODE_BEGIN)))
 	{
 		gchar * table_end = NULL;
 		if( (table_end = strstr(table_start,"\">")) != NULL)
@@ -85,35 +116,9 @@ static GList * cover_coverhunt_parse(cb_object *capo)
 				gchar * real_url = g_strdup_printf("http://www.coverhunt.com/go/%s",go_url);
 				if(real_url != NULL)
 				{
-					GlyrMemCache * search_buf = download_single(real_url,capo->s,"<div id=\"right\">");
-					if(search_buf != NULL)
+					if(fetch_followup(capo,real_url,"<div id=\"right\">",parse_artwork_page,NULL,NULL))
 					{
-						gchar * artwork = strstr(search_buf->data, "<div class=\"artwork\">");
-						if(artwork != NULL)
-						{
-							if(check_size(artwork,"height=",capo) && check_size(artwork,"width=",capo))
-							{
-								gchar * img_start = strstr(artwork,IMG_START);
-								if(img_start != NULL)
-								{
-									img_start += (sizeof IMG_START) - 1;
-									gchar * img_end = strstr(img_start,"\" ");
-									if(img_end != NULL)
-									{
-										gchar * url = copy_value(img_start,img_end);
-										if(url != NULL)
-										{
-											GlyrMemCache * shell = DL_init();
-											shell->data = url;
-											shell->size = img_end - img_start;
-											shell->dsrc = g_strdup(real_url);
-											result_list = g_list_prepend(result_list,shell);
-										}
-									}
-								}
-							}
-						}
-						DL_free(search_buf);
+						scheduled++;
 					}
 					g_free(real_url);
 				}
@@ -121,7 +126,7 @@ static GList * cover_coverhunt_parse(cb_object *capo)
 			}
 		}
 	}
-	return result_list;
+	return NULL;
 }
 
 /* Queued last, as long coverhunt is down */
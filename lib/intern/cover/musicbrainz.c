@@ -20,12 +20,26 @@
 
 #include "../../stringlib.h"
 #include "../../core.h"
+#include "../../mbidcache.h"
 
 /* ----------------------------------------------- */
 
+#define NODE "<release ext:score="
+#define DL_URL "http://musicbrainz.org/release/%s"
+
+/* ----------------------------------------------- */
+
+/* Go to the release page right away, if we know it */
 static const char * cover_musicbrainz_url(GlyrQuery * q)
 {
-    return "http://musicbrainz.org/ws/2/release?query=${album}&limit=10&offset=0";
+    gchar * ID = mbidcache_lookup(q,"release");
+    if(ID != NULL)
+    {
+        gchar * url = g_strdup_printf(KNOWN_PAGE_MARK DL_URL,ID);
+        g_free(ID);
+        return url;
+    }
+    return g_strdup("http://musicbrainz.org/ws/2/release?query=${album}&limit=10&offset=0");
 }
 
 /* ----------------------------------------------- */
@@ -37,9 +51,10 @@ static const char * cover_musicbrainz_url(GlyrQuery * q)
  * This is silly overall,
  * but coverartarchive.org does not seem to work fully yet.
  */
-static GlyrMemCache * parse_web_page(GlyrMemCache * page)
+static GList * parse_web_page(cb_object * capo, gpointer userdata)
 {
-    GlyrMemCache * retv = NULL;
+    GList * result_list = NULL;
+    GlyrMemCache * page = capo->cache;
     if(page && page->data)
     {
         char * begin = strstr(page->data,COVERART);
@@ -51,31 +66,35 @@ static GlyrMemCache * parse_web_page(GlyrMemCache * page)
                 char * img_url = get_search_value(amz_url,"\"","\"");
                 if(img_url != NULL)
                 {
-                    retv = DL_init();
+                    GlyrMemCache * retv = DL_init();
                     retv->dsrc = g_strdup(page->dsrc);
                     retv->data  = img_url;
                     retv->size  = strlen(img_url);
+                    result_list = g_list_prepend(result_list,retv);
                 }
             }
         }
-        DL_free(page);
     }
-    return retv;
+    return result_list;
 }
 
 /* ----------------------------------------------- */
 
-#define NODE "<release ext:score="
-#define DL_URL "http://musicbrainz.org/release/%s"
-
-/* ----------------------------------------------- */
-
 static GList * cover_musicbrainz_parse(cb_object * capo)
 {
-    GList * result_list = NULL;
+    /* Known release, see cover_musicbrainz_url() */
+    if(capo->known_page == TRUE)
+    {
+        return parse_web_page(capo,NULL);
+    }
+
+    gint scheduled = 0;
+    gint candidates = 0;
+    gchar * first_ID = NULL;
 
+    /* Go on after enough were scheduled, till it is clear if there's more than one candidate */
     char * node = capo->cache->data;
-    while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + 1,NODE)))
+    while((continue_search(scheduled,capo->s) || candidates < 2) && (node = strstr(node + 1,NODE)))
     {
         char * album  = get_search_value(node,"<title>","</title>");
         char * artist = get_search_value(node,"<name>" ,"</name>" );
@@ -84,15 +103,19 @@ static GList * cover_musicbrainz_parse(cb_object * capo)
                 levenshtein_strnormcmp(capo->s,album ,capo->s->album ) <= capo->s->fuzzyness)
         {
             char * ID = get_search_value(node,"id=\"","\">");
-            if(ID != NULL) 
+            if(ID != NULL && candidates++ == 0)
+            {
+                first_ID = g_strdup(ID);
+            }
+
+            if(ID != NULL && continue_search(scheduled,capo->s))
             {
                 char * url = g_strdup_printf(DL_URL,ID);
                 if(url != NULL)
                 {
-                    GlyrMemCache * item = parse_web_page(download_single(url,capo->s,NULL));
-                    if(item != NULL)
+                    if(fetch_followup(capo,url,NULL,parse_web_page,NULL,NULL))
                     {
-                        result_list = g_list_prepend(result_list,item);
+                        scheduled++;
                     }
                 }
                 g_free(url);
@@ -103,7 +126,15 @@ static GList * cover_musicbrainz_parse(cb_object * capo)
         g_free(album);
     }
 
-    return result_list;
+    /* Only an unambiguous match may be remembered, 
+     * since the cached ID replaces the whole search next time */
+    if(candidates == 1)
+    {
+        mbidcache_store(capo->s,"release",first_ID);
+    }
+    g_free(first_ID);
+
+    return NULL;
 }
 
 /* ----------------------------------------------- */
@@ -118,5 +149,5 @@ MetaDataSource cover_musicbrainz_src =
     .quality   = 85,
     .speed     = 70,
     .endmarker = NULL,
-    .free_url  = false
+    .free_url  = true
 };
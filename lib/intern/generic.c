@@ -102,7 +102,12 @@ static GList * async_dl_callback(cb_object * capo, void * userptr, bool * stop_d
 				if(is_in_result_list(capo->cache,saver->results) == FALSE)
 				{
 					capo->cache->prov       = (old_cache->prov!=NULL) ? g_strdup(old_cache->prov) : NULL;
-					capo->cache->img_format = (old_cache->img_format) ? g_strdup(old_cache->img_format) : NULL;
+
+					/* Might be already sniffed from the data */
+					if(capo->cache->img_format == NULL)
+					{
+						capo->cache->img_format = (old_cache->img_format) ? g_strdup(old_cache->img_format) : NULL;
+					}
 
 					if(capo->cache->type == GLYR_TYPE_NOIDEA)
 					{
@@ -183,7 +188,7 @@ GList * generic_img_finalizer(GlyrQuery * s, GList * list, gboolean * stop_me, G
 		};
 
 		/* Download images in parallel */
-		GList * dl_raw_images = async_download(url_list,NULL,s,1,(g_list_length(url_list)/2),async_dl_callback,&userptr,FALSE);
+		GList * dl_raw_images = async_download(url_list,NULL,NULL,s,1,(g_list_length(url_list)/2),async_dl_callback,NULL,NULL,&userptr,FALSE,TRUE);
 
 		/* Default to the given type */
 		for(GList * elem = dl_raw_images; elem; elem = elem->next)
@@ -60,34 +60,26 @@ static gboolean check_title_value(GlyrQuery * s, const gchar * to_check)
 
 /*--------------------------------------------------------*/
 
-static GlyrMemCache * parse_result_page(GlyrQuery * s, gchar * content_url)
+static GList * parse_result_page(cb_object * capo, gpointer userdata)
 {
-	GlyrMemCache * result = NULL;
-	if(content_url != NULL)
+	GList * result_list = NULL;
+	gchar * content = get_search_value(capo->cache->data,"<div class=\"song\">","</div>");
+	if(content != NULL)
 	{
-		GlyrMemCache * dl_cache = download_single(content_url,s,NULL);
-		if(dl_cache != NULL)
-		{
-			gchar * content = get_search_value(dl_cache->data,"<div class=\"song\">","</div>");
-			if(content != NULL)
-			{
-				result = DL_init();
-				result->data = content; 
-				result->size = strlen(content);
-				result->dsrc = g_strdup(content_url);
-			}
-			DL_free(dl_cache);
-		}
+		GlyrMemCache * result = DL_init();
+		result->data = content; 
+		result->size = strlen(content);
+		result->dsrc = g_strdup(capo->url);
+		result_list = g_list_prepend(result_list,result);
 	}
-	return result;
+	return result_list;
 }
 
-
 /*--------------------------------------------------------*/
 
 static GList * guitartabs_chordie_parse(cb_object * capo)
 {
-	GList * result_list = NULL;
+	gint scheduled = 0;
 	gchar * search_begin = strstr(capo->cache->data,RESULTS_BEGIN);
 	if(search_begin != NULL)
 	{
@@ -96,7 +88,7 @@ static GList * guitartabs_chordie_parse(cb_object * capo)
 		{
 			gchar * node  = search_begin;
 			gsize nodelen = (sizeof NODE) - 1;
-			while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + nodelen, NODE)) != NULL && node >= search_begin && node <= search_ending)
+			while(continue_search(scheduled,capo->s) && (node = strstr(node + nodelen, NODE)) != NULL && node >= search_begin && node <= search_ending)
 			{
 				gchar * url = get_search_value(node,NODE,"\" ");
 				if(url != NULL)
@@ -105,10 +97,9 @@ static GList * guitartabs_chordie_parse(cb_object * capo)
 					if(check_title_value(capo->s, name_value) == TRUE)
 					{
 						gchar * content_url = g_strdup_printf("%s%s",BASE_URL,url);
-						GlyrMemCache * result = parse_result_page(capo->s,content_url);
-						if(result != NULL)
+						if(fetch_followup(capo,content_url,NULL,parse_result_page,NULL,NULL))
 						{
-							result_list = g_list_prepend(result_list,result);
+							scheduled++;
 						}
 						g_free(content_url);
 					}
@@ -118,7 +109,7 @@ static GList * guitartabs_chordie_parse(cb_object * capo)
 			}
 		}
 	}
-	return result_list;
+	return NULL;
 }
 
 /*--------------------------------------------------------*/
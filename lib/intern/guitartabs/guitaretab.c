@@ -32,23 +32,19 @@ static const gchar * gt_guitaretabs_url(GlyrQuery * settings)
 
 /*--------------------------------------------------------*/
 
-static GlyrMemCache * parse_single_page(GlyrQuery * s, const gchar * url)
+static GList * parse_single_page(cb_object * capo, gpointer userdata)
 {
-	GlyrMemCache * result = NULL;
-	GlyrMemCache * tab_cache = download_single(url,s,NULL);
-	if(tab_cache != NULL)
+	GList * result_list = NULL;
+	gchar * content = get_search_value(capo->cache->data,"<pre>","</pre>");
+	if(content != NULL)
 	{
-		gchar * content = get_search_value(tab_cache->data,"<pre>","</pre>");
-		if(content != NULL)
-		{
-			result = DL_init();
-			result->data = content;
-			result->size = strlen(content);
-			result->dsrc = g_strdup(url);
-		}
-		DL_free(tab_cache);
+		GlyrMemCache * result = DL_init();
+		result->data = content;
+		result->size = strlen(content);
+		result->dsrc = g_strdup(capo->url);
+		result_list = g_list_prepend(result_list,result);
 	}
-	return result;
+	return result_list;
 }
 
 /*--------------------------------------------------------*/
@@ -66,7 +62,7 @@ static GlyrMemCache * parse_single_page(GlyrQuery * s, const gchar * url)
 
 static GList * gt_guitaretabs_parse(cb_object * capo)
 {
-	GList * result_list = NULL;
+	gint scheduled = 0;
 	gchar * begin_search = strstr(capo->cache->data,SEARCH_RESULTS_BEGIN);
 	if(begin_search != NULL)
 	{
@@ -77,7 +73,7 @@ static GList * gt_guitaretabs_parse(cb_object * capo)
 			/* Go through all search results */
 			gchar * node  = begin_search;
 			gsize nodelen = (sizeof SEARCH_NODE) - 1;
-			while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + nodelen, SEARCH_NODE)) != NULL && node <= endin_search)
+			while(continue_search(scheduled,capo->s) && (node = strstr(node + nodelen, SEARCH_NODE)) != NULL && node <= endin_search)
 			{
 				gchar * artist = get_search_value(node,ARTIST_BEGIN,ARTIST_END);
 				node = strstr(node + nodelen, SEARCH_NODE);
@@ -107,11 +103,10 @@ static GList * gt_guitaretabs_parse(cb_object * capo)
 						/* Build resulting url */
 						gchar * result_url = g_strdup_printf("%s%s",GT_BASE,url);
 
-						/* Go and parse it */
-						GlyrMemCache * result = parse_single_page(capo->s,result_url);
-						if(result != NULL)
+						/* Go and parse it, once it's there */
+						if(fetch_followup(capo,result_url,NULL,parse_single_page,NULL,NULL))
 						{
-							result_list = g_list_prepend(result_list,result);
+							scheduled++;
 						}
 						g_free(result_url);
 					}
@@ -123,7 +118,7 @@ static GList * gt_guitaretabs_parse(cb_object * capo)
 			}
 		}
 	}
-	return result_list;	
+	return NULL;
 }
 
 /*--------------------------------------------------------*/
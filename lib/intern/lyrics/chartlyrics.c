@@ -35,23 +35,19 @@ static const gchar * lyrics_chartlyrics_url(GlyrQuery * s)
 #define LYRIC_TEXT_BEG "<Lyric>"
 #define LYRIC_TEXT_END "</Lyric>"
 
-static GlyrMemCache * get_lyrics_from_results(GlyrQuery * s, const gchar * url)
+static GList * get_lyrics_from_results(cb_object * capo, gpointer userdata)
 {
-	GlyrMemCache * result = NULL;
-	GlyrMemCache * dl_cache = download_single(url,s,NULL);
-	if(dl_cache != NULL)
+	GList * result_list = NULL;
+	gchar * text = get_search_value(capo->cache->data,LYRIC_TEXT_BEG,LYRIC_TEXT_END);
+	if(text != NULL)
 	{
-		gchar * text = get_search_value(dl_cache->data,LYRIC_TEXT_BEG,LYRIC_TEXT_END);
-		if(text != NULL)
-		{
-			result = DL_init();
-			result->data = text;
-			result->size = strlen(text);
-			result->dsrc = g_strdup(url);
-		}
-		DL_free(dl_cache);
+		GlyrMemCache * result = DL_init();
+		result->data = text;
+		result->size = strlen(text);
+		result->dsrc = g_strdup(capo->url);
+		result_list = g_list_prepend(result_list,result);
 	}
-	return result;
+	return result_list;
 }
 
 /*--------------------------------------------------------*/
@@ -72,11 +68,11 @@ static GlyrMemCache * get_lyrics_from_results(GlyrQuery * s, const gchar * url)
 
 static GList * lyrics_chartlyrics_parse(cb_object * capo)
 {
-	GList * result_list = NULL;
+	gint scheduled = 0;
 	gchar * node = capo->cache->data;
 	gint nodelen = (sizeof LYRIC_NODE) - 1;
 
-	while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + nodelen, LYRIC_NODE)) != NULL)
+	while(continue_search(scheduled,capo->s) && (node = strstr(node + nodelen, LYRIC_NODE)) != NULL)
 	{
 		node += nodelen;
 		gchar * artist = get_search_value(node,ARTIST_BEG,ARTIST_END);
@@ -90,10 +86,9 @@ static GList * lyrics_chartlyrics_parse(cb_object * capo)
 			if(lyric_id && lyric_checksum && strcmp(lyric_id,"0") != 0)
 			{
 				gchar * content_url = g_strdup_printf(CL_API_GET,lyric_id,lyric_checksum);
-				GlyrMemCache * result = get_lyrics_from_results(capo->s,content_url);
-				if(result != NULL)
+				if(fetch_followup(capo,content_url,NULL,get_lyrics_from_results,NULL,NULL))
 				{
-					result_list = g_list_prepend(result_list,result);
+					scheduled++;
 				}
 				g_free(content_url);
 			}
@@ -103,7 +98,7 @@ static GList * lyrics_chartlyrics_parse(cb_object * capo)
 		g_free(artist);
 		g_free(title);
 	}
-	return result_list;
+	return NULL;
 }
 
 /*--------------------------------------------------------*/
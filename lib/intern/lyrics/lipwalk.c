@@ -70,6 +70,19 @@ static GlyrMemCache * parse_lyrics_page(GlyrMemCache * cache)
 
 /*---------------------------------------------------*/
 
+static GList * parse_followed_page(cb_object * capo, gpointer userdata)
+{
+	GList * result_list = NULL;
+	GlyrMemCache * result_cache = parse_lyrics_page(capo->cache);
+	if(result_cache != NULL)
+	{
+		result_list = g_list_prepend(result_list,result_cache);
+	}
+	return result_list;
+}
+
+/*---------------------------------------------------*/
+
 static gboolean validate_track_description(GlyrQuery * query, gchar * description)
 {
 	gboolean result = FALSE;
@@ -104,9 +117,10 @@ static GList * lyrics_lipwalk_parse(cb_object *capo)
 	} 
 	else /* Oops, we're on the search results page, things are complicated now */
 	{    /* Happens with "In Flames" - "Trigger" e.g.                          */
+		gint scheduled = 0;
 		gchar * search_node = capo->cache->data;
 		gsize track_len = (sizeof TRACK_BEGIN) - 1;
-		while(continue_search(g_list_length(result_list),capo->s) && (search_node = strstr(search_node + track_len,TRACK_BEGIN)))
+		while(continue_search(scheduled,capo->s) && (search_node = strstr(search_node + track_len,TRACK_BEGIN)))
 		{
 			search_node += track_len;
 			gchar * track_end = strstr(search_node,TRACK_ENDIN);
@@ -120,15 +134,9 @@ static GList * lyrics_lipwalk_parse(cb_object *capo)
 					if(track_descr != NULL && validate_track_description(capo->s,track_descr) == TRUE)
 					{
 						gchar * full_url = g_strdup_printf("%s%s",LIPWALK_DOMAIN,lyrics_url);
-						GlyrMemCache * lyrics_page = download_single(full_url,capo->s,NULL);
-						if(lyrics_page != NULL)
+						if(fetch_followup(capo,full_url,NULL,parse_followed_page,NULL,NULL))
 						{
-							GlyrMemCache * result_cache = parse_lyrics_page(lyrics_page);
-							if(result_cache != NULL)
-							{
-								result_list = g_list_prepend(result_list,result_cache);
-							}
-							DL_free(lyrics_page);
+							scheduled++;
 						}
 						g_free(track_descr);
 						g_free(full_url);
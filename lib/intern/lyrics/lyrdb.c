@@ -31,10 +31,42 @@ static const char * lyrics_lyrdb_url(GlyrQuery * settings)
 
 /*---------------------------------------------------*/
 
+static GList * lyrics_lyrdb_parse_lyrics(cb_object * capo, gpointer userdata)
+{
+	GList * result_list = NULL;
+	GlyrMemCache * new_cache = capo->cache;
+
+	gsize i = 0;
+	gchar * buffer = g_malloc0(new_cache->size + 1);
+	for(i = 0; i < new_cache->size; i++)
+	{
+		buffer[i] = (new_cache->data[i] == '\r') ? 
+			' ' :
+			new_cache->data[i];
+	}
+	buffer[i] = 0;
+
+	if(i != 0)
+	{
+		GlyrMemCache * result = DL_init();
+		result->data = buffer;
+		result->size = i;
+		result->dsrc = g_strdup(capo->url);
+
+		result_list = g_list_prepend(result_list,result);
+	}
+	else
+	{
+		g_free(buffer);
+	}
+	return result_list;
+}
+
+/*---------------------------------------------------*/
+
 static GList * lyrics_lyrdb_parse(cb_object * capo)
 {
 	gchar *slash = NULL;
-	GList * result_list = NULL;
 
 	if((slash = strchr(capo->cache->data,'\\')) != NULL)
 	{
@@ -44,37 +76,13 @@ static GList * lyrics_lyrdb_parse(cb_object * capo)
 			gchar * lyr_url = g_strdup_printf("http://webservices.lyrdb.com/getlyr.php?q=%s",uID);
 			if(lyr_url != NULL)
 			{
-				GlyrMemCache * new_cache = download_single(lyr_url,capo->s,NULL);
-				if(new_cache != NULL)
-				{
-					gsize i = 0;
-					gchar * buffer = g_malloc0(new_cache->size + 1);
-					for(i = 0; i < new_cache->size; i++)
-					{
-						buffer[i] = (new_cache->data[i] == '\r') ? 
-							' ' :
-							new_cache->data[i];
-					}
-					buffer[i] = 0;
-
-					if(i != 0)
-					{
-						GlyrMemCache * result = DL_init();
-						result->data = buffer;
-						result->size = i;
-						result->dsrc = g_strdup(lyr_url);
-
-						result_list = g_list_prepend(result_list,result);
-					}
-
-					DL_free(new_cache);
-				}
+				fetch_followup(capo,lyr_url,NULL,lyrics_lyrdb_parse_lyrics,NULL,NULL);
 				g_free(lyr_url);
 			}
 			g_free(uID);
 		}
 	}
-	return result_list;
+	return NULL;
 }
 
 /*---------------------------------------------------*/
@@ -34,9 +34,10 @@ static const char * lyrics_lyricstime_url(GlyrQuery * settings)
 #define LYR_BEGIN "<div id=\"songlyrics\" >"
 #define LYR_ENDIN "</div>"
 
-static GlyrMemCache * parse_page(GlyrMemCache * dl, cb_object * capo)
+static GList * parse_page(cb_object * capo, gpointer userdata)
 {
-	GlyrMemCache * result = NULL;
+	GList * result_list = NULL;
+	GlyrMemCache * dl = capo->cache;
 	if(dl != NULL)
 	{
 		gchar * begin = strstr(dl->data,LYR_BEGIN);
@@ -50,17 +51,18 @@ static GlyrMemCache * parse_page(GlyrMemCache * dl, cb_object * capo)
 				gchar * no_br_tags = strreplace(begin,"<br />",NULL);
 				if(no_br_tags != NULL)
 				{
-					result = DL_init();
+					GlyrMemCache * result = DL_init();
 					result->data = beautify_string(no_br_tags);
 					result->size = (result->data) ? strlen(result->data) : 0;
 					result->dsrc = g_strdup(dl->dsrc);
+					result_list = g_list_prepend(result_list,result);
 
 					g_free(no_br_tags);
 				}
 			}
 		}
 	}
-	return result;
+	return result_list;
 }
 
 /*--------------------------------------------------------*/
@@ -108,7 +110,7 @@ static gboolean validate_artist(cb_object * capo, gchar * backpointer)
 
 static GList * lyrics_lyricstime_parse(cb_object * capo)
 {
-	GList * rList = NULL;
+	gint scheduled = 0;
 	char * start = capo->cache->data;
 	if(start != NULL)
 	{
@@ -117,7 +119,7 @@ static GList * lyrics_lyricstime_parse(cb_object * capo)
 		gchar * backpointer = node;
 		gsize nlen = (sizeof NODE_BEGIN) - 1;
 
-		while(continue_search(g_list_length(rList),capo->s) && (node = strstr(node+nlen,NODE_BEGIN)) != NULL)
+		while(continue_search(scheduled,capo->s) && (node = strstr(node+nlen,NODE_BEGIN)) != NULL)
 		{
 			if(div_end >= node)
 				break;
@@ -131,17 +133,11 @@ static GList * lyrics_lyricstime_parse(cb_object * capo)
 					if(url != NULL)
 					{
 						gchar * full_url = g_strdup_printf("http://www.lyricstime.com%s",url);
-						GlyrMemCache * dl_cache = download_single(full_url,capo->s,NULL);
-						if(dl_cache)
+						if(fetch_followup(capo,full_url,NULL,parse_page,NULL,NULL))
 						{
-							GlyrMemCache * parsed_cache = parse_page(dl_cache,capo);
-							if(parsed_cache != NULL)
-							{
-								rList = g_list_prepend(rList,parsed_cache);
-							}
-							DL_free(dl_cache);
-							g_free(full_url);
+							scheduled++;
 						}
+						g_free(full_url);
 						g_free(url);
 					}
 				}
@@ -149,7 +145,7 @@ static GList * lyrics_lyricstime_parse(cb_object * capo)
 			backpointer = node;
 		}
 	}
-	return rList;
+	return NULL;
 }
 
 /*--------------------------------------------------------*/
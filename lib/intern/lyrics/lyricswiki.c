@@ -67,9 +67,11 @@ static gboolean lv_cmp_content(const gchar * to_artist, const gchar * to_title,
 #define LYR_BEGIN "</a></div>"
 #define LYR_ENDIN "<!--"
 
-GList * parse_result_page(GlyrQuery * query, GlyrMemCache * to_parse)
+static GList * parse_result_page(cb_object * capo, gpointer userdata)
 {
     GList * result_list = NULL;
+    GlyrQuery * query = capo->s;
+    GlyrMemCache * to_parse = capo->cache;
     gchar * node = to_parse->data;
     while(continue_search(g_list_length(result_list),query) && (node = strstr(node,LYR_NODE)))
     {
@@ -101,22 +103,16 @@ GList * parse_result_page(GlyrQuery * query, GlyrMemCache * to_parse)
 
 static GList * lyrics_lyricswiki_parse(cb_object * capo)
 {
-    GList * result_list = NULL;
     if(strstr(capo->cache->data,NOT_FOUND) == NULL && lv_cmp_content(strstr(capo->cache->data,"<artist>"),strstr(capo->cache->data,"<song>"),capo))
     {
         gchar * wiki_page_url = get_search_value(capo->cache->data,"<url>","</url>");
         if(wiki_page_url != NULL)
         {
-            GlyrMemCache * new_cache = download_single(wiki_page_url,capo->s,NULL);
-            if(new_cache != NULL)
-            {
-                result_list = parse_result_page(capo->s,new_cache);
-                DL_free(new_cache);
-            }
+            fetch_followup(capo,wiki_page_url,NULL,parse_result_page,NULL,NULL);
             g_free(wiki_page_url);
         }
     }
-    return result_list;
+    return NULL;
 }
 
 /*--------------------------------------------------------*/
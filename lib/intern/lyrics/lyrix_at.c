@@ -38,9 +38,10 @@ const char * lyrics_lyrixat_url(GlyrQuery * settings)
 
 /*--------------------------------------------------------*/
 
-static void parse_lyrics_page(const gchar * url, GList ** result_list, cb_object * capo)
+static GList * parse_lyrics_page(cb_object * capo, gpointer userdata)
 {
-	GlyrMemCache * lyrcache = download_single(url,capo->s,"<!-- eBay Relevance Ad -->");
+	GList * result_list = NULL;
+	GlyrMemCache * lyrcache = capo->cache;
 	if(lyrcache != NULL)
 	{
 		gchar * lyr_begin = strstr(lyrcache->data,LYRIC_BEGIN);
@@ -55,14 +56,14 @@ static void parse_lyrics_page(const gchar * url, GList ** result_list, cb_object
 					GlyrMemCache * result = DL_init();
 					result->data = strreplace(lyrics,"<br />","");
 					result->size = strlen(result->data);
-					result->dsrc = g_strdup(url);
-					*result_list = g_list_prepend(*result_list,result);
+					result->dsrc = g_strdup(capo->url);
+					result_list = g_list_prepend(result_list,result);
 				}
 				g_free(lyrics);
 			}
 		}
-		DL_free(lyrcache);
 	}
+	return result_list;
 }
 
 /*--------------------------------------------------------*/
@@ -70,11 +71,11 @@ static void parse_lyrics_page(const gchar * url, GList ** result_list, cb_object
 GList * lyrics_lyrixat_parse(cb_object * capo)
 {
 	/* lyrix.at does not offer any webservice -> use the searchfield to get some results */
-	GList * result_list = NULL;
+	gint scheduled = 0;
 	gchar * search_begin_tag = capo->cache->data;
 	gint ctr = 0;
 
-	while(continue_search(g_list_length(result_list),capo->s) && (search_begin_tag = strstr(search_begin_tag+1,SEARCH_START_TAG)) && MAX_TRIES >= ctr++)
+	while(continue_search(scheduled,capo->s) && (search_begin_tag = strstr(search_begin_tag+1,SEARCH_START_TAG)) && MAX_TRIES >= ctr++)
 	{
 		gchar * url_tag = search_begin_tag;
 		url_tag = strstr(url_tag,URL_TAG_BEGIN);
@@ -96,7 +97,10 @@ GList * lyrics_lyrixat_parse(cb_object * capo)
 							if(url_part != NULL)
 							{
 								gchar * url = g_strdup_printf("http://lyrix.at/de%s",url_part);
-								parse_lyrics_page(url,&result_list,capo);
+								if(fetch_followup(capo,url,"<!-- eBay Relevance Ad -->",parse_lyrics_page,NULL,NULL))
+								{
+									scheduled++;
+								}
 								g_free(url);
 								g_free(url_part);
 							}
@@ -107,7 +111,7 @@ GList * lyrics_lyrixat_parse(cb_object * capo)
 			}
 		}
 	}
-	return result_list;
+	return NULL;
 }
 /*--------------------------------------------------------*/
 
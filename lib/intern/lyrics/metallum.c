@@ -43,9 +43,23 @@ static const gchar * lyrics_metallum_url(GlyrQuery * s)
 
 /*--------------------------------------------------------*/
 
-static GList * lyrics_metallum_parse(cb_object * capo)
+static GList * lyrics_metallum_parse_lyrics(cb_object * capo, gpointer userdata)
 {
     GList * result_items = NULL;
+    GlyrMemCache * content_cache = capo->cache;
+    if(content_cache != NULL && strstr(content_cache->data,BAD_STRING) == NULL)
+    {
+        /* Take over the page itself */
+        result_items = g_list_prepend(result_items, content_cache);
+        capo->cache = NULL;
+    }
+    return result_items;
+}
+
+/*--------------------------------------------------------*/
+
+static GList * lyrics_metallum_parse(cb_object * capo)
+{
     gchar * id_start = strstr(capo->cache->data,ID_START);
     if(id_start != NULL)
     {
@@ -56,17 +70,13 @@ static GList * lyrics_metallum_parse(cb_object * capo)
 		    gchar * content_url = g_strdup_printf(SUBST_URL,ID_string);
 		    if(content_url != NULL)
 		    {
-			    GlyrMemCache * content_cache = download_single(content_url,capo->s,NULL);
-			    if(content_cache != NULL && strstr(content_cache->data,BAD_STRING) == NULL)
-			    {
-				    result_items = g_list_prepend(result_items, content_cache);
-			    }
+			    fetch_followup(capo,content_url,NULL,lyrics_metallum_parse_lyrics,NULL,NULL);
 			    g_free(content_url);
 		    }
 		    g_free(ID_string);
 	    }
     }
-    return result_items;
+    return NULL;
 }
 
 /*--------------------------------------------------------*/
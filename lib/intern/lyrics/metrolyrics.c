@@ -58,7 +58,7 @@ static void replace_from_message_inline(gchar * text)
 #define LYRICS_DIV "<div id=\"lyrics-body\">"
 #define LYRICS_END "</div>"
 
-static GlyrMemCache * parse_lyrics_page(const gchar * buffer)
+static GlyrMemCache * parse_lyrics_text(const gchar * buffer)
 {
     GlyrMemCache * result = NULL;
     if(buffer != NULL)
@@ -85,6 +85,20 @@ static GlyrMemCache * parse_lyrics_page(const gchar * buffer)
 
 ///////////////////////////////////
 
+static GList * parse_lyrics_page(cb_object * capo, gpointer userdata)
+{
+    GList * result_list = NULL;
+    GlyrMemCache * result = parse_lyrics_text(capo->cache->data);
+    if(result != NULL)
+    {
+        result->dsrc = g_strdup(capo->url);
+        result_list  = g_list_prepend(result_list,result);
+    }
+    return result_list;
+}
+
+///////////////////////////////////
+
 //#define ROOT_NODE "<div id=\"listResults\">"
 #define ROOT_NODE "<ul id=\"search-results\""
 #define NODE_BEGIN "<a href=\""
@@ -103,7 +117,6 @@ static GlyrMemCache * parse_lyrics_page(const gchar * buffer)
 
 static GList * lyrics_metrolyrics_parse(cb_object * capo)
 {
-    GList * result_list = NULL;
     gchar * root = strstr(capo->cache->data,ROOT_NODE);
 
     if(root != NULL)
@@ -114,7 +127,7 @@ static GList * lyrics_metrolyrics_parse(cb_object * capo)
         gsize tries = 0;
         gsize nodelen = (sizeof NODE_BEGIN);
 
-        while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + nodelen,NODE_BEGIN)) && tries < MAX_TRIES)
+        while(continue_search(tries,capo->s) && (node = strstr(node + nodelen,NODE_BEGIN)) && tries < MAX_TRIES)
         {
                 node += nodelen;
 
@@ -130,18 +143,7 @@ static GList * lyrics_metrolyrics_parse(cb_object * capo)
                         gchar * page_url = g_strdup_printf("www.metrolyrics.com/%s",relative_url);
 
                         tries++;
-                        GlyrMemCache * page_cache = download_single(page_url,capo->s,NULL);
-
-                        if(page_cache != NULL)
-                        {
-                            GlyrMemCache * result = parse_lyrics_page(page_cache->data);
-                            if(result != NULL)
-                            {
-                                result->dsrc = g_strdup(page_url);
-                                result_list  = g_list_prepend(result_list,result);
-                            }
-                            DL_free(page_cache);
-                        }
+                        fetch_followup(capo,page_url,NULL,parse_lyrics_page,NULL,NULL);
                         g_free(page_url);
                         g_free(relative_url);
                     }
@@ -154,7 +156,7 @@ static GList * lyrics_metrolyrics_parse(cb_object * capo)
                 if(node >= end_of_earch) break;
         }
     }
-    return result_list;
+    return NULL;
 }
 
 ///////////////////////////////////
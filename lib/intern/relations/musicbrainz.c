@@ -26,53 +26,52 @@
 #define RELATION_TARGLYR_GET_TYPE "<relation-list target-type=\"Url\">"
 #define RELATION_BEGIN_TYPE  "<relation"
 
-/* Wrap around the (a bit more) generic versions */
-static GList * relations_musicbrainz_parse(cb_object * capo)
+static GList * parse_info_page(cb_object * capo, gpointer userdata)
 {
 	GList * results = NULL;
-	gint mbid_marker = 0;
-	while(continue_search(g_list_length(results), capo->s))
+	GlyrMemCache * infobuf = capo->cache;
+
+	gsize nlen = (sizeof RELATION_BEGIN_TYPE) - 1;
+	gchar * node = strstr(infobuf->data,RELATION_TARGLYR_GET_TYPE);
+	if(node != NULL)
 	{
-		GlyrMemCache  * infobuf = generic_musicbrainz_parse(capo,&mbid_marker,"url-rels");
-		if(infobuf == NULL)
+		gint ctr = 0;
+		while(continue_search(ctr,capo->s) && (node = strstr(node+nlen,RELATION_BEGIN_TYPE)) )
 		{
-			break;
-		}
-		gsize nlen = (sizeof RELATION_BEGIN_TYPE) - 1;
-		gchar * node = strstr(infobuf->data,RELATION_TARGLYR_GET_TYPE);
-		if(node != NULL)
-		{
-			gint ctr = 0;
-			while(continue_search(ctr,capo->s) && (node = strstr(node+nlen,RELATION_BEGIN_TYPE)) )
-			{
-				node += nlen;
-				gchar * target = get_search_value(node,"target=\"","\"");
-				gchar * type   = get_search_value(node,"type=\"","\"");
+			node += nlen;
+			gchar * target = get_search_value(node,"target=\"","\"");
+			gchar * type   = get_search_value(node,"type=\"","\"");
 
-				if(type != NULL && target != NULL)
-				{
-					GlyrMemCache * tmp = DL_init();
-					tmp->data = g_strdup_printf("%s:%s",type,target);
-					tmp->size = strlen(tmp->data);
-					tmp->dsrc = g_strdup(infobuf->dsrc);
-					results = g_list_prepend(results,tmp);
-					ctr++;
+			if(type != NULL && target != NULL)
+			{
+				GlyrMemCache * tmp = DL_init();
+				tmp->data = g_strdup_printf("%s:%s",type,target);
+				tmp->size = strlen(tmp->data);
+				tmp->dsrc = g_strdup(infobuf->dsrc);
+				results = g_list_prepend(results,tmp);
+				ctr++;
 
-					g_free(type);
-					g_free(target);
-				}
+				g_free(type);
+				g_free(target);
 			}
 		}
-		DL_free(infobuf);
 	}
 	return results;
 }
 
 /*--------------------------------------------------------*/
 
+/* Wrap around the (a bit more) generic versions */
+static GList * relations_musicbrainz_parse(cb_object * capo)
+{
+	return generic_musicbrainz_parse(capo,"url-rels",parse_info_page);
+}
+
+/*--------------------------------------------------------*/
+
 static const gchar * relations_musicbrainz_url(GlyrQuery * sets)
 {
-	return generic_musicbrainz_url(sets);
+	return generic_musicbrainz_url(sets,"url-rels");
 }
 
 /*--------------------------------------------------------*/
@@ -60,6 +60,19 @@ static GlyrMemCache * parse_text(GlyrMemCache * to_parse)
 
 /*---------------------------------*/
 
+static GList * parse_review_page(cb_object * capo, gpointer userdata)
+{
+	GList * result_list = NULL;
+	GlyrMemCache * result = parse_text(capo->cache);
+	if(result != NULL)
+	{
+		result_list = g_list_prepend(result_list,result);
+	}
+	return result_list;
+}
+
+/*---------------------------------*/
+
 #define TITLE_BEGIN  "<a href=\"\">Title</a></th>"
 #define SINGLE_ENDMARK "<div id=\"tracks\">"
 
@@ -81,9 +94,10 @@ static GList * review_allmusic_parse(cb_object * capo)
 		return NULL;
 	}
 
+	gint scheduled = 0;
 	gsize nodelen = (sizeof SEARCH_NODE) - 1;
 	gchar *  node = search_begin;
-	while(continue_search(g_list_length(result_list),capo->s) && (node = strstr(node + nodelen,SEARCH_NODE)))
+	while(continue_search(scheduled,capo->s) && (node = strstr(node + nodelen,SEARCH_NODE)))
 	{
 		gchar * url = copy_value(node + nodelen,strstr(node,SEARCH_DELM));
 		if(url != NULL)
@@ -97,15 +111,9 @@ static GList * review_allmusic_parse(cb_object * capo)
 					gchar * review_url = g_strdup_printf("%s/review",url);
 					if(review_url != NULL)
 					{
-						GlyrMemCache * dl = download_single(review_url,capo->s,SINGLE_ENDMARK);
-						if(dl != NULL)
+						if(fetch_followup(capo,review_url,SINGLE_ENDMARK,parse_review_page,NULL,NULL))
 						{
-							GlyrMemCache * result = parse_text(dl);
-							if(result != NULL)
-							{
-								result_list = g_list_prepend(result_list,result);
-							}
-							DL_free(dl);
+							scheduled++;
 						}
 						g_free(review_url);
 					}
@@ -115,7 +123,7 @@ static GList * review_allmusic_parse(cb_object * capo)
 			g_free(url);
 		}
 	}
-	return result_list;
+	return NULL;
 }
 
 /*--------------------------------------------------------*/
@@ -36,14 +36,16 @@ static const gchar * review_metallum_url(GlyrQuery * s)
 #define REVIEW_START "<div class=\"reviewContent\">"
 #define REVIEW_END   "</div>"
 
-static void parse_review_site(GlyrQuery * s, GlyrMemCache * cache, GList ** result_items)
+static GList * parse_review_site(cb_object * capo, gpointer userdata)
 {
+	GList * result_items = NULL;
+	GlyrMemCache * cache = capo->cache;
 	if(cache != NULL)
 	{
 		gsize nodelen = (sizeof REVIEW_START) - 1;
 		gchar * node  = cache->data;
 
-		while(continue_search(g_list_length(*result_items),s) && (node = strstr(node+nodelen,REVIEW_START)) != NULL)
+		while(continue_search(g_list_length(result_items),capo->s) && (node = strstr(node+nodelen,REVIEW_START)) != NULL)
 		{
 			gchar * data = get_search_value(node,REVIEW_START,REVIEW_END);
 			if(data != NULL)
@@ -54,14 +56,14 @@ static void parse_review_site(GlyrQuery * s, GlyrMemCache * cache, GList ** resu
 				item->data = strreplace(kill_br,".  ",".\n");
 				item->size = strlen(item->data);
 				item->dsrc = g_strdup(cache->dsrc);
-				*result_items = g_list_prepend(*result_items, item);
+				result_items = g_list_prepend(result_items, item);
 
 				g_free(kill_br);
 				g_free(data);
 			}
 		}
-		DL_free(cache);
 	}
+	return result_items;
 }
 
 #define NODE_START "\"<a href=\\\""
@@ -69,13 +71,13 @@ static void parse_review_site(GlyrQuery * s, GlyrMemCache * cache, GList ** resu
 
 static GList * review_metallum_parse(cb_object * capo)
 {
-	GList * result_items = NULL;
+	gint scheduled = 0;
 
 	gsize nodelen = strlen(NODE_START);
 	gchar * node  = capo->cache->data;
 	gint node_ctr = 0;
 
-	while((node = strstr(node+nodelen,NODE_START)) != NULL)
+	while(continue_search(scheduled,capo->s) && (node = strstr(node+nodelen,NODE_START)) != NULL)
 	{
 		/* Only take the album url, not the other urls */
 		if(++node_ctr % 2 == 0)
@@ -87,14 +89,17 @@ static GList * review_metallum_parse(cb_object * capo)
 				gchar * review_url = strreplace(content_url,"/albums/","/reviews/");
 				if(review_url != NULL)
 				{
-					parse_review_site(capo->s, download_single(review_url,capo->s,NULL), &result_items);
+					if(fetch_followup(capo,review_url,NULL,parse_review_site,NULL,NULL))
+					{
+						scheduled++;
+					}
 					g_free(review_url);
 				}
 				g_free(content_url);
 			}
 		}
 	}
-	return result_items;
+	return NULL;
 }
 
 
@@ -19,11 +19,7 @@
 **************************************************************/
 #include "../../stringlib.h"
 #include "../../core.h"
-
-static const gchar * tracklist_musicbrainz_url(GlyrQuery * sets)
-{
-    return "http://musicbrainz.org/ws/1/release/?type=xml&artist=${artist}&releasetypes=Official&limit=10&title=${album}&limit=1";
-}
+#include "../../mbidcache.h"
 
 /* ----------------------------------------- */
 
@@ -31,6 +27,21 @@ static const gchar * tracklist_musicbrainz_url(GlyrQuery * sets)
 #define REL_ID_ENDIN "\" ext:score="
 #define REL_ID_FORM  "http://musicbrainz.org/ws/1/release/%s?type=xml&inc=tracks"
 
+/* ----------------------------------------- */
+
+/* Go to the release page right away, if we know it */
+static const gchar * tracklist_musicbrainz_url(GlyrQuery * sets)
+{
+    gchar * release_ID = mbidcache_lookup(sets,"release");
+    if(release_ID != NULL)
+    {
+        gchar * release_page_info_url = g_strdup_printf(KNOWN_PAGE_MARK REL_ID_FORM,release_ID);
+        g_free(release_ID);
+        return release_page_info_url;
+    }
+    return g_strdup("http://musicbrainz.org/ws/1/release/?type=xml&artist=${artist}&releasetypes=Official&limit=10&title=${album}&limit=1");
+}
+
 #define DUR_BEGIN "<duration>"
 #define DUR_ENDIN "</duration>"
 #define TIT_BEGIN "<title>"
@@ -72,10 +83,28 @@ static GList * traverse_xml(const gchar * data, const gchar * url, cb_object * c
 
 /* ----------------------------------------- */
 
+static GList * parse_release_page(cb_object * capo, gpointer userdata)
+{
+	/* Results should point to the search, not the release page */
+	const gchar * url = (capo->parent != NULL) ? capo->parent->url : capo->url;
+	GList * result_list = traverse_xml(capo->cache->data,url,capo);
+	if(result_list != NULL)
+	{
+		result_list = g_list_reverse(result_list);
+	}
+	return result_list;
+}
+
+/* ----------------------------------------- */
+
 /* Use simple text parsing, xml parsing has no advantage here */
 static GList * tracklist_musicbrainz_parse(cb_object * capo)
 {
-	GList * result_list = NULL;
+	/* Known release, see tracklist_musicbrainz_url() */
+	if(capo->known_page == TRUE)
+	{
+		return parse_release_page(capo,NULL);
+	}
 
 	gchar * rel_id_begin = strstr(capo->cache->data,REL_ID_BEGIN);
 	if(rel_id_begin != NULL)
@@ -83,22 +112,14 @@ static GList * tracklist_musicbrainz_parse(cb_object * capo)
 		gchar * release_ID = get_search_value(rel_id_begin,REL_ID_BEGIN,REL_ID_ENDIN);
 		if(release_ID != NULL)
 		{
+			mbidcache_store(capo->s,"release",release_ID);
 			gchar * release_page_info_url = g_strdup_printf(REL_ID_FORM, release_ID);
-			GlyrMemCache * dlData = download_single(release_page_info_url,capo->s,NULL);
-			if(dlData != NULL)
-			{
-				result_list = traverse_xml(dlData->data,capo->url,capo);
-				if(result_list != NULL)
-				{
-					result_list = g_list_reverse(result_list);
-				}
-				DL_free(dlData);
-			}
+			fetch_followup(capo,release_page_info_url,NULL,parse_release_page,NULL,NULL);
 			g_free(release_page_info_url);
 			g_free(release_ID);
 		}
 	}
-	return result_list;
+	return NULL;
 }
 
 /*--------------------------------------------------------*/
@@ -112,7 +133,7 @@ MetaDataSource tracklist_musicbrainz_src =
 	.quality   = 90,
 	.speed     = 90,
 	.endmarker = NULL,
-	.free_url  = false,
+	.free_url  = true,
 	.type      = GLYR_GET_TRACKLIST
 };
 
@@ -0,0 +1,114 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "latency.h"
+
+/*-----------------------------------------------------------------*/
+
+typedef struct {
+    /* Ringbuffer, next is the slot to be written next */
+    gint64 samples[LATENCY_WINDOW];
+    gint count;
+    gint next;
+} LatencyWindow;
+
+static GHashTable * window_table = NULL;
+static GStaticMutex window_lock = G_STATIC_MUTEX_INIT;
+
+/*-----------------------------------------------------------------*/
+
+void latency_record(gconstpointer provider, gint64 ms)
+{
+    if(provider == NULL || ms < 0)
+    {
+        return;
+    }
+
+    g_static_mutex_lock(&window_lock);
+    if(window_table == NULL)
+    {
+        window_table = g_hash_table_new_full(g_direct_hash,g_direct_equal,NULL,g_free);
+    }
+
+    LatencyWindow * window = g_hash_table_lookup(window_table,provider);
+    if(window == NULL)
+    {
+        window = g_malloc0(sizeof(LatencyWindow));
+        g_hash_table_insert(window_table,(gpointer)provider,window);
+    }
+
+    window->samples[window->next] = ms;
+    window->next = (window->next + 1) % LATENCY_WINDOW;
+    window->count = MIN(window->count + 1,LATENCY_WINDOW);
+    g_static_mutex_unlock(&window_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+static gint compare_samples(gconstpointer a, gconstpointer b)
+{
+    gint64 x = *(const gint64*)a;
+    gint64 y = *(const gint64*)b;
+    return (x > y) - (x < y);
+}
+
+/*-----------------------------------------------------------------*/
+
+gint64 latency_percentile(gconstpointer provider, gdouble percentile)
+{
+    gint64 sorted[LATENCY_WINDOW];
+    gint count = 0;
+
+    g_static_mutex_lock(&window_lock);
+    LatencyWindow * window = (window_table) ? g_hash_table_lookup(window_table,provider) : NULL;
+    if(window != NULL)
+    {
+        count = window->count;
+        memcpy(sorted,window->samples,count * sizeof(gint64));
+    }
+    g_static_mutex_unlock(&window_lock);
+
+    if(count < LATENCY_MIN_SAMPLES)
+    {
+        return -1;
+    }
+
+    /* Nearest rank; the window is tiny, so just sort a copy */
+    qsort(sorted,count,sizeof(gint64),compare_samples);
+    gint rank = (gint)(CLAMP(percentile,0.0,1.0) * count + 0.999999);
+    return sorted[CLAMP(rank - 1,0,count - 1)];
+}
+
+/*-----------------------------------------------------------------*/
+
+void latency_destroy(void)
+{
+    g_static_mutex_lock(&window_lock);
+    if(window_table != NULL)
+    {
+        g_hash_table_destroy(window_table);
+        window_table = NULL;
+    }
+    g_static_mutex_unlock(&window_lock);
+}
+
+/*-----------------------------------------------------------------*/
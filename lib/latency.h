@@ -0,0 +1,44 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_LATENCY_H
+#define GLYR_LATENCY_H
+
+#include <glib.h>
+
+/* Process wide record of how long the transfers of each provider took.
+ * Only the last LATENCY_WINDOW samples of a provider are kept,
+ * so it follows providers that get faster or slower.
+ */
+#define LATENCY_WINDOW 64
+
+/* Below this, a percentile would be rather guessed than measured */
+#define LATENCY_MIN_SAMPLES 8
+
+/* provider is only used as key; pass the same pointer each time */
+void latency_record(gconstpointer provider, gint64 ms);
+
+/* The percentile [0.0-1.0] of the recorded samples in ms,
+ * or -1 if there are less than LATENCY_MIN_SAMPLES.
+ */
+gint64 latency_percentile(gconstpointer provider, gdouble percentile);
+void latency_destroy(void);
+
+#endif
@@ -0,0 +1,196 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include "mbidcache.h"
+#include "stringlib.h"
+#include "cache_intern.h"
+
+/*-----------------------------------------------------------------*/
+
+typedef struct {
+    gchar * key;
+    gchar * mbid;
+
+    /* Position in lru_queue */
+    GList * link;
+} MbidEntry;
+
+/* key => MbidEntry; lru_queue has the most recently used first */
+static GHashTable * mbid_table = NULL;
+static GQueue * lru_queue = NULL;
+static GStaticMutex mbid_lock = G_STATIC_MUTEX_INIT;
+
+/*-----------------------------------------------------------------*/
+
+static void free_entry(MbidEntry * entry)
+{
+    g_free(entry->key);
+    g_free(entry->mbid);
+    g_free(entry);
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Only the names the search for entity is done with are part of the key */
+static gchar * build_names(GlyrQuery * query, const gchar * entity)
+{
+    gboolean is_track   = (g_strcmp0(entity,"track") == 0);
+    gboolean is_release = (g_strcmp0(entity,"release") == 0);
+
+    gchar * artist = prepare_string(query->artist,FALSE,FALSE);
+    gchar * album  = (is_track || is_release) ? prepare_string(query->album,FALSE,FALSE) : NULL;
+    gchar * title  = (is_track) ? prepare_string(query->title,FALSE,FALSE) : NULL;
+
+    gchar * names = g_strdup_printf("%s\n%s\n%s",(artist) ? artist : "",(album) ? album : "",(title) ? title : "");
+
+    g_free(artist);
+    g_free(album);
+    g_free(title);
+    return names;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Put it in memory, or mark it as used; mbid_lock needs to be held */
+static void remember(const gchar * key, const gchar * mbid)
+{
+    if(mbid_table == NULL)
+    {
+        mbid_table = g_hash_table_new(g_str_hash,g_str_equal);
+        lru_queue = g_queue_new();
+    }
+
+    MbidEntry * entry = g_hash_table_lookup(mbid_table,key);
+    if(entry != NULL)
+    {
+        g_free(entry->mbid);
+        entry->mbid = g_strdup(mbid);
+        g_queue_unlink(lru_queue,entry->link);
+        g_queue_push_head_link(lru_queue,entry->link);
+        return;
+    }
+
+    entry = g_malloc0(sizeof(MbidEntry));
+    entry->key  = g_strdup(key);
+    entry->mbid = g_strdup(mbid);
+    g_queue_push_head(lru_queue,entry);
+    entry->link = lru_queue->head;
+    g_hash_table_insert(mbid_table,entry->key,entry);
+
+    while(lru_queue->length > MBIDCACHE_SIZE)
+    {
+        MbidEntry * oldest = g_queue_pop_tail(lru_queue);
+        g_hash_table_remove(mbid_table,oldest->key);
+        free_entry(oldest);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+gchar * mbidcache_lookup(GlyrQuery * query, const gchar * entity)
+{
+    if(query == NULL || entity == NULL)
+    {
+        return NULL;
+    }
+
+    gchar * names = build_names(query,entity);
+    gchar * key = g_strdup_printf("%s\n%s",entity,names);
+    gchar * mbid = NULL;
+
+    g_static_mutex_lock(&mbid_lock);
+    MbidEntry * entry = (mbid_table) ? g_hash_table_lookup(mbid_table,key) : NULL;
+    if(entry != NULL)
+    {
+        mbid = g_strdup(entry->mbid);
+        g_queue_unlink(lru_queue,entry->link);
+        g_queue_push_head_link(lru_queue,entry->link);
+    }
+    g_static_mutex_unlock(&mbid_lock);
+
+    /* Not seen in this process yet, but maybe before */
+    if(mbid == NULL && query->local_db != NULL && query->db_autoread == TRUE)
+    {
+        mbid = db_lookup_mbid(query->local_db,entity,names);
+        if(mbid != NULL)
+        {
+            g_static_mutex_lock(&mbid_lock);
+            remember(key,mbid);
+            g_static_mutex_unlock(&mbid_lock);
+        }
+    }
+
+    if(mbid != NULL)
+    {
+        glyr_message(2,query,"- Known MBID of %s: %s\n",entity,mbid);
+    }
+
+    g_free(names);
+    g_free(key);
+    return mbid;
+}
+
+/*-----------------------------------------------------------------*/
+
+void mbidcache_store(GlyrQuery * query, const gchar * entity, const gchar * mbid)
+{
+    if(query == NULL || entity == NULL || mbid == NULL)
+    {
+        return;
+    }
+
+    gchar * names = build_names(query,entity);
+    gchar * key = g_strdup_printf("%s\n%s",entity,names);
+
+    g_static_mutex_lock(&mbid_lock);
+    remember(key,mbid);
+    g_static_mutex_unlock(&mbid_lock);
+
+    if(query->local_db != NULL && query->db_autowrite == TRUE)
+    {
+        db_store_mbid(query->local_db,entity,names,mbid);
+    }
+
+    g_free(names);
+    g_free(key);
+}
+
+/*-----------------------------------------------------------------*/
+
+void mbidcache_destroy(void)
+{
+    g_static_mutex_lock(&mbid_lock);
+    if(mbid_table != NULL)
+    {
+        MbidEntry * entry = NULL;
+        while((entry = g_queue_pop_head(lru_queue)) != NULL)
+        {
+            free_entry(entry);
+        }
+
+        g_queue_free(lru_queue);
+        lru_queue = NULL;
+        g_hash_table_destroy(mbid_table);
+        mbid_table = NULL;
+    }
+    g_static_mutex_unlock(&mbid_lock);
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,42 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_MBIDCACHE_H
+#define GLYR_MBIDCACHE_H
+
+#include <glib.h>
+#include "types.h"
+
+/* Process wide cache of resolved MusicBrainz IDs, so the search 
+ * does not need to be done again for the same artist, release or track.
+ * Maps entity ("artist", "release" or "track") and the normalized 
+ * names of the query to the MBID. Only the MBIDCACHE_SIZE most
+ * recently used are kept in memory, the query's GlyrDatabase keeps all.
+ */
+#define MBIDCACHE_SIZE 1024
+
+/* The MBID of entity for query's artist/album/title, NULL if unknown. Free with g_free() */
+gchar * mbidcache_lookup(GlyrQuery * query, const gchar * entity);
+
+/* Remember mbid; also in query->local_db if db_autowrite is set */
+void mbidcache_store(GlyrQuery * query, const gchar * entity, const gchar * mbid);
+void mbidcache_destroy(void);
+
+#endif
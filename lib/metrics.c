@@ -0,0 +1,286 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <string.h>
+#include "metrics.h"
+#include "core.h"
+#include "register_plugins.h"
+#include "glyr.h"
+
+/*-----------------------------------------------------------------*/
+
+/* 64 bit atomics; GLib before 2.30 has none */
+#define METRICS_ATOMIC_ADD(PTR,V)  __sync_fetch_and_add((PTR),(V))
+#define METRICS_ATOMIC_GET(PTR)    __sync_fetch_and_add((PTR),0)
+#define METRICS_ATOMIC_CLEAR(PTR)  __sync_fetch_and_and((PTR),0)
+
+typedef struct {
+    gint64 counters[METRICS_LAST];
+    gint64 buckets[GLYR_METRICS_LATENCY_BUCKETS];
+    gint64 latency_sum_ms;
+} ProviderSlot;
+
+static const gint64 latency_bounds_ms[] = {GLYR_METRICS_LATENCY_BOUNDS_MS};
+
+static ProviderSlot * registry = NULL;
+static gsize registry_size = 0;
+
+/*-----------------------------------------------------------------*/
+
+void metrics_init(gsize providers)
+{
+    metrics_destroy();
+    registry = g_malloc0(MAX(providers,1) * sizeof(ProviderSlot));
+    registry_size = providers;
+}
+
+/*-----------------------------------------------------------------*/
+
+void metrics_destroy(void)
+{
+    g_free(registry);
+    registry = NULL;
+    registry_size = 0;
+}
+
+/*-----------------------------------------------------------------*/
+
+static ProviderSlot * get_slot(MetaDataSource * source)
+{
+    if(source == NULL || registry == NULL || source->id < 0 || (gsize)source->id >= registry_size)
+    {
+        return NULL;
+    }
+    return &registry[source->id];
+}
+
+/*-----------------------------------------------------------------*/
+
+void metrics_add(MetaDataSource * source, MetricsCounter counter, gint64 value)
+{
+    ProviderSlot * slot = get_slot(source);
+    if(slot != NULL && counter < METRICS_LAST && value != 0)
+    {
+        METRICS_ATOMIC_ADD(&slot->counters[counter],value);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void metrics_observe_latency(MetaDataSource * source, gint64 ms)
+{
+    ProviderSlot * slot = get_slot(source);
+    if(slot == NULL || ms < 0)
+    {
+        return;
+    }
+
+    /* The last bucket takes everything above the highest bound */
+    gsize bucket = 0;
+    while(bucket < G_N_ELEMENTS(latency_bounds_ms) && ms > latency_bounds_ms[bucket])
+    {
+        bucket++;
+    }
+
+    METRICS_ATOMIC_ADD(&slot->buckets[bucket],1);
+    METRICS_ATOMIC_ADD(&slot->latency_sum_ms,ms);
+}
+
+/*-----------------------------------------------------------------*/
+
+GlyrProviderMetrics * metrics_snapshot(void)
+{
+    GlyrProviderMetrics * head = NULL, * tail = NULL;
+    for(GList * elem = r_getSList(); elem; elem = elem->next)
+    {
+        MetaDataSource * source = elem->data;
+        ProviderSlot * slot = get_slot(source);
+        if(slot == NULL)
+        {
+            continue;
+        }
+
+        GlyrProviderMetrics * metrics = g_malloc0(sizeof(GlyrProviderMetrics));
+        metrics->name = g_strdup(source->name);
+        metrics->type = source->type;
+        metrics->requests        = METRICS_ATOMIC_GET(&slot->counters[METRICS_REQUESTS]);
+        metrics->errors          = METRICS_ATOMIC_GET(&slot->counters[METRICS_ERRORS]);
+        metrics->bytes           = METRICS_ATOMIC_GET(&slot->counters[METRICS_BYTES]);
+        metrics->accepted        = METRICS_ATOMIC_GET(&slot->counters[METRICS_ACCEPTED]);
+        metrics->rejected_dupes  = METRICS_ATOMIC_GET(&slot->counters[METRICS_REJECTED_DUPES]);
+        metrics->rejected_format = METRICS_ATOMIC_GET(&slot->counters[METRICS_REJECTED_FORMAT]);
+        metrics->rejected_utf8   = METRICS_ATOMIC_GET(&slot->counters[METRICS_REJECTED_UTF8]);
+        metrics->rejected_cached = METRICS_ATOMIC_GET(&slot->counters[METRICS_REJECTED_CACHED]);
+
+        for(gsize i = 0; i < GLYR_METRICS_LATENCY_BUCKETS; i++)
+        {
+            metrics->latency_buckets[i] = METRICS_ATOMIC_GET(&slot->buckets[i]);
+            metrics->latency_count += metrics->latency_buckets[i];
+        }
+        metrics->latency_sum_ms = METRICS_ATOMIC_GET(&slot->latency_sum_ms);
+
+        if(head == NULL)
+        {
+            head = metrics;
+        }
+        else
+        {
+            tail->next = metrics;
+            metrics->prev = tail;
+        }
+        tail = metrics;
+    }
+    return head;
+}
+
+/*-----------------------------------------------------------------*/
+
+void metrics_free_snapshot(GlyrProviderMetrics * metrics)
+{
+    while(metrics != NULL)
+    {
+        GlyrProviderMetrics * next = metrics->next;
+        g_free(metrics->name);
+        g_free(metrics);
+        metrics = next;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void metrics_reset(void)
+{
+    for(gsize i = 0; i < registry_size; i++)
+    {
+        ProviderSlot * slot = &registry[i];
+        for(gsize c = 0; c < METRICS_LAST; c++)
+        {
+            METRICS_ATOMIC_CLEAR(&slot->counters[c]);
+        }
+        for(gsize b = 0; b < GLYR_METRICS_LATENCY_BUCKETS; b++)
+        {
+            METRICS_ATOMIC_CLEAR(&slot->buckets[b]);
+        }
+        METRICS_ATOMIC_CLEAR(&slot->latency_sum_ms);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+static void append_header(GString * out, const gchar * name, const gchar * type, const gchar * help)
+{
+    g_string_append_printf(out,"# HELP %s %s\n# TYPE %s %s\n",name,help,name,type);
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Label values may not contain unescaped quotes, backslashes or newlines */
+static gchar * escape_label(const gchar * value)
+{
+    GString * escaped = g_string_new(NULL);
+    for(const gchar * c = value; c && *c; c++)
+    {
+        switch(*c)
+        {
+            case '\\': g_string_append(escaped,"\\\\"); break;
+            case '"':  g_string_append(escaped,"\\\""); break;
+            case '\n': g_string_append(escaped,"\\n");  break;
+            default:   g_string_append_c(escaped,*c);
+        }
+    }
+    return g_string_free(escaped,FALSE);
+}
+
+/*-----------------------------------------------------------------*/
+
+/* glyr_init() sets the locale, but prometheus wants a '.' in any case */
+static const gchar * format_seconds(gchar * buffer, gsize size, gint64 ms)
+{
+    return g_ascii_formatd(buffer,size,"%g",ms / 1000.0);
+}
+
+/*-----------------------------------------------------------------*/
+
+static void append_counter(GString * out, GlyrProviderMetrics * metrics, const gchar * name, gsize offset, const gchar * extra_label)
+{
+    for(GlyrProviderMetrics * m = metrics; m; m = m->next)
+    {
+        gchar * provider = escape_label(m->name);
+        long value = G_STRUCT_MEMBER(long,m,offset);
+        g_string_append_printf(out,"%s{provider=\"%s\",getter=\"%s\"%s} %ld\n",
+                               name,provider,glyr_get_type_to_string(m->type),
+                               (extra_label) ? extra_label : "",value);
+        g_free(provider);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+gchar * metrics_to_prometheus(GlyrProviderMetrics * metrics)
+{
+    GString * out = g_string_new(NULL);
+
+    append_header(out,"glyr_provider_requests_total","counter","Downloads done for a provider.");
+    append_counter(out,metrics,"glyr_provider_requests_total",G_STRUCT_OFFSET(GlyrProviderMetrics,requests),NULL);
+
+    append_header(out,"glyr_provider_errors_total","counter","Downloads of a provider that failed.");
+    append_counter(out,metrics,"glyr_provider_errors_total",G_STRUCT_OFFSET(GlyrProviderMetrics,errors),NULL);
+
+    append_header(out,"glyr_provider_bytes_total","counter","Bytes downloaded for a provider.");
+    append_counter(out,metrics,"glyr_provider_bytes_total",G_STRUCT_OFFSET(GlyrProviderMetrics,bytes),NULL);
+
+    append_header(out,"glyr_provider_results_total","counter","Items a provider found, by whether they were taken or why not.");
+    append_counter(out,metrics,"glyr_provider_results_total",G_STRUCT_OFFSET(GlyrProviderMetrics,accepted),",result=\"accepted\"");
+    append_counter(out,metrics,"glyr_provider_results_total",G_STRUCT_OFFSET(GlyrProviderMetrics,rejected_dupes),",result=\"duplicate\"");
+    append_counter(out,metrics,"glyr_provider_results_total",G_STRUCT_OFFSET(GlyrProviderMetrics,rejected_format),",result=\"wrong_format\"");
+    append_counter(out,metrics,"glyr_provider_results_total",G_STRUCT_OFFSET(GlyrProviderMetrics,rejected_utf8),",result=\"invalid_utf8\"");
+    append_counter(out,metrics,"glyr_provider_results_total",G_STRUCT_OFFSET(GlyrProviderMetrics,rejected_cached),",result=\"in_db\"");
+
+    append_header(out,"glyr_provider_latency_seconds","histogram","Time a successful download of a provider took.");
+    for(GlyrProviderMetrics * m = metrics; m; m = m->next)
+    {
+        gchar * provider = escape_label(m->name);
+        const gchar * getter = glyr_get_type_to_string(m->type);
+
+        /* Buckets are cumulative in prometheus */
+        gchar seconds[G_ASCII_DTOSTR_BUF_SIZE];
+        long cumulated = 0;
+        for(gsize i = 0; i < GLYR_METRICS_LATENCY_BUCKETS; i++)
+        {
+            cumulated += m->latency_buckets[i];
+            if(i < G_N_ELEMENTS(latency_bounds_ms))
+            {
+                g_string_append_printf(out,"glyr_provider_latency_seconds_bucket{provider=\"%s\",getter=\"%s\",le=\"%s\"} %ld\n",
+                                       provider,getter,format_seconds(seconds,sizeof(seconds),latency_bounds_ms[i]),cumulated);
+            }
+            else
+            {
+                g_string_append_printf(out,"glyr_provider_latency_seconds_bucket{provider=\"%s\",getter=\"%s\",le=\"+Inf\"} %ld\n",
+                                       provider,getter,cumulated);
+            }
+        }
+        g_string_append_printf(out,"glyr_provider_latency_seconds_sum{provider=\"%s\",getter=\"%s\"} %s\n",
+                               provider,getter,format_seconds(seconds,sizeof(seconds),m->latency_sum_ms));
+        g_string_append_printf(out,"glyr_provider_latency_seconds_count{provider=\"%s\",getter=\"%s\"} %ld\n",provider,getter,m->latency_count);
+        g_free(provider);
+    }
+
+    return g_string_free(out,FALSE);
+}
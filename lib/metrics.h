@@ -0,0 +1,59 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_METRICS_H
+#define GLYR_METRICS_H
+
+#include <glib.h>
+#include "types.h"
+
+struct MetaDataSource;
+
+/* Process wide counters of each provider, read by glyr_metrics_snapshot().
+ * There is one fixed slot per MetaDataSource.id, allocated by metrics_init() once the
+ * providers are registered, so updates are plain atomic adds without any lock.
+ */
+typedef enum {
+    METRICS_REQUESTS,
+    METRICS_ERRORS,
+    METRICS_BYTES,
+    METRICS_ACCEPTED,
+    METRICS_REJECTED_DUPES,
+    METRICS_REJECTED_FORMAT,
+    METRICS_REJECTED_UTF8,
+    METRICS_REJECTED_CACHED,
+    METRICS_LAST
+} MetricsCounter;
+
+void metrics_init(gsize providers);
+void metrics_destroy(void);
+
+/* source may be NULL (e.g. downloads of the finalizer), nothing is counted then */
+void metrics_add(struct MetaDataSource * source, MetricsCounter counter, gint64 value);
+void metrics_observe_latency(struct MetaDataSource * source, gint64 ms);
+
+GlyrProviderMetrics * metrics_snapshot(void);
+void metrics_free_snapshot(GlyrProviderMetrics * metrics);
+void metrics_reset(void);
+
+/* Prometheus text exposition format of a snapshot */
+gchar * metrics_to_prometheus(GlyrProviderMetrics * metrics);
+
+#endif
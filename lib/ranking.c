@@ -0,0 +1,168 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <string.h>
+#include "ranking.h"
+
+/*-----------------------------------------------------------------*/
+
+static GHashTable * record_table = NULL;
+static GStaticMutex record_lock = G_STATIC_MUTEX_INIT;
+
+/*-----------------------------------------------------------------*/
+
+/* Needs record_lock to be held */
+static RankingRecord * get_record(gconstpointer provider)
+{
+    if(record_table == NULL)
+    {
+        record_table = g_hash_table_new_full(g_direct_hash,g_direct_equal,NULL,g_free);
+    }
+
+    RankingRecord * record = g_hash_table_lookup(record_table,provider);
+    if(record == NULL)
+    {
+        record = g_malloc0(sizeof(RankingRecord));
+        g_hash_table_insert(record_table,(gpointer)provider,record);
+    }
+    return record;
+}
+
+/*-----------------------------------------------------------------*/
+
+void ranking_record_transfer(gconstpointer provider, gboolean success, gint64 latency_ms)
+{
+    if(provider != NULL)
+    {
+        g_static_mutex_lock(&record_lock);
+        RankingRecord * record = get_record(provider);
+        if(record->transfers == 0)
+        {
+            record->latency_ms = latency_ms;
+        }
+        else
+        {
+            record->latency_ms += RANKING_LATENCY_WEIGHT * (latency_ms - record->latency_ms);
+        }
+
+        record->transfers++;
+        record->successes += (success) ? 1 : 0;
+        g_static_mutex_unlock(&record_lock);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void ranking_record_items(gconstpointer provider, gint items)
+{
+    if(provider != NULL && items > 0)
+    {
+        g_static_mutex_lock(&record_lock);
+        get_record(provider)->items += items;
+        g_static_mutex_unlock(&record_lock);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void ranking_merge(gconstpointer provider, const RankingRecord * stored)
+{
+    if(provider != NULL && stored != NULL)
+    {
+        g_static_mutex_lock(&record_lock);
+        RankingRecord * record = get_record(provider);
+        if(stored->transfers > record->transfers)
+        {
+            record->transfers  = stored->transfers;
+            record->successes  = stored->successes;
+            record->items      = stored->items;
+            record->latency_ms = stored->latency_ms;
+        }
+        record->rating = stored->rating;
+        record->rated  = stored->rated;
+        g_static_mutex_unlock(&record_lock);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+gboolean ranking_get(gconstpointer provider, RankingRecord * record)
+{
+    gboolean found = FALSE;
+    g_static_mutex_lock(&record_lock);
+    RankingRecord * known = (record_table) ? g_hash_table_lookup(record_table,provider) : NULL;
+    if(known != NULL)
+    {
+        if(record != NULL)
+        {
+            *record = *known;
+        }
+        found = TRUE;
+    }
+    g_static_mutex_unlock(&record_lock);
+    return found;
+}
+
+/*-----------------------------------------------------------------*/
+
+void ranking_adjust(gconstpointer provider, gint * quality, gint * speed)
+{
+    RankingRecord record;
+    if(ranking_get(provider,&record) == FALSE)
+    {
+        return;
+    }
+
+    if(record.transfers > 0)
+    {
+        /* A provider that fails, or whose results are thrown away, is of no quality to us */
+        gdouble success_rate = (gdouble)record.successes / record.transfers;
+        gdouble yield = (record.successes > 0) ? MIN(1.0,(gdouble)record.items / record.successes) : 0.0;
+        gdouble learned_quality = 100.0 * success_rate * (0.5 + 0.5 * yield);
+
+        /* 1s => 50, 250ms => 80, 5s => 16 */
+        gdouble learned_speed = 100.0 * 1000.0 / (1000.0 + MAX(record.latency_ms,0.0));
+
+        gdouble weight = (gdouble)record.transfers / (record.transfers + RANKING_CONFIDENCE);
+        *quality = (gint)((1.0 - weight) * *quality + weight * learned_quality);
+        *speed   = (gint)((1.0 - weight) * *speed   + weight * learned_speed);
+    }
+
+    if(record.rated > 0)
+    {
+        gdouble weight = (gdouble)record.rated / (record.rated + RANKING_CONFIDENCE);
+        *quality = (gint)((1.0 - weight) * *quality + weight * CLAMP(record.rating,0.0,100.0));
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void ranking_destroy(void)
+{
+    g_static_mutex_lock(&record_lock);
+    if(record_table != NULL)
+    {
+        g_hash_table_destroy(record_table);
+        record_table = NULL;
+    }
+    g_static_mutex_unlock(&record_lock);
+}
+
+/*-----------------------------------------------------------------*/
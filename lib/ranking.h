@@ -0,0 +1,67 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_RANKING_H
+#define GLYR_RANKING_H
+
+#include <glib.h>
+
+/* What glyr learned about a provider while using it.
+ * Kept process wide, and in the GlyrDatabase if one is used.
+ */
+typedef struct {
+    /* Transfers done, and how many of those succeeded */
+    gint64 transfers;
+    gint64 successes;
+
+    /* Items that survived duplicate and format checks */
+    gint64 items;
+
+    /* Moving average of how long a transfer took */
+    gdouble latency_ms;
+
+    /* Mean of the ratings users gave to items in the DB, and how many there are */
+    gdouble rating;
+    gint64 rated;
+} RankingRecord;
+
+/* After this many transfers, learned and builtin ratings weigh the same */
+#define RANKING_CONFIDENCE 20
+
+/* Weight of a new latency sample in the moving average */
+#define RANKING_LATENCY_WEIGHT 0.2
+
+/* provider is only used as key; pass the same pointer each time */
+void ranking_record_transfer(gconstpointer provider, gboolean success, gint64 latency_ms);
+void ranking_record_items(gconstpointer provider, gint items);
+
+/* Take stored counts (e.g. from the DB) if they know more than we do.
+ * The rating is always taken */
+void ranking_merge(gconstpointer provider, const RankingRecord * stored);
+
+/* FALSE if nothing is known about provider */
+gboolean ranking_get(gconstpointer provider, RankingRecord * record);
+
+/* Blend quality and speed [0-100] of a provider with what was learned about it */
+void ranking_adjust(gconstpointer provider, gint * quality, gint * speed);
+
+void ranking_destroy(void);
+
+#endif
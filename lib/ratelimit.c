@@ -0,0 +1,243 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <string.h>
+#include "ratelimit.h"
+
+/* Poll interval if all slots of a host are taken (by other queries maybe) */
+#define RATELIMIT_SLOT_POLL_US (50 * 1000)
+
+/*-----------------------------------------------------------------*/
+
+typedef struct {
+    gdouble rate;       /* tokens per second    */
+    gdouble burst;      /* max. tokens          */
+    gint max_parallel;
+
+    gdouble tokens;
+    gint64 last_refill; /* monotonic, µs        */
+    gint running;
+
+    /* Created from the defaults, follows them */
+    gboolean is_default;
+} HostLimit;
+
+/*-----------------------------------------------------------------*/
+
+/* host => HostLimit */
+static GHashTable * limit_table = NULL;
+static HostLimit default_limit = {0};
+static GStaticMutex limit_lock = G_STATIC_MUTEX_INIT;
+
+/*-----------------------------------------------------------------*/
+
+static gboolean is_unlimited(HostLimit * limit)
+{
+    return limit->rate <= 0 && limit->max_parallel <= 0;
+}
+
+/*-----------------------------------------------------------------*/
+
+static void configure(HostLimit * limit, gdouble rate, gint burst, gint max_parallel)
+{
+    limit->rate = rate;
+    limit->burst = MAX(burst,1);
+    limit->max_parallel = max_parallel;
+    limit->tokens = MIN(limit->tokens,limit->burst);
+}
+
+/*-----------------------------------------------------------------*/
+
+static HostLimit * new_limit(void)
+{
+    HostLimit * limit = g_malloc0(sizeof(HostLimit));
+    limit->last_refill = g_get_monotonic_time();
+    return limit;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* limit_lock must be held */
+static HostLimit * lookup_limit(const gchar * host, gboolean create)
+{
+    if(limit_table == NULL)
+    {
+        limit_table = g_hash_table_new_full(g_str_hash,g_str_equal,g_free,g_free);
+    }
+
+    HostLimit * limit = g_hash_table_lookup(limit_table,host);
+    if(limit == NULL && create == TRUE && is_unlimited(&default_limit) == FALSE)
+    {
+        limit = new_limit();
+        limit->is_default = TRUE;
+        configure(limit,default_limit.rate,default_limit.burst,default_limit.max_parallel);
+        limit->tokens = limit->burst;
+        g_hash_table_insert(limit_table,g_strdup(host),limit);
+    }
+    return limit;
+}
+
+/*-----------------------------------------------------------------*/
+
+void ratelimit_set(const gchar * host, gdouble rate, gint burst, gint max_parallel)
+{
+    g_static_mutex_lock(&limit_lock);
+    if(host == NULL)
+    {
+        configure(&default_limit,rate,burst,max_parallel);
+
+        /* Hosts without own limits follow */
+        if(limit_table != NULL)
+        {
+            GHashTableIter iter;
+            gpointer value;
+            g_hash_table_iter_init(&iter,limit_table);
+            while(g_hash_table_iter_next(&iter,NULL,&value))
+            {
+                HostLimit * limit = value;
+                if(limit->is_default == TRUE)
+                {
+                    configure(limit,rate,burst,max_parallel);
+                }
+            }
+        }
+    }
+    else
+    {
+        gchar * key = g_ascii_strdown(host,-1);
+        HostLimit * limit = lookup_limit(key,FALSE);
+        if(limit == NULL)
+        {
+            limit = new_limit();
+            configure(limit,rate,burst,max_parallel);
+            limit->tokens = limit->burst;
+            g_hash_table_insert(limit_table,key,limit);
+        }
+        else
+        {
+            /* Keep tokens and running transfers */
+            configure(limit,rate,burst,max_parallel);
+            g_free(key);
+        }
+        limit->is_default = FALSE;
+    }
+    g_static_mutex_unlock(&limit_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+void ratelimit_destroy(void)
+{
+    g_static_mutex_lock(&limit_lock);
+    if(limit_table != NULL)
+    {
+        g_hash_table_destroy(limit_table);
+        limit_table = NULL;
+    }
+    memset(&default_limit,0,sizeof(HostLimit));
+    g_static_mutex_unlock(&limit_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+gboolean ratelimit_acquire(const gchar * host, gint64 * retry_us)
+{
+    gboolean result = TRUE;
+    if(host == NULL)
+        return TRUE;
+
+    g_static_mutex_lock(&limit_lock);
+    HostLimit * limit = lookup_limit(host,TRUE);
+    if(limit != NULL)
+    {
+        /* Refill the bucket */
+        gint64 now = g_get_monotonic_time();
+        if(limit->rate > 0)
+        {
+            limit->tokens = MIN(limit->burst,limit->tokens + (now - limit->last_refill) * limit->rate / G_USEC_PER_SEC);
+        }
+        limit->last_refill = now;
+
+        if(limit->max_parallel > 0 && limit->running >= limit->max_parallel)
+        {
+            *retry_us = RATELIMIT_SLOT_POLL_US;
+            result = FALSE;
+        }
+        else if(limit->rate > 0 && limit->tokens < 1.0)
+        {
+            *retry_us = (gint64)((1.0 - limit->tokens) / limit->rate * G_USEC_PER_SEC) + 1;
+            result = FALSE;
+        }
+        else
+        {
+            if(limit->rate > 0)
+            {
+                limit->tokens -= 1.0;
+            }
+            limit->running++;
+        }
+    }
+    g_static_mutex_unlock(&limit_lock);
+    return result;
+}
+
+/*-----------------------------------------------------------------*/
+
+void ratelimit_release(const gchar * host)
+{
+    if(host == NULL)
+        return;
+
+    g_static_mutex_lock(&limit_lock);
+    HostLimit * limit = lookup_limit(host,FALSE);
+    if(limit != NULL && limit->running > 0)
+    {
+        limit->running--;
+    }
+    g_static_mutex_unlock(&limit_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+gchar * ratelimit_host_of(const gchar * url)
+{
+    if(url == NULL)
+        return NULL;
+
+    const gchar * begin = strstr(url,"://");
+    begin = (begin != NULL) ? begin + 3 : url;
+
+    /* user:password@ */
+    const gchar * at = strchr(begin,'@');
+    gsize len = strcspn(begin,"/?#");
+    if(at != NULL && (gsize)(at - begin) < len)
+    {
+        begin = at + 1;
+        len = strcspn(begin,"/?#");
+    }
+
+    /* Port */
+    gsize host_len = strcspn(begin,":/?#");
+    len = MIN(len,host_len);
+
+    return (len > 0) ? g_ascii_strdown(begin,len) : NULL;
+}
+
+/*-----------------------------------------------------------------*/
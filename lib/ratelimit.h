@@ -0,0 +1,46 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_RATELIMIT_H
+#define GLYR_RATELIMIT_H
+
+#include <glib.h>
+
+/* Process wide token buckets and concurrency caps per host,
+ * shared by all queries. Nothing is limited unless configured.
+ */
+
+/* host = NULL sets the default for all hosts without own limits.
+ * rate <= 0 and max_parallel <= 0 mean unlimited.
+ */
+void ratelimit_set(const gchar * host, gdouble rate, gint burst, gint max_parallel);
+void ratelimit_destroy(void);
+
+/* Take a token and a slot for a transfer to host. 
+ * If there is none, FALSE is returned and *retry_us says when to try again.
+ * Every successful call needs a ratelimit_release() once the transfer is done.
+ */
+gboolean ratelimit_acquire(const gchar * host, gint64 * retry_us);
+void ratelimit_release(const gchar * host);
+
+/* "http://www.last.fm:80/x" => "www.last.fm", NULL if there's none */
+gchar * ratelimit_host_of(const gchar * url);
+
+#endif
@@ -21,6 +21,7 @@
 /* register all plugins here */
 #include "core.h"
 #include "register_plugins.h"
+#include "ranking.h"
 
 /* Warning: All functions in here are _not_ threadsafe. */
 static void get_list_from_type(MetaDataFetcher * fetch);
@@ -248,6 +249,11 @@ static void get_list_from_type(MetaDataFetcher * fetch)
 
 static void init_provider_list(void)
 {
+    /* Used as index into a ProviderMask */
+    gint id = 0;
+    for(GList * src = glyrMetaDataSourceList; src; src = src->next)
+        ((MetaDataSource *)(src->data))->id = id++;
+
     for(GList * fetch = glyrMetaDataPluginList; fetch; fetch = fetch->next)
         get_list_from_type((MetaDataFetcher *)(fetch->data));
 }
@@ -347,6 +353,20 @@ GlyrFetcherInfo * get_plugin_info(void)
                 sinfos->lang_aware = source->lang_aware;
                 sinfos->name    = g_strdup(source->name);
 
+                RankingRecord record;
+                if(ranking_get(source,&record) == TRUE)
+                {
+                    sinfos->transfers   = record.transfers;
+                    sinfos->successes   = record.successes;
+                    sinfos->items       = record.items;
+                    sinfos->latency_ms  = (int)record.latency_ms;
+                    sinfos->user_rating = (int)record.rating;
+                }
+
+                sinfos->ranked_quality = source->quality;
+                sinfos->ranked_speed   = source->speed;
+                ranking_adjust(source,&sinfos->ranked_quality,&sinfos->ranked_speed);
+
                 if(prev_source != NULL)
                 {
                     prev_source->next = sinfos;
@@ -0,0 +1,239 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include "resultcache.h"
+#include "stringlib.h"
+#include "stats.h"
+#include "core.h"
+
+/*-----------------------------------------------------------------*/
+
+typedef struct {
+    gchar * key;
+
+    /* Copies of the results, in order */
+    GList * items;
+    gsize size;
+    gint64 expires;
+
+    /* Position in lru_queue */
+    GList * link;
+} ResultEntry;
+
+/* key => ResultEntry; lru_queue has the most recently used first */
+static GHashTable * result_table = NULL;
+static GQueue * lru_queue = NULL;
+static gsize cache_size = 0;
+static GStaticMutex result_lock = G_STATIC_MUTEX_INIT;
+
+static gsize max_cache_size = 0;
+static gint cache_ttl = GLYR_DEFAULT_RESULT_CACHE_TTL;
+
+/*-----------------------------------------------------------------*/
+
+static gchar * build_key(GlyrQuery * q)
+{
+    gchar * artist = prepare_string(q->artist,FALSE,FALSE);
+    gchar * album  = prepare_string(q->album,FALSE,FALSE);
+    gchar * title  = prepare_string(q->title,FALSE,FALSE);
+
+    /* Everything that decides which results are accepted goes in here */
+    gchar * key = g_strdup_printf("%d\n%s\n%s\n%s\n%s\n%d\n%d\n%s\n%s\n%d\n%d\n%d",q->type,
+                                  (artist) ? artist : "",
+                                  (album)  ? album  : "",
+                                  (title)  ? title  : "",
+                                  (q->from) ? q->from : "",
+                                  q->download,
+                                  q->number,
+                                  (q->lang) ? q->lang : "",
+                                  (q->allowed_formats) ? q->allowed_formats : "",
+                                  q->img_min_size,
+                                  q->img_max_size,
+                                  q->force_utf8);
+    g_free(artist);
+    g_free(album);
+    g_free(title);
+    return key;
+}
+
+/*-----------------------------------------------------------------*/
+
+/* result_lock needs to be held */
+static void drop_entry(ResultEntry * entry)
+{
+    g_hash_table_remove(result_table,entry->key);
+    g_queue_delete_link(lru_queue,entry->link);
+    cache_size -= entry->size;
+
+    for(GList * elem = entry->items; elem; elem = elem->next)
+    {
+        DL_free(elem->data);
+    }
+    g_list_free(entry->items);
+    g_free(entry->key);
+    g_free(entry);
+}
+
+/*-----------------------------------------------------------------*/
+
+/* Drop the least recently used ones till it fits; result_lock needs to be held */
+static void make_room(gsize needed)
+{
+    while(lru_queue != NULL && lru_queue->tail != NULL && cache_size + needed > max_cache_size)
+    {
+        drop_entry(lru_queue->tail->data);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void resultcache_configure(gsize max_size, gint ttl)
+{
+    g_static_mutex_lock(&result_lock);
+    max_cache_size = max_size;
+    cache_ttl = (ttl < 0) ? GLYR_DEFAULT_RESULT_CACHE_TTL : ttl;
+    make_room(0);
+    g_static_mutex_unlock(&result_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+GlyrMemCache * resultcache_lookup(GlyrQuery * query, gint * length)
+{
+    GlyrMemCache * head = NULL, * tail = NULL;
+    gint found = 0;
+
+    g_static_mutex_lock(&result_lock);
+    if(max_cache_size > 0 && query != NULL)
+    {
+        gchar * key = build_key(query);
+        ResultEntry * entry = (result_table) ? g_hash_table_lookup(result_table,key) : NULL;
+        g_free(key);
+
+        if(entry != NULL && entry->expires < g_get_monotonic_time())
+        {
+            drop_entry(entry);
+            entry = NULL;
+        }
+
+        if(entry != NULL)
+        {
+            g_queue_unlink(lru_queue,entry->link);
+            g_queue_push_head_link(lru_queue,entry->link);
+
+            for(GList * elem = entry->items; elem; elem = elem->next)
+            {
+                GlyrMemCache * copy = DL_copy(elem->data);
+                copy->prev = tail;
+                if(tail != NULL)
+                {
+                    tail->next = copy;
+                }
+                else
+                {
+                    head = copy;
+                }
+                tail = copy;
+                found++;
+            }
+        }
+        stats_add((head) ? STATS_RESULT_CACHE_HITS : STATS_RESULT_CACHE_MISSES,1);
+    }
+    g_static_mutex_unlock(&result_lock);
+
+    if(length != NULL)
+    {
+        *length = found;
+    }
+    return head;
+}
+
+/*-----------------------------------------------------------------*/
+
+void resultcache_store(GlyrQuery * query, GlyrMemCache * head)
+{
+    if(query == NULL || head == NULL)
+    {
+        return;
+    }
+
+    gsize size = 0;
+    for(GlyrMemCache * item = head; item; item = item->next)
+    {
+        size += sizeof(GlyrMemCache) + item->size;
+    }
+
+    g_static_mutex_lock(&result_lock);
+
+    /* Does not fit at all - do not throw out others for it */
+    if(max_cache_size > 0 && size <= max_cache_size)
+    {
+        if(result_table == NULL)
+        {
+            result_table = g_hash_table_new(g_str_hash,g_str_equal);
+            lru_queue = g_queue_new();
+        }
+
+        ResultEntry * entry = g_malloc0(sizeof(ResultEntry));
+        for(GlyrMemCache * item = head; item; item = item->next)
+        {
+            entry->items = g_list_prepend(entry->items,DL_copy(item));
+        }
+        entry->items = g_list_reverse(entry->items);
+        entry->size = size;
+        entry->key = build_key(query);
+        entry->expires = g_get_monotonic_time() + (gint64)cache_ttl * G_USEC_PER_SEC;
+
+        ResultEntry * old = g_hash_table_lookup(result_table,entry->key);
+        if(old != NULL)
+        {
+            drop_entry(old);
+        }
+
+        make_room(entry->size);
+        g_queue_push_head(lru_queue,entry);
+        entry->link = lru_queue->head;
+        g_hash_table_insert(result_table,entry->key,entry);
+        cache_size += entry->size;
+    }
+    g_static_mutex_unlock(&result_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+void resultcache_destroy(void)
+{
+    g_static_mutex_lock(&result_lock);
+    while(lru_queue != NULL && lru_queue->head != NULL)
+    {
+        drop_entry(lru_queue->head->data);
+    }
+
+    if(result_table != NULL)
+    {
+        g_hash_table_destroy(result_table);
+        g_queue_free(lru_queue);
+        result_table = NULL;
+        lru_queue = NULL;
+    }
+    g_static_mutex_unlock(&result_lock);
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,42 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_RESULTCACHE_H
+#define GLYR_RESULTCACHE_H
+
+#include <glib.h>
+#include "types.h"
+
+/* Process wide cache of the final results of glyr_get(), kept in memory.
+ * Keyed by everything of a query that changes what it finds; 
+ * artist, album and title are normalized with prepare_string().
+ * Disabled as long as max_size is 0.
+ */
+void resultcache_configure(gsize max_size, gint ttl);
+
+/* A copy of what was stored for query, NULL if nothing (fresh) was.
+ * Counts a hit or miss if enabled. */
+GlyrMemCache * resultcache_lookup(GlyrQuery * query, gint * length);
+
+/* Store a copy of the list head; the least recently used results are dropped to make room */
+void resultcache_store(GlyrQuery * query, GlyrMemCache * head);
+void resultcache_destroy(void);
+
+#endif
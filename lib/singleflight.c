@@ -0,0 +1,167 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include "singleflight.h"
+#include "stats.h"
+#include "core.h"
+
+/*-----------------------------------------------------------------*/
+
+struct _Flight
+{
+    gchar * key;
+
+    /* The leader and all followers */
+    gint refcount;
+
+    gboolean done;
+    gboolean abandoned;
+    CURLcode result;
+
+    /* Copy of the leader's result, only made if anybody waits */
+    GlyrMemCache * body;
+
+    /* EventLoops of the followers */
+    GList * waiters;
+};
+
+/*-----------------------------------------------------------------*/
+
+/* key => Flight, only while the download runs */
+static GHashTable * flight_table = NULL;
+static GStaticMutex flight_lock = G_STATIC_MUTEX_INIT;
+
+/*-----------------------------------------------------------------*/
+
+Flight * singleflight_join(const gchar * key, EventLoop * loop, gboolean * leader)
+{
+    g_static_mutex_lock(&flight_lock);
+    if(flight_table == NULL)
+    {
+        flight_table = g_hash_table_new(g_str_hash,g_str_equal);
+    }
+
+    Flight * flight = g_hash_table_lookup(flight_table,key);
+    if(flight == NULL)
+    {
+        flight = g_malloc0(sizeof(Flight));
+        flight->key = g_strdup(key);
+        flight->refcount = 1;
+        g_hash_table_insert(flight_table,flight->key,flight);
+
+        *leader = TRUE;
+        stats_add(STATS_FLIGHTS_STARTED,1);
+    }
+    else
+    {
+        flight->refcount++;
+        flight->waiters = g_list_prepend(flight->waiters,loop);
+
+        *leader = FALSE;
+        stats_add(STATS_FLIGHTS_JOINED,1);
+    }
+    g_static_mutex_unlock(&flight_lock);
+    return flight;
+}
+
+/*-----------------------------------------------------------------*/
+
+void singleflight_complete(Flight * flight, GlyrMemCache * body, CURLcode result, gboolean abandoned)
+{
+    if(flight == NULL)
+        return;
+
+    g_static_mutex_lock(&flight_lock);
+    if(flight->done == FALSE)
+    {
+        flight->done = TRUE;
+        flight->result = result;
+        flight->abandoned = abandoned;
+
+        /* Whoever asks from now on starts a new one */
+        g_hash_table_remove(flight_table,flight->key);
+
+        if(flight->waiters != NULL && abandoned == FALSE)
+        {
+            flight->body = DL_copy(body);
+        }
+
+        for(GList * elem = flight->waiters; elem; elem = elem->next)
+        {
+            eventloop_wakeup(elem->data);
+        }
+    }
+    g_static_mutex_unlock(&flight_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+gboolean singleflight_is_done(Flight * flight)
+{
+    g_static_mutex_lock(&flight_lock);
+    gboolean done = flight->done;
+    g_static_mutex_unlock(&flight_lock);
+    return done;
+}
+
+/*-----------------------------------------------------------------*/
+
+GlyrMemCache * singleflight_take(Flight * flight, EventLoop * loop, CURLcode * result, gboolean * abandoned)
+{
+    g_static_mutex_lock(&flight_lock);
+    *result = flight->result;
+    *abandoned = flight->abandoned;
+    GlyrMemCache * copy = DL_copy(flight->body);
+    g_static_mutex_unlock(&flight_lock);
+
+    singleflight_leave(flight,loop);
+    return copy;
+}
+
+/*-----------------------------------------------------------------*/
+
+void singleflight_leave(Flight * flight, EventLoop * loop)
+{
+    if(flight == NULL)
+        return;
+
+    g_static_mutex_lock(&flight_lock);
+    if(loop != NULL)
+    {
+        flight->waiters = g_list_remove(flight->waiters,loop);
+    }
+
+    if(--flight->refcount == 0)
+    {
+        /* Nobody completed it */
+        if(flight->done == FALSE && g_hash_table_lookup(flight_table,flight->key) == flight)
+        {
+            g_hash_table_remove(flight_table,flight->key);
+        }
+
+        DL_free(flight->body);
+        g_list_free(flight->waiters);
+        g_free(flight->key);
+        g_free(flight);
+    }
+    g_static_mutex_unlock(&flight_lock);
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,57 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_SINGLEFLIGHT_H
+#define GLYR_SINGLEFLIGHT_H
+
+#include <glib.h>
+#include <curl/curl.h>
+
+#include "types.h"
+#include "eventloop.h"
+
+/* Process wide table of running downloads, keyed by URL and options.
+ * The first one to ask for a key (the leader) downloads it,
+ * everybody else asking while it runs gets a copy of the result.
+ */
+typedef struct _Flight Flight;
+
+/* Join the download of key, or start it if there is none.
+ * *leader is TRUE if the caller has to download it and call singleflight_complete().
+ * Followers pass the loop that is woken up once the result is there.
+ */
+Flight * singleflight_join(const gchar * key, EventLoop * loop, gboolean * leader);
+
+/* Leader only: The download is done. body may be NULL on errors, it is copied if needed.
+ * With abandoned = TRUE the followers need to download it themselves. */
+void singleflight_complete(Flight * flight, GlyrMemCache * body, CURLcode result, gboolean abandoned);
+
+/* Followers only */
+gboolean singleflight_is_done(Flight * flight);
+
+/* Followers only: Get a copy of the result, and leave the flight.
+ * Returns NULL if the leader failed (result is set) or gave up (*abandoned is set).
+ */
+GlyrMemCache * singleflight_take(Flight * flight, EventLoop * loop, CURLcode * result, gboolean * abandoned);
+
+/* Leave without any result; loop is NULL for the leader */
+void singleflight_leave(Flight * flight, EventLoop * loop);
+
+#endif
@@ -0,0 +1,84 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <string.h>
+#include "stats.h"
+
+/*-----------------------------------------------------------------*/
+
+static gint64 counters[STATS_LAST];
+static GStaticMutex counter_lock = G_STATIC_MUTEX_INIT;
+
+/*-----------------------------------------------------------------*/
+
+void stats_add(StatsCounter counter, gint64 value)
+{
+    if(counter < STATS_LAST)
+    {
+        g_static_mutex_lock(&counter_lock);
+        counters[counter] += value;
+        g_static_mutex_unlock(&counter_lock);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void stats_max(StatsCounter counter, gint64 value)
+{
+    if(counter < STATS_LAST)
+    {
+        g_static_mutex_lock(&counter_lock);
+        counters[counter] = MAX(counters[counter],value);
+        g_static_mutex_unlock(&counter_lock);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void stats_get(GlyrStats * stats)
+{
+    if(stats != NULL)
+    {
+        g_static_mutex_lock(&counter_lock);
+        stats->flights_started = counters[STATS_FLIGHTS_STARTED];
+        stats->flights_joined  = counters[STATS_FLIGHTS_JOINED];
+        stats->transfers_queued  = counters[STATS_TRANSFERS_QUEUED];
+        stats->queue_wait_ms     = counters[STATS_QUEUE_WAIT_MS];
+        stats->queue_wait_max_ms = counters[STATS_QUEUE_WAIT_MAX_MS];
+        stats->hedges_started    = counters[STATS_HEDGES_STARTED];
+        stats->bytes_received    = counters[STATS_BYTES_RECEIVED];
+        stats->bytes_saved       = counters[STATS_BYTES_SAVED];
+        stats->result_cache_hits   = counters[STATS_RESULT_CACHE_HITS];
+        stats->result_cache_misses = counters[STATS_RESULT_CACHE_MISSES];
+        stats->eventloop_wakeups   = counters[STATS_EVENTLOOP_WAKEUPS];
+        g_static_mutex_unlock(&counter_lock);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void stats_reset(void)
+{
+    g_static_mutex_lock(&counter_lock);
+    memset(counters,0,sizeof(counters));
+    g_static_mutex_unlock(&counter_lock);
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,50 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_STATS_H
+#define GLYR_STATS_H
+
+#include <glib.h>
+#include "types.h"
+
+/* Process wide counters, read by glyr_stats_get() */
+typedef enum {
+    STATS_FLIGHTS_STARTED,
+    STATS_FLIGHTS_JOINED,
+    STATS_TRANSFERS_QUEUED,
+    STATS_QUEUE_WAIT_MS,
+    STATS_QUEUE_WAIT_MAX_MS,
+    STATS_HEDGES_STARTED,
+    STATS_BYTES_RECEIVED,
+    STATS_BYTES_SAVED,
+    STATS_RESULT_CACHE_HITS,
+    STATS_RESULT_CACHE_MISSES,
+    STATS_EVENTLOOP_WAKEUPS,
+    STATS_LAST
+} StatsCounter;
+
+void stats_add(StatsCounter counter, gint64 value);
+
+/* Set counter to value, if it's bigger */
+void stats_max(StatsCounter counter, gint64 value);
+void stats_get(GlyrStats * stats);
+void stats_reset(void);
+
+#endif
@@ -27,6 +27,7 @@
 #include "stringlib.h"
 #include "core.h"
 #include "types.h"
+#include "trace.h"
 
 /* Implementation of the Levenshtein distance algorithm
  * Compare the number of edits needed to convert string $s
@@ -98,6 +99,7 @@ gsize levenshtein_safe_strcmp(const gchar * s, const gchar * t)
        g_utf8_validate(t,-1,NULL) == FALSE)
      return rc;
 
+    gint64 clock = trace_fuzzy_enter();
     gchar * s_norm = g_utf8_normalize(s,-1,G_NORMALIZE_ALL_COMPOSE);
     gchar * t_norm = g_utf8_normalize(t,-1,G_NORMALIZE_ALL_COMPOSE);
 
@@ -106,6 +108,7 @@ gsize levenshtein_safe_strcmp(const gchar * s, const gchar * t)
     g_free(s_norm);
     g_free(t_norm);
 
+    trace_fuzzy_leave(clock);
     return rc;
 }
 
@@ -187,6 +190,7 @@ gchar * regex_replace_by_table(const gchar * string, const gchar * const delete_
 gsize levenshtein_strcasecmp(const gchar * string, const gchar * other)
 {
     gsize diff = 100;
+    gint64 clock = trace_fuzzy_enter();
     if(string != NULL && other != NULL)
     {
         /* Lowercase UTF8 string might have more or less bytes! */
@@ -201,6 +205,7 @@ gsize levenshtein_strcasecmp(const gchar * string, const gchar * other)
         g_free(lower_string);
         g_free(lower_other);
     }
+    trace_fuzzy_leave(clock);
     return diff;
 }
 
@@ -234,6 +239,7 @@ static gchar * leven_normalize_string(const gchar * str)
 gsize levenshtein_strnormcmp(GlyrQuery * settings, const gchar * string, const gchar * other)
 {
     gsize diff = 100;
+    gint64 clock = trace_fuzzy_enter();
     if(string != NULL && other != NULL)
     {
         gchar * normalized_string = leven_normalize_string(string);
@@ -263,6 +269,7 @@ gsize levenshtein_strnormcmp(GlyrQuery * settings, const gchar * string, const g
         g_free(normalized_string);
         g_free(normalized_other);
     }
+    trace_fuzzy_leave(clock);
     return diff;
 }
 
@@ -63,7 +63,7 @@ const char * glyr_testing_call_url(const char * provider_name, GLYR_GET_TYPE typ
             const char * url = src->get_url(query);
             if(url != NULL)
             {
-                result = prepare_url(url,query,TRUE);
+                result = prepare_url(STRIP_KNOWN_PAGE_MARK(url),query,TRUE);
 
                 if(src->free_url)
                 {
@@ -78,7 +78,258 @@ const char * glyr_testing_call_url(const char * provider_name, GLYR_GET_TYPE typ
 /*-----------------------------------*/
 
 __attribute__((visibility("default")))
-GlyrMemCache * glyr_testing_call_parser(const char * provider_name, GLYR_GET_TYPE type, GlyrQuery * query, GlyrMemCache * cache)
+int glyr_testing_queue_providers(GLYR_GET_TYPE type, GlyrQuery * query)
+{
+    if(query == NULL)
+    {
+        return -1;
+    }
+
+    for(GList * elem = r_getFList(); elem; elem = elem->next)
+    {
+        MetaDataFetcher * fetcher = elem->data;
+        if(fetcher != NULL && fetcher->type == type)
+        {
+            return queue_all_providers(query,fetcher);
+        }
+    }
+    return -1;
+}
+
+/*-----------------------------------*/
+
+/* Stand-ins for the providers of glyr_testing_fetch_providers(); never freed,
+ * the latency windows of the providers are keyed by their address */
+#define TESTING_MAX_PROVIDERS 64
+static MetaDataSource testing_sources[TESTING_MAX_PROVIDERS];
+
+typedef struct {
+    const char ** urls;
+    gint n;
+    gint next;
+} TestingProviders;
+
+/*-----------------------------------*/
+
+/* AsyncDLCB: every download is an item */
+static GList * testing_count_item(cb_object * capo, void * userptr, bool * stop_download, gint * to_add)
+{
+    if(capo->cache != NULL && capo->cache->size > 0)
+    {
+        g_atomic_int_inc(&capo->s->itemctr);
+        *stop_download = (g_atomic_int_get(&capo->s->itemctr) >= capo->s->number);
+    }
+    return NULL;
+}
+
+/*-----------------------------------*/
+
+/* AsyncProviderCB: the next URL is the next provider */
+static gboolean testing_next_provider(void * userptr, gchar ** url, gchar ** endmark, MetaDataSource ** source)
+{
+    TestingProviders * providers = userptr;
+    if(providers->next >= providers->n)
+    {
+        return FALSE;
+    }
+
+    *url = (gchar*)providers->urls[providers->next];
+    *endmark = NULL;
+    *source = &testing_sources[providers->next];
+    providers->next++;
+    return TRUE;
+}
+
+/*-----------------------------------*/
+
+/* The next (at most) count providers, as lists for async_download() */
+static void testing_take_providers(TestingProviders * providers, gint count, GList ** urls, GList ** endmarks, GList ** sources)
+{
+    gchar * url = NULL, * endmark = NULL;
+    MetaDataSource * source = NULL;
+    while(count-- > 0 && testing_next_provider(providers,&url,&endmark,&source) == TRUE)
+    {
+        *urls = g_list_append(*urls,url);
+        *endmarks = g_list_append(*endmarks,endmark);
+        *sources = g_list_append(*sources,source);
+    }
+}
+
+/*-----------------------------------*/
+
+__attribute__((visibility("default")))
+int glyr_testing_fetch_providers(GlyrQuery * query, const char ** urls, int n, bool waves)
+{
+    if(query == NULL || urls == NULL || n <= 0 || n > TESTING_MAX_PROVIDERS || query->parallel <= 0)
+    {
+        return -1;
+    }
+
+    for(gint i = 0; i < n; i++)
+    {
+        testing_sources[i].name = "testing";
+        testing_sources[i].id = -1;
+    }
+
+    TestingProviders providers = {
+        .urls = urls,
+        .n = n,
+        .next = 0
+    };
+
+    query->itemctr = 0;
+    do
+    {
+        GList * url_list = NULL, * endmark_list = NULL, * source_list = NULL;
+        testing_take_providers(&providers,query->parallel,&url_list,&endmark_list,&source_list);
+
+        /* Waves: the next ones start once all of these are done, like glyr did before */
+        async_download(url_list,endmark_list,source_list,query,1,1,testing_count_item,NULL,
+                       (waves) ? NULL : testing_next_provider,&providers,TRUE,FALSE);
+
+        g_list_free(url_list);
+        g_list_free(endmark_list);
+        g_list_free(source_list);
+    }
+    while(waves && providers.next < n && query->itemctr < query->number);
+
+    return query->itemctr;
+}
+
+/*-----------------------------------*/
+
+__attribute__((visibility("default")))
+int glyr_testing_fetch(GlyrQuery * query, const char ** urls, int n)
+{
+    if(query == NULL || urls == NULL || n <= 0)
+    {
+        return -1;
+    }
+
+    GList * url_list = NULL;
+    for(gint i = 0; i < n; i++)
+    {
+        url_list = g_list_prepend(url_list,(gchar*)urls[i]);
+    }
+
+    /* All of them are added to the multihandle at once */
+    query->itemctr = 0;
+    async_download(url_list,NULL,NULL,query,1,1,testing_count_item,NULL,NULL,NULL,TRUE,FALSE);
+    g_list_free(url_list);
+
+    return query->itemctr;
+}
+
+/*-----------------------------------*/
+
+/* What glyr_testing_fetch_batch() passes to batch_run() */
+typedef struct {
+    GlyrQuery ** queries;
+    gint n;
+    const char ** urls;
+    gint per_query;
+    volatile gint fetched;
+} TestingBatch;
+
+/*-----------------------------------*/
+
+/* BatchRunner: the i-th query fetches the i-th slice of the urls */
+static GlyrMemCache * testing_fetch_slice(GlyrQuery * query, GLYR_ERROR * error, int * length, void * runner_data)
+{
+    TestingBatch * batch = runner_data;
+    for(gint i = 0; i < batch->n; i++)
+    {
+        if(batch->queries[i] == query)
+        {
+            gint fetched = glyr_testing_fetch(query,batch->urls + i * batch->per_query,batch->per_query);
+            g_atomic_int_add(&batch->fetched,MAX(fetched,0));
+        }
+    }
+
+    *error = GLYRE_OK;
+    *length = 0;
+    return NULL;
+}
+
+/*-----------------------------------*/
+
+__attribute__((visibility("default")))
+int glyr_testing_fetch_batch(GlyrQuery ** queries, int n, int max_parallel, const char ** urls, int per_query)
+{
+    if(queries == NULL || urls == NULL || n <= 0 || per_query <= 0)
+    {
+        return -1;
+    }
+
+    TestingBatch batch = {
+        .queries = queries,
+        .n = n,
+        .urls = urls,
+        .per_query = per_query,
+        .fetched = 0
+    };
+
+    batch_run(queries,n,max_parallel,testing_fetch_slice,&batch,NULL,NULL);
+    return batch.fetched;
+}
+
+/*-----------------------------------*/
+
+__attribute__((visibility("default")))
+GlyrMemCache * glyr_testing_buffer(const char * body, size_t size, size_t chunk, const char * endmarker)
+{
+    if(body == NULL)
+    {
+        return NULL;
+    }
+    return DL_buffer_replay(body,size,chunk,endmarker);
+}
+
+/*-----------------------------------*/
+
+/* Run the follow-ups capo asked for right away, instead of on a multihandle.
+ * With pages their bodies are taken from there, one after another, downloaded otherwise */
+static GList * run_followups(cb_object * capo, GlyrMemCache *** pages)
+{
+    GList * result_list = NULL;
+    capo->followups = g_list_reverse(capo->followups);
+    for(GList * elem = capo->followups; elem; elem = elem->next)
+    {
+        cb_object * child = elem->data;
+        if(pages == NULL)
+        {
+            child->cache = download_single(child->url,child->s,child->endmark);
+        }
+        else if(**pages != NULL)
+        {
+            /* Received like a download would be, stopping at the endmark */
+            child->cache = DL_buffer_replay((**pages)->data,(**pages)->size,(**pages)->size,child->endmark);
+            (*pages)++;
+        }
+
+        if(child->cache != NULL)
+        {
+            result_list = g_list_concat(result_list,child->continuation(child,child->cont_userdata));
+            result_list = g_list_concat(result_list,run_followups(child,pages));
+        }
+
+        if(child->cont_free != NULL && child->cont_userdata != NULL)
+        {
+            child->cont_free(child->cont_userdata);
+        }
+        DL_free(child->cache);
+        g_free(child->url);
+        g_free(child);
+    }
+
+    g_list_free(capo->followups);
+    capo->followups = NULL;
+    return result_list;
+}
+
+/*-----------------------------------*/
+
+static GlyrMemCache * call_parser(const char * provider_name, GLYR_GET_TYPE type, GlyrQuery * query, GlyrMemCache * cache, GlyrMemCache ** pages)
 {
     GlyrMemCache * result = NULL;
     if(query && cache)
@@ -87,9 +338,11 @@ GlyrMemCache * glyr_testing_call_parser(const char * provider_name, GLYR_GET_TYP
         if(src != NULL)
         {
             cb_object fake;
+            memset(&fake,0,sizeof(cb_object));
             fake.cache = cache;
             fake.s     = query;
             GList * result_list = src->parser(&fake);
+            result_list = g_list_concat(result_list,run_followups(&fake,(pages) ? &pages : NULL));
 
             if(result_list != NULL)
             {
@@ -114,3 +367,20 @@ GlyrMemCache * glyr_testing_call_parser(const char * provider_name, GLYR_GET_TYP
 }
 
 /*-----------------------------------*/
+
+__attribute__((visibility("default")))
+GlyrMemCache * glyr_testing_call_parser(const char * provider_name, GLYR_GET_TYPE type, GlyrQuery * query, GlyrMemCache * cache)
+{
+    return call_parser(provider_name,type,query,cache,NULL);
+}
+
+/*-----------------------------------*/
+
+__attribute__((visibility("default")))
+GlyrMemCache * glyr_testing_call_parser_canned(const char * provider_name, GLYR_GET_TYPE type, GlyrQuery * query, GlyrMemCache * cache, GlyrMemCache ** pages)
+{
+    GlyrMemCache * no_pages = NULL;
+    return call_parser(provider_name,type,query,cache,(pages) ? pages : &no_pages);
+}
+
+/*-----------------------------------*/
@@ -61,12 +61,100 @@ const char * glyr_testing_call_url(const char * provider_name, GLYR_GET_TYPE typ
  * @cache: Parseable Input to the parser (e.g. a HTML-page)
  *
  * Call a certain parser. Example: ("google",GLYR_GET_COVERART,&query,pagesource_cache); 
+ * Pages the parser wants to follow up on are downloaded right away, and handed to its continuation.
  * This is meant for testing purpose only.
  *
  * Returns: A list of more or less finished items. 
  **/
 GlyrMemCache * glyr_testing_call_parser(const char * provider_name, GLYR_GET_TYPE type, GlyrQuery * query, GlyrMemCache * cache);
 
+/**
+ * glyr_testing_call_parser_canned:
+ * @provider_name: Which provider to ask
+ * @type: What type the provider belongs to
+ * @query: What exactly to search for
+ * @cache: Parseable Input to the parser (e.g. a HTML-page)
+ * @pages: %NULL terminated array of bodies for the pages the parser follows up on, in that order
+ *
+ * Like glyr_testing_call_parser(), but nothing is downloaded: 
+ * The follow-ups get the bodies in @pages, cut at their endmarker.
+ * Follow-ups beyond the end of @pages are dropped.
+ * This is meant for testing purpose only.
+ *
+ * Returns: A list of more or less finished items. 
+ **/
+GlyrMemCache * glyr_testing_call_parser_canned(const char * provider_name, GLYR_GET_TYPE type, GlyrQuery * query, GlyrMemCache * cache, GlyrMemCache ** pages);
+
+/**
+ * glyr_testing_queue_providers:
+ * @type: Whose providers to queue
+ * @query: Query whose settings (e.g. glyr_opt_from() and glyr_opt_parallel()) select them
+ *
+ * Pick the providers of @type batch by batch, like glyr_get() does, but without downloading anything.
+ * This is meant for testing and benchmarking purpose only.
+ *
+ * Returns: How many providers were picked, -1 if @type is unknown
+ **/
+int glyr_testing_queue_providers(GLYR_GET_TYPE type, GlyrQuery * query);
+
+/**
+ * glyr_testing_fetch_providers:
+ * @query: Its number is how many items are wanted, its parallel how many providers run at once
+ * @urls: One URL per made-up provider, each download counts as one item
+ * @n: Number of @urls, at most 64
+ * @waves: Start the next providers only once all running ones are done, like glyr did before
+ *
+ * Run the provider scheduler of glyr_get() on made-up providers, e.g. a local HTTP server.
+ * This is meant for testing and benchmarking purpose only.
+ *
+ * Returns: How many items were found, -1 on bad arguments
+ **/
+int glyr_testing_fetch_providers(GlyrQuery * query, const char ** urls, int n, bool waves);
+
+/**
+ * glyr_testing_fetch:
+ * @query: Its number is how many downloads are enough, its timeout applies to all of them
+ * @urls: The URLs to download, each non-empty download counts as one item
+ * @n: Number of @urls
+ *
+ * Download all @urls on one event loop, like the downloads of a single provider batch.
+ * How many run at once is bounded by glyr_set_connection_pool().
+ * This is meant for testing and benchmarking purpose only.
+ *
+ * Returns: How many downloads succeeded, -1 on bad arguments
+ **/
+int glyr_testing_fetch(GlyrQuery * query, const char ** urls, int n);
+
+/**
+ * glyr_testing_fetch_batch:
+ * @queries: Like for glyr_get_batch(), none may be %NULL
+ * @n: Number of @queries
+ * @max_parallel: Like for glyr_get_batch()
+ * @urls: @per_query URLs for every query, the ones of the first query first
+ * @per_query: How many URLs each query downloads
+ *
+ * Like glyr_get_batch(), but every query runs glyr_testing_fetch() on its part of @urls
+ * instead of glyr_get(), so all of them share one download engine.
+ * This is meant for testing and benchmarking purpose only.
+ *
+ * Returns: How many downloads succeeded, -1 on bad arguments
+ **/
+int glyr_testing_fetch_batch(GlyrQuery ** queries, int n, int max_parallel, const char ** urls, int per_query);
+
+/**
+ * glyr_testing_buffer:
+ * @body: What the server would send
+ * @size: Length of @body in bytes
+ * @chunk: Size of the pieces @body is received in
+ * @endmarker: Stop once this was received, may be %NULL
+ *
+ * Receive @body in pieces of @chunk bytes, the same way as a download does.
+ * This is meant for testing and benchmarking purpose only.
+ *
+ * Returns: What was received; free with glyr_cache_free()
+ **/
+GlyrMemCache * glyr_testing_buffer(const char * body, size_t size, size_t chunk, const char * endmarker);
+
 
 #ifdef __cplusplus
 }
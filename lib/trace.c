@@ -0,0 +1,164 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include "trace.h"
+#include "core.h"
+
+/*-----------------------------------------------------------------*/
+
+static GStaticMutex trace_lock = G_STATIC_MUTEX_INIT;
+
+/* Per thread, only set between trace_fuzzy_start() and trace_fuzzy_stop() */
+typedef struct {
+    gint64 spent;
+    gint depth;
+} FuzzyClock;
+
+static GStaticPrivate fuzzy_clock = G_STATIC_PRIVATE_INIT;
+
+/*-----------------------------------------------------------------*/
+
+gboolean trace_enabled(GlyrQuery * s)
+{
+    return (s != NULL && s->trace.span != NULL);
+}
+
+/*-----------------------------------------------------------------*/
+
+void trace_span(GlyrQuery * s, GLYR_TRACE_PHASE phase, const gchar * provider, const gchar * url, gint64 start, gint64 end, gint items)
+{
+    if(trace_enabled(s) == FALSE)
+    {
+        return;
+    }
+
+    GlyrTraceSpan span = {
+        .phase = phase,
+        .provider = provider,
+        .url = url,
+        .start = start,
+        .end = MAX(start,end),
+        .items = items
+    };
+
+    g_static_mutex_lock(&trace_lock);
+    s->trace.span(&span,CALLBACK_QUERY(s));
+    g_static_mutex_unlock(&trace_lock);
+}
+
+/*-----------------------------------------------------------------*/
+
+void trace_transfer(GlyrQuery * s, CURL * handle, const gchar * provider, gint64 started)
+{
+    if(trace_enabled(s) == FALSE || handle == NULL)
+    {
+        return;
+    }
+
+    /* All of them are µs since the transfer started, each including the ones before */
+    curl_off_t namelookup = 0, connect = 0, appconnect = 0, pretransfer = 0, starttransfer = 0, total = 0;
+    curl_easy_getinfo(handle,CURLINFO_NAMELOOKUP_TIME_T,&namelookup);
+    curl_easy_getinfo(handle,CURLINFO_CONNECT_TIME_T,&connect);
+    curl_easy_getinfo(handle,CURLINFO_APPCONNECT_TIME_T,&appconnect);
+    curl_easy_getinfo(handle,CURLINFO_PRETRANSFER_TIME_T,&pretransfer);
+    curl_easy_getinfo(handle,CURLINFO_STARTTRANSFER_TIME_T,&starttransfer);
+    curl_easy_getinfo(handle,CURLINFO_TOTAL_TIME_T,&total);
+
+    gchar * url = NULL;
+    curl_easy_getinfo(handle,CURLINFO_EFFECTIVE_URL,&url);
+
+    if(started <= 0)
+    {
+        started = g_get_monotonic_time() - total;
+    }
+
+    trace_span(s,GLYR_TRACE_DOWNLOAD,provider,url,started,started + total,-1);
+
+    /* Reused connections skip name lookup and connect, those are 0 then */
+    if(namelookup > 0)
+    {
+        trace_span(s,GLYR_TRACE_DNS,provider,url,started,started + namelookup,-1);
+    }
+    if(connect > namelookup)
+    {
+        trace_span(s,GLYR_TRACE_CONNECT,provider,url,started + namelookup,started + connect,-1);
+    }
+    if(appconnect > connect)
+    {
+        trace_span(s,GLYR_TRACE_TLS,provider,url,started + connect,started + appconnect,-1);
+    }
+    if(starttransfer > 0)
+    {
+        trace_span(s,GLYR_TRACE_WAIT,provider,url,started + pretransfer,started + starttransfer,-1);
+        trace_span(s,GLYR_TRACE_TRANSFER,provider,url,started + starttransfer,started + total,-1);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+void trace_fuzzy_start(GlyrQuery * s)
+{
+    if(trace_enabled(s) == TRUE)
+    {
+        g_static_private_set(&fuzzy_clock,g_malloc0(sizeof(FuzzyClock)),g_free);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+
+gint64 trace_fuzzy_stop(void)
+{
+    gint64 spent = 0;
+    FuzzyClock * clock = g_static_private_get(&fuzzy_clock);
+    if(clock != NULL)
+    {
+        spent = clock->spent;
+        g_static_private_set(&fuzzy_clock,NULL,NULL);
+    }
+    return spent;
+}
+
+/*-----------------------------------------------------------------*/
+
+gint64 trace_fuzzy_enter(void)
+{
+    FuzzyClock * clock = g_static_private_get(&fuzzy_clock);
+    if(clock == NULL || clock->depth++ > 0)
+    {
+        /* Not traced, or already counted by the outer call */
+        return 0;
+    }
+    return g_get_monotonic_time();
+}
+
+/*-----------------------------------------------------------------*/
+
+void trace_fuzzy_leave(gint64 entered)
+{
+    FuzzyClock * clock = g_static_private_get(&fuzzy_clock);
+    if(clock != NULL)
+    {
+        clock->depth--;
+        if(entered > 0)
+        {
+            clock->spent += g_get_monotonic_time() - entered;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnadline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_TRACE_H
+#define GLYR_TRACE_H
+
+#include <glib.h>
+#include <curl/curl.h>
+#include "types.h"
+
+/* Passes spans to the callback set by glyr_opt_trace_callback().
+ * Calls are serialized, since parsers and download_single() run in other threads.
+ * All timestamps are g_get_monotonic_time() µs.
+ */
+
+gboolean trace_enabled(GlyrQuery * s);
+void trace_span(GlyrQuery * s, GLYR_TRACE_PHASE phase, const gchar * provider, const gchar * url, gint64 start, gint64 end, gint items);
+
+/* GLYR_TRACE_DOWNLOAD and the network phases of the finished transfer of handle,
+ * which was started at started, or is assumed to have ended just now if that is 0 */
+void trace_transfer(GlyrQuery * s, CURL * handle, const gchar * provider, gint64 started);
+
+/* Time the calling thread spends in the levenshtein_*() functions in between
+ * is summed up, if s is traced; trace_fuzzy_stop() returns it in µs.
+ * The levenshtein_*() functions wrap themselves with trace_fuzzy_enter() / trace_fuzzy_leave().
+ */
+void trace_fuzzy_start(GlyrQuery * s);
+gint64 trace_fuzzy_stop(void);
+gint64 trace_fuzzy_enter(void);
+void trace_fuzzy_leave(gint64 entered);
+
+#endif
@@ -65,6 +65,27 @@ extern "C"
 #define GLYR_DEFAULT_MUISCTREE_PATH NULL
 #define GLYR_DEFAULT_SUPPORTED_LANGS "en;de;fr;es;it;jp;pl;pt;ru;sv;tr;zh"
 #define GLYR_DEFAULT_LANG_AWARE_ONLY false
+#define GLYR_DEFAULT_SNIFF_FORMATS false
+#define GLYR_DEFAULT_HEDGE false
+#define GLYR_DEFAULT_DEADLINE 0
+
+/* Connectionpool shared by all queries */
+#define GLYR_DEFAULT_POOL_SIZE 32
+#define GLYR_DEFAULT_POOL_IDLE 120
+
+/* Cache of raw responses, see glyr_set_http_cache() */
+#define GLYR_DEFAULT_HTTP_CACHE_SIZE (64 * 1024 * 1024)
+#define GLYR_DEFAULT_HTTP_CACHE_TTL 3600
+#define GLYR_HTTP_CACHE_FILENAME "http_cache.db"
+
+/* Seconds results are kept by glyr_set_result_cache() */
+#define GLYR_DEFAULT_RESULT_CACHE_TTL 60
+
+/* Tokens a host may save up, see glyr_set_host_limit() */
+#define GLYR_DEFAULT_HOST_BURST 1
+
+/* Queries glyr_get_batch() runs at the same time */
+#define GLYR_DEFAULT_BATCH_PARALLEL 8
 
 /* Disallow *.gif, mostly bad quality
  * jpeg and jpg, because some not standardaware
@@ -95,6 +116,7 @@ extern "C"
  * @GLYRE_STOP_PRE: Will stop searching, but won't add the current item
  * @GLYRE_NO_INIT: Library has not been initialized with glyr_init() yet
  * @GLYRE_WAS_STOPPED: Library was stopped by glyr_signal_exit()  
+ * @GLYRE_DEADLINE: The time given by glyr_opt_deadline() ran out; the results found until then are returned
  *
  * All errors you can get, via glyr_get() and the glyr_opt_* calls.
  * 
@@ -115,7 +137,8 @@ typedef enum
     GLYRE_STOP_POST,  
     GLYRE_STOP_PRE,   
     GLYRE_NO_INIT,
-    GLYRE_WAS_STOPPED    
+    GLYRE_WAS_STOPPED,
+    GLYRE_DEADLINE
 }   GLYR_ERROR;
 
 /**
@@ -253,6 +276,8 @@ typedef enum
  * @rating: Always set to 0, you can set this to rate this item. For use in the Database.
  * @is_image: Is this item an image?
  * @img_format: Format of the image (png,jpeg), NULL if text item.
+ * @img_width: Width of the image in pixels, 0 if unknown or text item.
+ * @img_height: Height of the image in pixels, 0 if unknown or text item.
  * @md5sum: A md5sum of the data field.
  * @cached: If this cache was locally cached.
  * @timestamp: This is used internally by libglyr.
@@ -276,6 +301,8 @@ typedef struct _GlyrMemCache {
   int  rating;
   bool is_image;    
   char * img_format; 
+  int img_width;
+  int img_height;
   unsigned char md5sum[16]; 
   bool cached;
   double timestamp;
@@ -301,6 +328,62 @@ typedef struct _GlyrDatabase {
 
 } GlyrDatabase;
 
+/**
+ * GLYR_TRACE_PHASE:
+ * @GLYR_TRACE_QUERY: The whole glyr_get() call
+ * @GLYR_TRACE_DOWNLOAD: One download, from its start till the last byte
+ * @GLYR_TRACE_DNS: Name lookup of a download
+ * @GLYR_TRACE_CONNECT: Connecting to the server
+ * @GLYR_TRACE_TLS: TLS handshake, on https only
+ * @GLYR_TRACE_WAIT: Time from sending the request to the first byte of the answer
+ * @GLYR_TRACE_TRANSFER: Receiving the answer
+ * @GLYR_TRACE_PARSE: A provider's parser working on a download
+ * @GLYR_TRACE_FUZZY: The time a parser spent comparing strings (levenshtein), summed up
+ * @GLYR_TRACE_PROBE: Checking the format of image URLs a parser found
+ * @GLYR_TRACE_DB_LOOKUP: Checking if found items are in the local database already
+ * @GLYR_TRACE_FINALIZE: Merging and sorting the items of all providers
+ * @GLYR_TRACE_DB_INSERT: Writing the results to the local database
+ *
+ * What a #GlyrTraceSpan is about, see glyr_opt_trace_callback().
+ */
+typedef enum 
+{
+    GLYR_TRACE_QUERY,
+    GLYR_TRACE_DOWNLOAD,
+    GLYR_TRACE_DNS,
+    GLYR_TRACE_CONNECT,
+    GLYR_TRACE_TLS,
+    GLYR_TRACE_WAIT,
+    GLYR_TRACE_TRANSFER,
+    GLYR_TRACE_PARSE,
+    GLYR_TRACE_FUZZY,
+    GLYR_TRACE_PROBE,
+    GLYR_TRACE_DB_LOOKUP,
+    GLYR_TRACE_FINALIZE,
+    GLYR_TRACE_DB_INSERT
+} GLYR_TRACE_PHASE;
+
+/**
+ * GlyrTraceSpan:
+ * @phase: What was done.
+ * @provider: Name of the provider this was done for, or NULL for the query as a whole.
+ * @url: The URL downloaded, for the network phases; NULL otherwise.
+ * @start: When it started, in µs of a monotonic clock (see g_get_monotonic_time())
+ * @end: When it ended, same clock; for #GLYR_TRACE_FUZZY this is @start plus the time summed up.
+ * @items: The number of items it resulted in, or -1 if that does not apply.
+ *
+ * One timed step of a glyr_get() call, passed to the callback set by glyr_opt_trace_callback().
+ * Only valid during the call.
+ */
+typedef struct _GlyrTraceSpan {
+    GLYR_TRACE_PHASE phase;
+    const char * provider;
+    const char * url;
+    long long start;
+    long long end;
+    int items;
+} GlyrTraceSpan;
+
 /**
 * GlyrQuery:
 * @type: The type of metadata to get.
@@ -320,6 +403,9 @@ typedef struct _GlyrDatabase {
 * @db_autowrite: Write found items automagically to the cache, if any specified by glyr_opt_lookup_db()
 * @local_db: The database to write and search in.
 * @lang_aware_only: Use only providers that deliver language specific content.
+* @sniff_formats: Check imageformats on the download itself, instead of asking the server first.
+* @hedge: Start the next provider already, if the current ones are slower than usual.
+* @deadline: Milliseconds glyr_get() may take at most, 0 for no limit.
 * @signal_exit: By default false, but true when stopping searching is required.
 * @lang: Language code ISO-639-1, like 'de','en' or 'auto'
 * @proxy: The proxy to use.
@@ -363,6 +449,9 @@ typedef struct _GlyrQuery {
     GlyrDatabase * local_db;
 
     bool lang_aware_only;
+    bool sniff_formats;
+    bool hedge;
+    int deadline;
 
     /* Signal conditions */
     volatile int signal_exit;
@@ -383,6 +472,11 @@ typedef struct _GlyrQuery {
          GLYR_ERROR (* download)(GlyrMemCache * dl, struct _GlyrQuery * s);
          void  * user_pointer;
     } callback;
+
+    struct {
+         void (* span)(const GlyrTraceSpan * span, struct _GlyrQuery * s);
+         void  * user_pointer;
+    } trace;
 #endif 
 
     /*< private >*/
@@ -390,6 +484,10 @@ typedef struct _GlyrQuery {
     char * info[10]; /*!< Do not use! - A register where porinters to all dynamic alloc. fields are saved. Do not use. */
     bool imagejob; /*! Do not use! - Wether this query will get images or urls to them */
     long is_initalized; /* Do not use! - Wether this query was initialized correctly */
+    void * from_mask; /* Do not use! - The compiled version of from */
+    long long deadline_at; /* Do not use! - When deadline runs out, in monotonic µs, or 0 */
+    struct _GlyrQuery * origin; /* Do not use! - The query this one was copied from by glyr_get_multi(), or NULL */
+    void * engine; /* Do not use! - The Engine its transfers run on while in glyr_get_batch(), or NULL */
 
 } GlyrQuery;
 
@@ -401,10 +499,19 @@ typedef struct _GlyrQuery {
  * @quality: A quality rating from 0-100
  * @speed: A speed rating form 0
  * @lang_aware: Does this provider offer language specific content?
+ * @transfers: Number of downloads done for this provider.
+ * @successes: How many of those succeeded.
+ * @items: Number of items it delivered, that were no duplicates and had the right format.
+ * @latency_ms: Moving average of the time a download took.
+ * @user_rating: Mean of the ratings given to its items in the database, 0 if none.
+ * @ranked_quality: @quality, as corrected by the stats above. Used to choose providers.
+ * @ranked_speed: @speed, as corrected by the stats above. Used to choose providers.
  * @next: A pointer to the next provider.
  * @prev: A pointer to the previous provider.
  *
  * Represents a provider. 
+ * The stats are counted since glyr_init(), 
+ * or loaded from a database opened with glyr_db_init(), which is updated by every glyr_get() using it.
  * It's a simpler version of the internal version,
  * with statically allocated data only,
  * therefore you can modify and read to your liking.
@@ -421,6 +528,14 @@ typedef struct _GlyrSourceInfo {
   int speed;
   bool lang_aware;
 
+  long transfers;
+  long successes;
+  long items;
+  int latency_ms;
+  int user_rating;
+  int ranked_quality;
+  int ranked_speed;
+
   struct _GlyrSourceInfo * next;
   struct _GlyrSourceInfo * prev;
 } GlyrSourceInfo;
@@ -455,6 +570,86 @@ typedef struct _GlyrFetcherInfo {
   struct _GlyrFetcherInfo * prev;
 } GlyrFetcherInfo;
 
+/**
+ * GlyrStats:
+ * @flights_started: Number of downloads started, that others could have joined.
+ * @flights_joined: Number of downloads, that were attached to an identical one already running.
+ * @transfers_queued: Number of transfers, that had to wait due to the limits of glyr_set_host_limit().
+ * @queue_wait_ms: Total time in ms those transfers waited.
+ * @queue_wait_max_ms: The longest time in ms a single transfer waited.
+ * @hedges_started: Number of providers started early, because others were too slow. See glyr_opt_hedge().
+ * @bytes_received: Number of bytes downloaded.
+ * @bytes_saved: Number of bytes not downloaded, because transfers were cancelled once enough items were found, or the query was stopped. Only counts transfers whose size was known.
+ * @result_cache_hits: Number of glyr_get() calls answered by the cache of glyr_set_result_cache().
+ * @result_cache_misses: Number of glyr_get() calls that had to search, while that cache was enabled.
+ * @eventloop_wakeups: Number of times the download loops woke up, to act on sockets or timeouts.
+ *
+ * Statistics of the download engine, counting all queries since glyr_init() or glyr_stats_reset().
+ * Fill it with glyr_stats_get().
+ */
+typedef struct _GlyrStats {
+  long flights_started;
+  long flights_joined;
+  long transfers_queued;
+  long queue_wait_ms;
+  long queue_wait_max_ms;
+  long hedges_started;
+  long bytes_received;
+  long bytes_saved;
+  long result_cache_hits;
+  long result_cache_misses;
+  long eventloop_wakeups;
+} GlyrStats;
+
+/* Upper bounds in ms of the latency histogram of GlyrProviderMetrics.
+ * An extra bucket takes everything above the last one */
+#define GLYR_METRICS_LATENCY_BOUNDS_MS 10,25,50,100,250,500,1000,2500,5000,10000
+#define GLYR_METRICS_LATENCY_BUCKETS 11
+
+/**
+ * GlyrProviderMetrics:
+ * @name: The name of the provider.
+ * @type: The getter this provider works for.
+ * @requests: Number of downloads done for it, including cancelled ones.
+ * @errors: How many of those failed (timeouts, HTTP errors etc.), not counting cancelled ones.
+ * @bytes: Number of bytes downloaded for it.
+ * @accepted: Items it found that made it into the results.
+ * @rejected_dupes: Items thrown away, because they were found already.
+ * @rejected_format: Images thrown away, because their format was not allowed (see glyr_opt_allowed_formats()).
+ * @rejected_utf8: Items thrown away, because they were no valid UTF-8 (see glyr_opt_force_utf8()).
+ * @rejected_cached: Items thrown away, because they are in the database already (see glyr_opt_db_autoread()).
+ * @latency_buckets: Histogram of how long its successful downloads took; 
+ *                   bucket i counts those up to the i-th of #GLYR_METRICS_LATENCY_BOUNDS_MS (and above the one before), the last one all others.
+ * @latency_count: Number of downloads in @latency_buckets.
+ * @latency_sum_ms: Sum of the time those downloads took.
+ * @next: A pointer to the next provider.
+ * @prev: A pointer to the previous provider.
+ *
+ * What happened with one provider since glyr_init() or glyr_metrics_reset(), 
+ * counted over all queries. Get a list of all providers by glyr_metrics_snapshot().
+ */
+typedef struct _GlyrProviderMetrics {
+  char * name;
+  GLYR_GET_TYPE type;
+
+  long requests;
+  long errors;
+  long bytes;
+
+  long accepted;
+  long rejected_dupes;
+  long rejected_format;
+  long rejected_utf8;
+  long rejected_cached;
+
+  long latency_buckets[GLYR_METRICS_LATENCY_BUCKETS];
+  long latency_count;
+  long latency_sum_ms;
+
+  struct _GlyrProviderMetrics * next;
+  struct _GlyrProviderMetrics * prev;
+} GlyrProviderMetrics;
+
 
 /**
  * DL_callback:
@@ -467,6 +662,37 @@ typedef struct _GlyrFetcherInfo {
 */
 typedef GLYR_ERROR (*DL_callback)(GlyrMemCache * dl, struct _GlyrQuery * s);
 
+/**
+ * GlyrTraceCallback:
+ * @span: What was done, and when. Only valid during the call.
+ * @s: The GlyrQuery you initially passed to glyr_get()
+ *
+ * Typedef'd version of the callback option used by glyr_opt_trace_callback()
+*/
+typedef void (*GlyrTraceCallback)(const GlyrTraceSpan * span, struct _GlyrQuery * s);
+
+/**
+ * GlyrBatchCallback:
+ * @query: One of the queries passed to glyr_get_batch()
+ * @results: What glyr_get() returned for it. Free it with glyr_free_list() when done.
+ * @error: The error glyr_get() reported for it.
+ * @length: The number of items in @results.
+ * @userptr: The userpointer passed to glyr_get_batch()
+ *
+ * Called by glyr_get_batch() once a query is done.
+ *
+ * Returns: GLYRE_STOP_PRE or GLYRE_STOP_POST to stop all other queries, anything else to continue.
+*/
+typedef GLYR_ERROR (*GlyrBatchCallback)(struct _GlyrQuery * query, GlyrMemCache * results, GLYR_ERROR error, int length, void * userptr);
+
+/**
+ * GlyrAsync:
+ *
+ * Handle of a query started by glyr_get_async().
+ * Its contents are private, use the glyr_async_* functions.
+ */
+typedef struct _GlyrAsync GlyrAsync;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,177 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnandline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011-2012]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+/* Not a test: Compares the throughput of glyr_get_batch() to N threads each running queries on their own.
+ * Every query downloads a few URLs from a local HTTP server, like the providers of a real query would.
+ * The threads give every query a multihandle (and connections) of its own, as glyr_get() does;
+ * the batch runs the transfers of all queries on one engine, whose connections are limited
+ * by glyr_set_connection_pool() and reused from query to query.
+ * Run it without arguments, it prints wall time, downloads per second and connections opened. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "../../lib/glyr.h"
+#include "../../lib/testing.h"
+#include "bench_server.h"
+
+#define QUERIES 256
+#define PER_QUERY 4
+#define DELAY_MS 20
+#define BODY_SIZE 4096
+
+//--------------------
+
+typedef struct {
+    GlyrQuery * queries;
+    const char ** urls;
+    volatile gint next;
+    volatile gint fetched;
+} ThreadWork;
+
+//--------------------
+
+/* Like a thread calling glyr_get() for one query after another */
+static gpointer thread_worker(gpointer data)
+{
+    ThreadWork * work = data;
+    gint i;
+    while((i = g_atomic_int_exchange_and_add(&work->next,1)) < QUERIES)
+    {
+        gint fetched = glyr_testing_fetch(&work->queries[i],work->urls + i * PER_QUERY,PER_QUERY);
+        g_atomic_int_add(&work->fetched,MAX(fetched,0));
+    }
+    return NULL;
+}
+
+//--------------------
+
+static gint run_threads(GlyrQuery * queries, const char ** urls, gint threads)
+{
+    ThreadWork work = {
+        .queries = queries,
+        .urls = urls,
+        .next = 0,
+        .fetched = 0
+    };
+
+    GThread ** pool = g_new0(GThread*,threads);
+    for(gint t = 0; t < threads; t++)
+    {
+        pool[t] = g_thread_create(thread_worker,&work,TRUE,NULL);
+    }
+    for(gint t = 0; t < threads; t++)
+    {
+        g_thread_join(pool[t]);
+    }
+    g_free(pool);
+    return work.fetched;
+}
+
+//--------------------
+
+static gint run_batch(GlyrQuery * queries, const char ** urls, gint max_parallel)
+{
+    GlyrQuery * query_ptrs[QUERIES];
+    for(gint i = 0; i < QUERIES; i++)
+    {
+        query_ptrs[i] = &queries[i];
+    }
+    return glyr_testing_fetch_batch(query_ptrs,QUERIES,max_parallel,urls,PER_QUERY);
+}
+
+//--------------------
+
+static gboolean bench(BenchServer * server, const char * name, gint parallel, gint connections, gboolean batch)
+{
+    GlyrQuery queries[QUERIES];
+    const char * urls[QUERIES * PER_QUERY];
+    for(gint i = 0; i < QUERIES; i++)
+    {
+        glyr_query_init(&queries[i]);
+        glyr_opt_verbosity(&queries[i],0);
+        glyr_opt_parallel(&queries[i],PER_QUERY);
+        glyr_opt_number(&queries[i],PER_QUERY);
+        glyr_opt_timeout(&queries[i],30);
+    }
+    for(gint i = 0; i < QUERIES * PER_QUERY; i++)
+    {
+        urls[i] = bench_server_url(server,DELAY_MS,BODY_SIZE);
+    }
+
+    glyr_set_connection_pool(connections,0);
+    gint connected = bench_server_connections(server);
+
+    gint64 start = g_get_monotonic_time();
+    gint fetched = (batch) ? run_batch(queries,urls,parallel) : run_threads(queries,urls,parallel);
+    gint64 spent = g_get_monotonic_time() - start;
+
+    connected = bench_server_connections(server) - connected;
+    g_print("%-8s %8d %8d %10.1f %10.0f %12d\n",name,parallel,connections,spent / 1e3,fetched / (spent / 1e6),connected);
+
+    for(gint i = 0; i < QUERIES; i++)
+    {
+        glyr_query_destroy(&queries[i]);
+    }
+    for(gint i = 0; i < QUERIES * PER_QUERY; i++)
+    {
+        g_free((gchar*)urls[i]);
+    }
+
+    if(fetched != QUERIES * PER_QUERY)
+    {
+        g_printerr("%s: only %d of %d downloads succeeded\n",name,fetched,QUERIES * PER_QUERY);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//--------------------
+
+int main(void)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    BenchServer * server = bench_server_start();
+    if(server == NULL)
+    {
+        g_printerr("Cannot start the local HTTP server\n");
+        return EXIT_FAILURE;
+    }
+
+    gint parallel[] = {16, 64};
+    gboolean all_done = TRUE;
+
+    g_print("%d queries, %d downloads each, %dms per download\n",QUERIES,PER_QUERY,DELAY_MS);
+    g_print("%-8s %8s %8s %10s %10s %12s\n","","queries","limit","wall [ms]","dl/s","connections");
+    for(gsize p = 0; p < G_N_ELEMENTS(parallel); p++)
+    {
+        /* The threads' connections are per query, the batch's for all of them */
+        all_done = bench(server,"threads",parallel[p],PER_QUERY,FALSE) && all_done;
+        all_done = bench(server,"batch",parallel[p],32,TRUE) && all_done;
+        all_done = bench(server,"batch",parallel[p],parallel[p] * PER_QUERY,TRUE) && all_done;
+    }
+
+    bench_server_stop(server);
+    return (all_done) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
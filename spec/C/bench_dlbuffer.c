@@ -0,0 +1,117 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnandline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011-2012]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+/* Not a test: Compares how DL_buffer() receives a body to the way it did before,
+ * one realloc() per chunk and a strstr() over everything received for the endmarker.
+ * Run it without arguments, it prints the time per body for a few chunk sizes. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "../../lib/glyr.h"
+#include "../../lib/testing.h"
+
+#define BODY_SIZE (4 * 1024 * 1024)
+#define ROUNDS 5
+#define ENDMARKER "</lyrics>"
+
+//--------------------
+
+/* The old way, kept here as reference */
+static gsize receive_naive(const gchar * body, gsize size, gsize chunk)
+{
+    gchar * data = NULL;
+    gsize received = 0;
+    for(gsize offset = 0; offset < size; offset += chunk)
+    {
+        gsize len = MIN(chunk,size - offset);
+        data = g_realloc(data,received + len + 1);
+        memcpy(data + received,body + offset,len);
+        received += len;
+        data[received] = 0;
+
+        if(strstr(data,ENDMARKER) != NULL)
+        {
+            break;
+        }
+    }
+    g_free(data);
+    return received;
+}
+
+//--------------------
+
+/* Some HTML-ish text, with the endmarker at the very end */
+static gchar * make_body(gsize size)
+{
+    const gchar * line = "<p>Lorem ipsum dolor sit amet, consectetur adipisici elit</p>\n";
+    gsize line_len = strlen(line);
+    gsize marker_len = strlen(ENDMARKER);
+
+    gchar * body = g_malloc(size + 1);
+    for(gsize i = 0; i < size - marker_len; i++)
+    {
+        body[i] = line[i % line_len];
+    }
+    memcpy(body + size - marker_len,ENDMARKER,marker_len);
+    body[size] = 0;
+    return body;
+}
+
+//--------------------
+
+int main(void)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    gchar * body = make_body(BODY_SIZE);
+    gsize chunks[] = {1024, 4096, 16384};
+
+    g_print("%d KB body, mean of %d rounds\n",BODY_SIZE / 1024,ROUNDS);
+    g_print("%8s %12s %12s\n","chunk","naive [ms]","glyr [ms]");
+    for(gsize c = 0; c < G_N_ELEMENTS(chunks); c++)
+    {
+        gint64 naive = 0, buffered = 0;
+        for(gint r = 0; r < ROUNDS; r++)
+        {
+            gint64 start = g_get_monotonic_time();
+            gsize naive_size = receive_naive(body,BODY_SIZE,chunks[c]);
+            naive += g_get_monotonic_time() - start;
+
+            start = g_get_monotonic_time();
+            GlyrMemCache * cache = glyr_testing_buffer(body,BODY_SIZE,chunks[c],ENDMARKER);
+            buffered += g_get_monotonic_time() - start;
+
+            if(cache == NULL || cache->size != naive_size)
+            {
+                g_printerr("Received %ld bytes instead of %ld\n",(long)(cache ? cache->size : 0),(long)naive_size);
+                return EXIT_FAILURE;
+            }
+            glyr_cache_free(cache);
+        }
+        g_print("%8ld %12.2f %12.2f\n",(long)chunks[c],naive / 1e3 / ROUNDS,buffered / 1e3 / ROUNDS);
+    }
+
+    g_free(body);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnandline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011-2012]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+/* Not a test: Measures what the event loop of a single query costs per download,
+ * with 10, 100 and 1000 downloads running at once on a local HTTP server.
+ * Each download is answered after a fixed delay, so the time spent waiting is the same everywhere;
+ * what differs are the wakeups of the loop and the CPU time of the thread running it.
+ * Run it without arguments. 1000 downloads need about 2100 file descriptors,
+ * the soft limit is raised to the hard one; raise that with "ulimit -Hn" if it's lower. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <glib.h>
+
+#include "../../lib/glyr.h"
+#include "../../lib/testing.h"
+#include "bench_server.h"
+
+#define DELAY_MS 200
+#define BODY_SIZE 4096
+
+/* Only the thread running the loop; the server runs in another one */
+#ifdef RUSAGE_THREAD
+#define BENCH_RUSAGE RUSAGE_THREAD
+#else
+#define BENCH_RUSAGE RUSAGE_SELF
+#endif
+
+//--------------------
+
+static gint64 cpu_time_us(void)
+{
+    struct rusage usage;
+    getrusage(BENCH_RUSAGE,&usage);
+    return (gint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+//--------------------
+
+static void raise_fd_limit(void)
+{
+    struct rlimit limit;
+    if(getrlimit(RLIMIT_NOFILE,&limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE,&limit);
+    }
+}
+
+//--------------------
+
+static gboolean run_round(BenchServer * server, gint handles)
+{
+    const char ** urls = g_new0(const char *,handles);
+    for(gint i = 0; i < handles; i++)
+    {
+        urls[i] = bench_server_url(server,DELAY_MS,BODY_SIZE);
+    }
+
+    /* All of them on the wire at once */
+    glyr_set_connection_pool(handles,0);
+
+    GlyrQuery q;
+    glyr_query_init(&q);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_parallel(&q,handles);
+    glyr_opt_number(&q,handles);
+    glyr_opt_timeout(&q,60);
+
+    GlyrStats stats;
+    glyr_stats_reset();
+
+    gint64 wall = g_get_monotonic_time();
+    gint64 cpu  = cpu_time_us();
+    gint done   = glyr_testing_fetch(&q,urls,handles);
+    cpu  = cpu_time_us() - cpu;
+    wall = g_get_monotonic_time() - wall;
+
+    glyr_stats_get(&stats);
+    glyr_query_destroy(&q);
+
+    if(done > 0)
+    {
+        g_print("%8d %8d %10.1f %14.2f %14.1f\n",handles,done,wall / 1e3,
+                stats.eventloop_wakeups / (gdouble)done,cpu / (gdouble)done);
+    }
+    else
+    {
+        g_printerr("No download of %d succeeded\n",handles);
+    }
+
+    for(gint i = 0; i < handles; i++)
+    {
+        g_free((gchar*)urls[i]);
+    }
+    g_free(urls);
+    return done == handles;
+}
+
+//--------------------
+
+int main(void)
+{
+    raise_fd_limit();
+
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    BenchServer * server = bench_server_start();
+    if(server == NULL)
+    {
+        g_printerr("Cannot start the local HTTP server\n");
+        return EXIT_FAILURE;
+    }
+
+    gint handles[] = {10, 100, 1000};
+    gboolean all_done = TRUE;
+
+    g_print("Every download takes %dms, %d bytes\n",DELAY_MS,BODY_SIZE);
+    g_print("%8s %8s %10s %14s %14s\n","handles","done","wall [ms]","wakeups/dl","cpu/dl [us]");
+    for(gsize h = 0; h < G_N_ELEMENTS(handles); h++)
+    {
+        all_done = run_round(server,handles[h]) && all_done;
+    }
+
+    bench_server_stop(server);
+    return (all_done) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,90 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnandline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011-2012]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+/* Not a test: Compares picking the providers of a query with glyr_opt_from() compiled
+ * to a ProviderMask, to splitting GlyrQuery.from again for every provider, as it was before.
+ * Run it without arguments, it prints the time per query for a few from-strings. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "../../lib/glyr.h"
+#include "../../lib/testing.h"
+
+#define ROUNDS 10000
+
+//--------------------
+
+static gint64 time_queue(GlyrQuery * q, gint * fired)
+{
+    gint64 start = g_get_monotonic_time();
+    for(gint r = 0; r < ROUNDS; r++)
+    {
+        *fired = glyr_testing_queue_providers(GLYR_GET_LYRICS,q);
+    }
+    return g_get_monotonic_time() - start;
+}
+
+//--------------------
+
+int main(void)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    const gchar * froms[] = {
+        "all",
+        "lyricswiki;lyrix;metrolyrics",
+        "all;-lyricswiki;-lyrix;-metrolyrics;-chartlyrics;-lyrdb"
+    };
+
+    g_print("Lyrics providers, parallel = 2, mean of %d rounds\n",ROUNDS);
+    g_print("%-58s %6s %12s %12s\n","from","picked","split [us]","mask [us]");
+    for(gsize f = 0; f < G_N_ELEMENTS(froms); f++)
+    {
+        GlyrQuery q;
+        glyr_query_init(&q);
+        glyr_opt_type(&q,GLYR_GET_LYRICS);
+        glyr_opt_parallel(&q,2);
+        glyr_opt_from(&q,froms[f]);
+
+        gint masked_fired = 0, split_fired = 0;
+        gint64 masked = time_queue(&q,&masked_fired);
+
+        /* Set directly, the mask does not match anymore: the way it was before */
+        gchar * from = q.from;
+        q.from = g_strdup(from);
+        gint64 split = time_queue(&q,&split_fired);
+        g_free(q.from);
+        q.from = from;
+
+        if(masked_fired != split_fired)
+        {
+            g_printerr("Picked %d providers with the mask, but %d without\n",masked_fired,split_fired);
+            return EXIT_FAILURE;
+        }
+
+        g_print("%-58s %6d %12.2f %12.2f\n",froms[f],masked_fired,(gdouble)split / ROUNDS,(gdouble)masked / ROUNDS);
+        glyr_query_destroy(&q);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnandline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011-2012]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+/* Not a test: Compares how long it takes to get the first N items, if the next provider
+ * starts as soon as one is done, to starting them in waves of GlyrQuery.parallel as before.
+ * The providers are made up, and served by a local HTTP server with mixed latencies.
+ * Run it without arguments, it prints the time to N items for a few N. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "../../lib/glyr.h"
+#include "../../lib/testing.h"
+#include "bench_server.h"
+
+#define ROUNDS 3
+#define PARALLEL 4
+
+//--------------------
+
+/* A few slow ones among fast ones, in the order they'd be chosen */
+static const gint latencies_ms[] = {
+    50, 1200, 80, 100, 60, 900, 120, 70,
+    1500, 90, 110, 40, 800, 60, 130, 75
+};
+
+//--------------------
+
+static gint64 time_to_items(const char ** urls, gint n, gint wanted, bool waves, gint * found)
+{
+    GlyrQuery q;
+    glyr_query_init(&q);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_parallel(&q,PARALLEL);
+    glyr_opt_number(&q,wanted);
+    glyr_opt_timeout(&q,10);
+
+    gint64 start = g_get_monotonic_time();
+    *found = glyr_testing_fetch_providers(&q,urls,n,waves);
+    gint64 spent = g_get_monotonic_time() - start;
+
+    glyr_query_destroy(&q);
+    return spent;
+}
+
+//--------------------
+
+int main(void)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    BenchServer * server = bench_server_start();
+    if(server == NULL)
+    {
+        g_printerr("Cannot start the local HTTP server\n");
+        return EXIT_FAILURE;
+    }
+
+    gint n = G_N_ELEMENTS(latencies_ms);
+    const char * urls[G_N_ELEMENTS(latencies_ms)];
+    for(gint i = 0; i < n; i++)
+    {
+        urls[i] = bench_server_url(server,latencies_ms[i],1024);
+    }
+
+    gint wanted[] = {1, 4, 8, 12, 16};
+
+    g_print("%d providers, %d at once, mean of %d rounds\n",n,PARALLEL,ROUNDS);
+    g_print("%6s %12s %12s\n","items","waves [ms]","refill [ms]");
+    for(gsize w = 0; w < G_N_ELEMENTS(wanted); w++)
+    {
+        gint64 waves = 0, refill = 0;
+        for(gint r = 0; r < ROUNDS; r++)
+        {
+            gint waves_found = 0, refill_found = 0;
+            waves  += time_to_items(urls,n,wanted[w],true,&waves_found);
+            refill += time_to_items(urls,n,wanted[w],false,&refill_found);
+
+            if(waves_found < wanted[w] || refill_found < wanted[w])
+            {
+                g_printerr("Wanted %d items, got %d (waves) and %d (refill)\n",wanted[w],waves_found,refill_found);
+                return EXIT_FAILURE;
+            }
+        }
+        g_print("%6d %12.1f %12.1f\n",wanted[w],waves / 1e3 / ROUNDS,refill / 1e3 / ROUNDS);
+    }
+
+    for(gint i = 0; i < n; i++)
+    {
+        g_free((gchar*)urls[i]);
+    }
+    bench_server_stop(server);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,326 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnandline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011-2012]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "bench_server.h"
+
+/* Max. time to sleep, so quit is noticed in time */
+#define SERVER_MAX_WAIT_MS 100
+
+//--------------------
+
+typedef struct {
+    int fd;
+    GString * request;
+
+    /* When to answer (monotonic µs), -1 while the request is incomplete */
+    gint64 answer_at;
+    gsize body_size;
+
+    /* What is being sent, NULL if nothing */
+    gchar * response;
+    gsize response_len;
+    gsize sent;
+} Client;
+
+struct _BenchServer {
+    int listen_fd;
+    int port;
+    GThread * thread;
+    GPtrArray * clients;
+
+    volatile gint quit;
+    volatile gint connections;
+    volatile gint requests;
+    volatile gint urls;
+};
+
+//--------------------
+
+static void set_nonblocking(int fd)
+{
+    fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) | O_NONBLOCK);
+}
+
+//--------------------
+
+static void client_free(Client * client)
+{
+    close(client->fd);
+    g_string_free(client->request,TRUE);
+    g_free(client->response);
+    g_free(client);
+}
+
+//--------------------
+
+/* A complete request came in: Schedule the answer */
+static void client_parse_request(Client * client)
+{
+    gchar * header_end = strstr(client->request->str,"\r\n\r\n");
+    if(header_end == NULL || client->answer_at >= 0 || client->response != NULL)
+    {
+        return;
+    }
+
+    gint delay_ms = 0;
+    unsigned long size = 0;
+    sscanf(client->request->str,"GET /%d/%lu",&delay_ms,&size);
+    g_string_erase(client->request,0,header_end + 4 - client->request->str);
+
+    client->answer_at = g_get_monotonic_time() + (gint64)MAX(delay_ms,0) * 1000;
+    client->body_size = size;
+}
+
+//--------------------
+
+static void client_build_response(Client * client)
+{
+    gchar * header = g_strdup_printf("HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %lu\r\n\r\n",(unsigned long)client->body_size);
+    gsize header_len = strlen(header);
+
+    client->response_len = header_len + client->body_size;
+    client->response = g_malloc(client->response_len);
+    memcpy(client->response,header,header_len);
+    memset(client->response + header_len,'x',client->body_size);
+    client->sent = 0;
+    client->answer_at = -1;
+    g_free(header);
+}
+
+//--------------------
+
+/* Returns FALSE if the client is gone */
+static gboolean client_read(Client * client)
+{
+    gchar buf[4096];
+    gssize n;
+    while((n = read(client->fd,buf,sizeof(buf))) > 0)
+    {
+        g_string_append_len(client->request,buf,n);
+    }
+
+    if(n == 0 || (n == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+        return FALSE;
+    }
+
+    client_parse_request(client);
+    return TRUE;
+}
+
+//--------------------
+
+/* Returns FALSE if the client is gone */
+static gboolean client_write(BenchServer * server, Client * client)
+{
+    while(client->sent < client->response_len)
+    {
+        gssize n = write(client->fd,client->response + client->sent,client->response_len - client->sent);
+        if(n == -1)
+        {
+            return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+        }
+        client->sent += n;
+    }
+
+    g_free(client->response);
+    client->response = NULL;
+    g_atomic_int_inc(&server->requests);
+
+    /* The next one might be there already */
+    client_parse_request(client);
+    return TRUE;
+}
+
+//--------------------
+
+static void accept_clients(BenchServer * server)
+{
+    int fd;
+    while((fd = accept(server->listen_fd,NULL,NULL)) != -1)
+    {
+        set_nonblocking(fd);
+        Client * client = g_malloc0(sizeof(Client));
+        client->fd = fd;
+        client->request = g_string_new(NULL);
+        client->answer_at = -1;
+        g_ptr_array_add(server->clients,client);
+        g_atomic_int_inc(&server->connections);
+    }
+}
+
+//--------------------
+
+static gpointer server_thread(gpointer data)
+{
+    BenchServer * server = data;
+    while(g_atomic_int_get(&server->quit) == FALSE)
+    {
+        guint n_clients = server->clients->len;
+        struct pollfd * fds = g_malloc0((n_clients + 1) * sizeof(struct pollfd));
+        gint64 now = g_get_monotonic_time();
+        gint wait_ms = SERVER_MAX_WAIT_MS;
+
+        fds[0].fd = server->listen_fd;
+        fds[0].events = POLLIN;
+        for(guint i = 0; i < n_clients; i++)
+        {
+            Client * client = g_ptr_array_index(server->clients,i);
+            fds[i + 1].fd = client->fd;
+            fds[i + 1].events = (client->response != NULL) ? POLLOUT : POLLIN;
+            if(client->answer_at >= 0)
+            {
+                wait_ms = CLAMP((client->answer_at - now) / 1000 + 1,0,wait_ms);
+            }
+        }
+
+        poll(fds,n_clients + 1,wait_ms);
+        now = g_get_monotonic_time();
+
+        /* Walk backwards, so removing does not skip anybody */
+        for(guint i = n_clients; i > 0; i--)
+        {
+            Client * client = g_ptr_array_index(server->clients,i - 1);
+            gboolean alive = TRUE;
+            if(fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                alive = client_read(client);
+            }
+
+            if(alive && client->answer_at >= 0 && client->answer_at <= now)
+            {
+                client_build_response(client);
+            }
+
+            if(alive && client->response != NULL)
+            {
+                alive = client_write(server,client);
+            }
+
+            if(alive == FALSE)
+            {
+                client_free(client);
+                g_ptr_array_remove_index_fast(server->clients,i - 1);
+            }
+        }
+
+        if(fds[0].revents & POLLIN)
+        {
+            accept_clients(server);
+        }
+        g_free(fds);
+    }
+    return NULL;
+}
+
+//--------------------
+
+BenchServer * bench_server_start(void)
+{
+    int fd = socket(AF_INET,SOCK_STREAM,0);
+    if(fd == -1)
+    {
+        return NULL;
+    }
+
+    int on = 1;
+    setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,&on,sizeof(on));
+
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    memset(&addr,0,sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    if(bind(fd,(struct sockaddr*)&addr,sizeof(addr)) == -1 || listen(fd,4096) == -1 ||
+       getsockname(fd,(struct sockaddr*)&addr,&addr_len) == -1)
+    {
+        close(fd);
+        return NULL;
+    }
+    set_nonblocking(fd);
+
+    BenchServer * server = g_malloc0(sizeof(BenchServer));
+    server->listen_fd = fd;
+    server->port = ntohs(addr.sin_port);
+    server->clients = g_ptr_array_new();
+    server->thread = g_thread_create(server_thread,server,TRUE,NULL);
+    if(server->thread == NULL)
+    {
+        close(fd);
+        g_ptr_array_free(server->clients,TRUE);
+        g_free(server);
+        return NULL;
+    }
+    return server;
+}
+
+//--------------------
+
+void bench_server_stop(BenchServer * server)
+{
+    if(server != NULL)
+    {
+        g_atomic_int_set(&server->quit,TRUE);
+        g_thread_join(server->thread);
+
+        for(guint i = 0; i < server->clients->len; i++)
+        {
+            client_free(g_ptr_array_index(server->clients,i));
+        }
+        g_ptr_array_free(server->clients,TRUE);
+        close(server->listen_fd);
+        g_free(server);
+    }
+}
+
+//--------------------
+
+gchar * bench_server_url(BenchServer * server, gint delay_ms, gsize size)
+{
+    /* The query is ignored, it just keeps glyr from merging identical downloads */
+    return g_strdup_printf("http://127.0.0.1:%d/%d/%lu?%d",server->port,delay_ms,(unsigned long)size,
+                           g_atomic_int_exchange_and_add(&server->urls,1));
+}
+
+//--------------------
+
+gint bench_server_connections(BenchServer * server)
+{
+    return g_atomic_int_get(&server->connections);
+}
+
+//--------------------
+
+gint bench_server_requests(BenchServer * server)
+{
+    return g_atomic_int_get(&server->requests);
+}
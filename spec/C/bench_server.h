@@ -0,0 +1,42 @@
+/***********************************************************
+ * This file is part of glyr
+ * + a commnandline tool and library to download various sort of musicrelated metadata.
+ * + Copyright (C) [2011-2012]  [Christopher Pahl]
+ * + Hosted at: https://github.com/sahib/glyr
+ *
+ * glyr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * glyr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with glyr. If not, see <http://www.gnu.org/licenses/>.
+ **************************************************************/
+
+#ifndef GLYR_BENCH_SERVER_H
+#define GLYR_BENCH_SERVER_H
+
+#include <glib.h>
+
+/* Local HTTP stand-in for the benchmarks, running in a thread of its own:
+ * "GET /<delay_ms>/<size>" is answered after delay_ms with size bytes of text.
+ * Connections are kept open for the next request, like a real server would. */
+typedef struct _BenchServer BenchServer;
+
+/* Listens on 127.0.0.1, on a free port. NULL on errors */
+BenchServer * bench_server_start(void);
+void bench_server_stop(BenchServer * server);
+
+/* URL to ask server for size bytes after delay_ms, a different one on every call; free with g_free() */
+gchar * bench_server_url(BenchServer * server, gint delay_ms, gsize size);
+
+/* Connections accepted and requests answered so far */
+gint bench_server_connections(BenchServer * server);
+gint bench_server_requests(BenchServer * server);
+
+#endif
@@ -19,8 +19,11 @@
  **************************************************************/
 
 #include "test_common.h"
+#include "../../lib/testing.h"
 #include <check.h>
 #include <glib.h>
+#include <poll.h>
+#include <string.h>
 
 //--------------------
 //--------------------
@@ -197,6 +200,343 @@ END_TEST
 
 //--------------------
 
+START_TEST(test_glyr_http_cache)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    fail_unless(glyr_set_http_cache("/this/does/not/exist",0,-1) != GLYRE_OK,NULL);
+    fail_unless(glyr_set_http_cache("/tmp",0,-1) == GLYRE_OK,NULL);
+
+    /* Second one is served from the cache, or revalidated */
+    GlyrMemCache * first  = glyr_download("www.duckduckgo.com",NULL);
+    GlyrMemCache * second = glyr_download("www.duckduckgo.com",NULL);
+    fail_unless(first != NULL && second != NULL,NULL);
+    fail_unless(first->size == second->size,NULL);
+
+    glyr_cache_free(first);
+    glyr_cache_free(second);
+
+    fail_unless(glyr_set_http_cache(NULL,0,0) == GLYRE_OK,NULL);
+    system("rm /tmp/http_cache.db");
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_host_limit)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    /* Second one has to wait for the next token */
+    glyr_set_host_limit("www.duckduckgo.com",1.0,1,1);
+
+    GTimer * timer = g_timer_new();
+    GlyrMemCache * first  = glyr_download("www.duckduckgo.com",NULL);
+    GlyrMemCache * second = glyr_download("www.duckduckgo.com",NULL);
+    fail_unless(g_timer_elapsed(timer,NULL) >= 0.9,NULL);
+    fail_unless(first != NULL && second != NULL,NULL);
+
+    g_timer_destroy(timer);
+    glyr_cache_free(first);
+    glyr_cache_free(second);
+
+    glyr_set_host_limit("www.duckduckgo.com",0,0,0);
+}
+END_TEST
+
+//--------------------
+
+static gpointer get_lyrics_thread(gpointer data)
+{
+    GlyrQuery q;
+    setup(&q,GLYR_GET_LYRICS,1);
+    glyr_opt_verbosity(&q,0);
+    GlyrMemCache * list = glyr_get(&q,NULL,NULL);
+    unsetup(&q,list);
+    return NULL;
+}
+
+START_TEST(test_glyr_stats)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    GlyrStats stats;
+    glyr_stats_reset();
+    glyr_stats_get(&stats);
+    fail_unless(stats.flights_started == 0 && stats.flights_joined == 0,NULL);
+
+    /* Same query twice at the same time - may share downloads */
+    GThread * a = g_thread_create(get_lyrics_thread,NULL,TRUE,NULL);
+    GThread * b = g_thread_create(get_lyrics_thread,NULL,TRUE,NULL);
+    g_thread_join(a);
+    g_thread_join(b);
+
+    glyr_stats_get(&stats);
+    fail_unless(stats.flights_started > 0,NULL);
+    g_print("Joined %ld of %ld downloads\n",stats.flights_joined,stats.flights_started);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_result_cache)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+    glyr_set_result_cache(1024 * 1024,-1);
+    glyr_stats_reset();
+
+    GlyrQuery q;
+    setup(&q,GLYR_GET_LYRICS,1);
+    glyr_opt_verbosity(&q,0);
+
+    int first_length = 0, second_length = 0;
+    GlyrMemCache * first  = glyr_get(&q,NULL,&first_length);
+    GlyrMemCache * second = glyr_get(&q,NULL,&second_length);
+
+    fail_unless(first != NULL && second != NULL,NULL);
+    fail_unless(first != second,NULL);
+    fail_unless(first_length == second_length,NULL);
+    fail_unless(first->size == second->size && memcmp(first->data,second->data,first->size) == 0,NULL);
+
+    GlyrStats stats;
+    glyr_stats_get(&stats);
+    fail_unless(stats.result_cache_misses == 1,NULL);
+    fail_unless(stats.result_cache_hits == 1,NULL);
+
+    /* Other filters may accept other results */
+    glyr_opt_force_utf8(&q,!q.force_utf8);
+    GlyrMemCache * third = glyr_get(&q,NULL,NULL);
+    glyr_stats_get(&stats);
+    fail_unless(stats.result_cache_misses == 2,NULL);
+
+    glyr_free_list(first);
+    glyr_free_list(second);
+    glyr_free_list(third);
+    glyr_query_destroy(&q);
+    glyr_set_result_cache(0,-1);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_metrics)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+    glyr_metrics_reset();
+
+    GlyrQuery q;
+    setup(&q,GLYR_GET_LYRICS,1);
+    glyr_opt_verbosity(&q,0);
+
+    int length = 0;
+    GlyrMemCache * list = glyr_get(&q,NULL,&length);
+    fail_unless(length == 1,NULL);
+
+    long requests = 0, accepted = 0;
+    GlyrProviderMetrics * metrics = glyr_metrics_snapshot();
+    fail_unless(metrics != NULL,NULL);
+    for(GlyrProviderMetrics * m = metrics; m; m = m->next)
+    {
+        long counted = 0;
+        for(int i = 0; i < GLYR_METRICS_LATENCY_BUCKETS; i++)
+        {
+            counted += m->latency_buckets[i];
+        }
+        fail_unless(counted == m->latency_count,NULL);
+        fail_unless(m->errors <= m->requests,NULL);
+
+        requests += m->requests;
+        accepted += m->accepted;
+    }
+    fail_unless(requests > 0,NULL);
+    fail_unless(accepted >= 1,NULL);
+
+    char * text = glyr_metrics_to_prometheus(metrics);
+    fail_unless(strstr(text,"# TYPE glyr_provider_requests_total counter") != NULL,NULL);
+    fail_unless(strstr(text,"le=\"+Inf\"") != NULL,NULL);
+    g_free(text);
+
+    glyr_metrics_free(metrics);
+    unsetup(&q,list);
+}
+END_TEST
+
+//--------------------
+
+static GLYR_ERROR count_batch_results(GlyrQuery * q, GlyrMemCache * results, GLYR_ERROR err, int length, void * userptr)
+{
+    int * counter = userptr;
+    fail_unless(err == GLYRE_OK,NULL);
+    fail_unless(length == 1 && results != NULL,NULL);
+    counter[0]++;
+    glyr_free_list(results);
+    return GLYRE_OK;
+}
+
+START_TEST(test_glyr_get_batch)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    GlyrQuery * queries[3] = {
+        setup_alloc(GLYR_GET_LYRICS,1),
+        setup_alloc(GLYR_GET_ARTISTBIO,1),
+        setup_alloc(GLYR_GET_COVERART,1)
+    };
+
+    int counter = 0;
+    GLYR_ERROR err = glyr_get_batch(queries,3,2,count_batch_results,&counter);
+    fail_unless(err == GLYRE_OK,NULL);
+    fail_unless(counter == 3,NULL);
+
+    for(int i = 0; i < 3; i++)
+    {
+        glyr_query_destroy(queries[i]);
+        g_free(queries[i]);
+    }
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_get_multi)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    GlyrQuery q;
+    setup(&q,GLYR_GET_UNSURE,1);
+    glyr_opt_verbosity(&q,0);
+
+    GLYR_GET_TYPE types[3] = {GLYR_GET_LYRICS, GLYR_GET_ARTISTBIO, GLYR_GET_COVERART};
+    GlyrMemCache * results[3];
+    int lengths[3];
+    GLYR_ERROR errors[3];
+
+    GLYR_ERROR err = glyr_get_multi(&q,types,3,results,lengths,errors);
+    fail_unless(err == GLYRE_OK,NULL);
+
+    for(int i = 0; i < 3; i++)
+    {
+        fail_unless(errors[i] == GLYRE_OK,NULL);
+        fail_unless(lengths[i] == 1 && results[i] != NULL,NULL);
+        glyr_free_list(results[i]);
+    }
+
+    glyr_query_destroy(&q);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_get_async)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    GlyrQuery q;
+    setup(&q,GLYR_GET_ARTIST_PHOTOS,2);
+    glyr_opt_verbosity(&q,0);
+
+    GlyrAsync * async = glyr_get_async(&q);
+    fail_unless(async != NULL,NULL);
+
+    struct pollfd pfd = {.fd = glyr_async_get_fd(async), .events = POLLIN};
+    fail_unless(pfd.fd >= 0,NULL);
+
+    int length = 0;
+    bool done = false;
+    while(done == false && poll(&pfd,1,-1) > 0)
+    {
+        done = glyr_async_step(async);
+
+        int collected = 0;
+        glyr_free_list(glyr_async_collect(async,&collected));
+        length += collected;
+    }
+
+    fail_unless(done,NULL);
+    fail_unless(glyr_async_get_error(async) == GLYRE_OK,NULL);
+    fail_unless(length == 2,NULL);
+
+    glyr_async_free(async);
+    glyr_query_destroy(&q);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_testing_followup)
+{
+    GlyrQuery q;
+    setup(&q,GLYR_GET_LYRICS,1);
+    glyr_opt_verbosity(&q,0);
+
+    /* lyrix.at: the search page links to the lyrics page, which is parsed by the continuation */
+    GlyrMemCache * search = glyr_cache_new();
+    glyr_cache_set_data(search,g_strdup("<html><!-- start of result item //--><a href='/de/equilibrium/wurzelbert.html'>Wurzelbert</a>"),-1);
+
+    GlyrMemCache * lyrics_page = glyr_cache_new();
+    glyr_cache_set_data(lyrics_page,g_strdup("<div class='songtext' id='stextDIV'>Wurzelbert<br />is alive<div><!-- eBay Relevance Ad -->"),-1);
+
+    GlyrMemCache * pages[] = {lyrics_page,NULL};
+    GlyrMemCache * result = glyr_testing_call_parser_canned("lyrix",GLYR_GET_LYRICS,&q,search,pages);
+    fail_unless(result != NULL,"continuation was not called");
+    fail_unless(strstr(result->data,"is alive") != NULL,NULL);
+    fail_unless(g_strcmp0(result->dsrc,"http://lyrix.at/de/equilibrium/wurzelbert.html") == 0,NULL);
+    fail_unless(result->next == NULL,NULL);
+
+    /* No body for the follow-up: nothing found, nothing leaked */
+    GlyrMemCache * no_pages[] = {NULL};
+    fail_unless(glyr_testing_call_parser_canned("lyrix",GLYR_GET_LYRICS,&q,search,no_pages) == NULL,NULL);
+
+    glyr_free_list(result);
+    glyr_cache_free(search);
+    glyr_cache_free(lyrics_page);
+    glyr_query_destroy(&q);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_testing_fetch_batch)
+{
+    glyr_init();
+    atexit(glyr_cleanup);
+
+    GlyrQuery queries[8];
+    GlyrQuery * query_ptrs[8];
+    const char * urls[16];
+    for(int i = 0; i < 8; i++)
+    {
+        glyr_query_init(&queries[i]);
+        glyr_opt_verbosity(&queries[i],0);
+        glyr_opt_parallel(&queries[i],2);
+        glyr_opt_timeout(&queries[i],5);
+        query_ptrs[i] = &queries[i];
+        urls[2*i] = urls[2*i+1] = "http://127.0.0.1:1/refused";
+    }
+
+    /* Nobody listens there; all fail on the shared engine, nothing hangs */
+    fail_unless(glyr_testing_fetch_batch(query_ptrs,8,4,urls,2) == 0,NULL);
+    fail_unless(glyr_testing_fetch_batch(query_ptrs,8,4,NULL,2) == -1,NULL);
+
+    /* Usable on their own again */
+    for(int i = 0; i < 8; i++)
+    {
+        fail_unless(glyr_testing_fetch(&queries[i],urls,2) == 0,NULL);
+        glyr_query_destroy(&queries[i]);
+    }
+}
+END_TEST
+
+//--------------------
+
 Suite * create_test_suite(void)
 {
   Suite *s = suite_create ("Libglyr API");
@@ -213,6 +553,16 @@ Suite * create_test_suite(void)
   tcase_add_test(tc_core, test_glyr_cache_set_data);
   tcase_add_test(tc_core, test_glyr_cache_write);
   tcase_add_test(tc_core, test_glyr_download);
+  tcase_add_test(tc_core, test_glyr_http_cache);
+  tcase_add_test(tc_core, test_glyr_host_limit);
+  tcase_add_test(tc_core, test_glyr_stats);
+  tcase_add_test(tc_core, test_glyr_result_cache);
+  tcase_add_test(tc_core, test_glyr_metrics);
+  tcase_add_test(tc_core, test_glyr_get_batch);
+  tcase_add_test(tc_core, test_glyr_get_multi);
+  tcase_add_test(tc_core, test_glyr_get_async);
+  tcase_add_test(tc_core, test_glyr_testing_followup);
+  tcase_add_test(tc_core, test_glyr_testing_fetch_batch);
   suite_add_tcase(s, tc_core);
   return s;
 }
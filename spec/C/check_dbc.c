@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <string.h>
 
 //--------------------
 
@@ -349,6 +350,88 @@ START_TEST(test_db_editplace)
 END_TEST
 
 
+//--------------------
+
+START_TEST(test_provider_stats)
+{
+    GlyrDatabase * db = setup_db(); 
+    fail_if(db == NULL,NULL);
+
+    GlyrQuery q;
+    setup(&q,GLYR_GET_LYRICS,1);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_lookup_db(&q,db);
+    glyr_opt_db_autoread(&q,false);
+
+    GlyrMemCache * list = glyr_get(&q,NULL,NULL);
+    glyr_free_list(list);
+    glyr_query_destroy(&q);
+    glyr_db_destroy(db);
+
+    /* Stats are still there after reopening */
+    db = glyr_db_init("/tmp/check");
+    fail_if(db == NULL,NULL);
+
+    long transfers = 0;
+    GlyrFetcherInfo * info = glyr_info_get();
+    for(GlyrFetcherInfo * fetcher = info; fetcher; fetcher = fetcher->next)
+    {
+        for(GlyrSourceInfo * source = fetcher->head; source; source = source->next)
+        {
+            fail_unless(source->successes <= source->transfers,NULL);
+            fail_unless(source->ranked_quality >= 0 && source->ranked_quality <= 100,NULL);
+            transfers += source->transfers;
+        }
+    }
+    glyr_info_free(info);
+    fail_unless(transfers > 0,NULL);
+
+    glyr_db_destroy(db);
+}
+END_TEST
+
+//--------------------
+
+/* Counts the searches for a release, as opposed to the release page itself */
+static void count_release_searches(const GlyrTraceSpan * span, GlyrQuery * q)
+{
+    int * searches = q->trace.user_pointer;
+    if(span->phase == GLYR_TRACE_DOWNLOAD && span->url != NULL && strstr(span->url,"/release/?") != NULL)
+    {
+        (*searches)++;
+    }
+}
+
+START_TEST(test_known_mbids)
+{
+    GlyrDatabase * db = setup_db(); 
+    fail_if(db == NULL,NULL);
+
+    GlyrQuery q;
+    setup(&q,GLYR_GET_TRACKLIST,5);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_from(&q,"musicbrainz");
+    glyr_opt_lookup_db(&q,db);
+    glyr_opt_db_autowrite(&q,false);
+
+    /* Second time the release is known, and no search is needed */
+    int first = 0, second = 0;
+    int first_searches = 0, second_searches = 0;
+    glyr_opt_trace_callback(&q,count_release_searches,&first_searches);
+    glyr_free_list(glyr_get(&q,NULL,&first));
+    glyr_opt_trace_callback(&q,count_release_searches,&second_searches);
+    glyr_free_list(glyr_get(&q,NULL,&second));
+
+    fail_unless(first > 0,NULL);
+    fail_unless(first == second,NULL);
+    fail_unless(first_searches > 0,NULL);
+    fail_unless(second_searches == 0,NULL);
+
+    glyr_query_destroy(&q);
+    glyr_db_destroy(db);
+}
+END_TEST
+
 //--------------------
 
 Suite * create_test_suite(void)
@@ -364,6 +447,8 @@ Suite * create_test_suite(void)
     tcase_add_test(tc_dbcache, test_sorted_rating);
     tcase_add_test(tc_dbcache, test_intelligent_lookup);
     tcase_add_test(tc_dbcache, test_db_editplace);
+    tcase_add_test(tc_dbcache, test_provider_stats);
+    tcase_add_test(tc_dbcache, test_known_mbids);
     suite_add_tcase(s, tc_dbcache);
     return s;
 }
@@ -135,6 +135,60 @@ START_TEST(test_glyr_opt_number)
 }
 END_TEST
 
+//--------------------
+
+START_TEST(test_glyr_opt_parallel)
+{
+    GlyrQuery q;
+    int length = 0;
+    setup(&q,GLYR_GET_LYRICS,3);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_parallel(&q,1);
+    GlyrMemCache * list = glyr_get(&q,NULL,&length);
+
+    fail_unless(length == 3,NULL);
+    
+    unsetup(&q,list);
+}
+END_TEST
+
+//--------------------
+
+static GLYR_ERROR test_callback_received(GlyrMemCache * c, GlyrQuery * q)
+{
+    GlyrStats stats;
+    glyr_stats_get(&stats);
+
+    long * received = q->callback.user_pointer;
+    received[0] = stats.bytes_received;
+    return GLYRE_STOP_POST;
+}
+
+START_TEST(test_glyr_opt_number_cancels)
+{
+    GlyrQuery q;
+    int length = 0;
+    setup(&q,GLYR_GET_LYRICS,1);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_parallel(&q,4);
+
+    long received = -1;
+    glyr_opt_dlcallback(&q,test_callback_received,&received);
+
+    glyr_stats_reset();
+    GlyrMemCache * list = glyr_get(&q,NULL,&length);
+    fail_unless(length == 1,NULL);
+
+    /* Nothing may come in once the item was there */
+    GlyrStats stats;
+    glyr_stats_get(&stats);
+    fail_unless(received > 0,NULL);
+    fail_unless(stats.bytes_received == received,NULL);
+
+    unsetup(&q,list);
+}
+END_TEST
+
 //--------------------
 // from
 // plugmax
@@ -157,6 +211,141 @@ END_TEST
 
 //--------------------
 
+START_TEST(test_glyr_opt_sniff_formats)
+{
+    GlyrQuery q;
+    setup(&q,GLYR_GET_COVERART,1);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_allowed_formats(&q,"png");
+    glyr_opt_sniff_formats(&q,true);
+    
+    int length = 0;
+    GlyrMemCache * list = glyr_get(&q,NULL,&length);
+
+    fail_unless(list != NULL,NULL);
+    fail_if(strcmp(list->img_format,"png") != 0,NULL);
+    fail_unless(list->size > 8 && memcmp(list->data,"\x89PNG",4) == 0,NULL);
+
+    unsetup(&q,list);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_opt_img_size)
+{
+    GlyrQuery q;
+    setup(&q,GLYR_GET_COVERART,2);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_img_minsize(&q,200);
+    glyr_opt_img_maxsize(&q,600);
+    
+    int length = 0;
+    GlyrMemCache * list = glyr_get(&q,NULL,&length);
+
+    for(GlyrMemCache * c = list; c; c = c->next)
+    {
+        if(c->img_width > 0 && c->img_height > 0)
+        {
+            gint mean = (c->img_width + c->img_height) / 2;
+            fail_unless(mean >= 200 && mean <= 600,NULL);
+        }
+    }
+
+    unsetup(&q,list);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_opt_hedge)
+{
+    GlyrQuery q;
+    setup(&q,GLYR_GET_LYRICS,2);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_parallel(&q,1);
+    glyr_opt_hedge(&q,true);
+
+    /* Nothing is known about the providers' latency in a fresh process,
+     * so a download taking more than a quarter of this (750ms) without an item is hedged */
+    glyr_opt_timeout(&q,3);
+
+    GlyrStats stats;
+    glyr_stats_reset();
+    
+    int length = 0;
+    GlyrMemCache * list = glyr_get(&q,NULL,&length);
+
+    fail_unless(length == 2,NULL);
+
+    /* Search and lyrics page of the first provider take longer than that,
+     * so the second one was started before the first was done */
+    glyr_stats_get(&stats);
+    fail_unless(stats.hedges_started > 0,NULL);
+
+    unsetup(&q,list);
+}
+END_TEST
+
+//--------------------
+
+START_TEST(test_glyr_opt_deadline)
+{
+    GlyrQuery q;
+    setup(&q,GLYR_GET_COVERART,10);
+    glyr_opt_verbosity(&q,0);
+    glyr_opt_deadline(&q,500);
+
+    int length = 0;
+    GLYR_ERROR err = GLYRE_OK;
+    GTimer * timer = g_timer_new();
+    GlyrMemCache * list = glyr_get(&q,&err,&length);
+
+    /* Some slack for the finalizer */
+    fail_unless(g_timer_elapsed(timer,NULL) < 2.0,NULL);
+    fail_unless(err == GLYRE_OK || err == GLYRE_DEADLINE,NULL);
+    fail_unless(length > 0 || list == NULL,NULL);
+    fail_unless(glyr_opt_deadline(&q,-1) == GLYRE_BAD_VALUE,NULL);
+
+    g_timer_destroy(timer);
+    unsetup(&q,list);
+}
+END_TEST
+
+//--------------------
+
+static void test_trace_callback(const GlyrTraceSpan * span, GlyrQuery * q)
+{
+    gint * seen = q->trace.user_pointer;
+    fail_unless(span->start <= span->end,NULL);
+    seen[span->phase]++;
+}
+
+START_TEST(test_glyr_opt_trace_callback)
+{
+    GlyrQuery q;
+    setup(&q,GLYR_GET_LYRICS,1);
+    glyr_opt_verbosity(&q,0);
+
+    gint seen[GLYR_TRACE_DB_INSERT + 1] = {0};
+    glyr_opt_trace_callback(&q,test_trace_callback,seen);
+
+    int length = 0;
+    GlyrMemCache * list = glyr_get(&q,NULL,&length);
+    fail_unless(length == 1,NULL);
+
+    fail_unless(seen[GLYR_TRACE_QUERY] == 1,NULL);
+    fail_unless(seen[GLYR_TRACE_DOWNLOAD] > 0,NULL);
+    fail_unless(seen[GLYR_TRACE_TRANSFER] > 0,NULL);
+    fail_unless(seen[GLYR_TRACE_PARSE] > 0,NULL);
+    fail_unless(seen[GLYR_TRACE_FINALIZE] > 0,NULL);
+
+    unsetup(&q,list);
+}
+END_TEST
+
+//--------------------
+
 START_TEST(test_glyr_opt_proxy)
 {
     GlyrQuery q;
@@ -184,7 +373,14 @@ Suite * create_test_suite(void)
   tcase_add_test(tc_options, test_glyr_opt_dlcallback);
   tcase_add_test(tc_options, test_glyr_opt_redirects);
   tcase_add_test(tc_options, test_glyr_opt_number);
+  tcase_add_test(tc_options, test_glyr_opt_parallel);
+  tcase_add_test(tc_options, test_glyr_opt_number_cancels);
   tcase_add_test(tc_options, test_glyr_opt_allowed_formats);
+  tcase_add_test(tc_options, test_glyr_opt_sniff_formats);
+  tcase_add_test(tc_options, test_glyr_opt_img_size);
+  tcase_add_test(tc_options, test_glyr_opt_hedge);
+  tcase_add_test(tc_options, test_glyr_opt_deadline);
+  tcase_add_test(tc_options, test_glyr_opt_trace_callback);
   tcase_add_test(tc_options, test_glyr_opt_proxy);
   suite_add_tcase(s, tc_options);
   return s;
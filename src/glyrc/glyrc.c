@@ -70,6 +70,7 @@ typedef struct
 {
     char * output_path;
     char * exec_on_call;
+    char * metrics_path;
     bool as_one;
     bool append_format;
 
@@ -81,6 +82,7 @@ typedef struct
 {                          \
     .output_path  = NULL,  \
     .exec_on_call = NULL,  \
+    .metrics_path = NULL,  \
     .as_one       = false, \
     .append_format= false  \
 }                          \
@@ -268,6 +270,7 @@ void help_short(GlyrQuery * s)
             IN"-j --callback            Command: Set a bash command to be executed when a item is finished downloading;\n"
             IN"                                  All escapes mentioned in --write are supported too, and additonally:\n"
             IN"                                    * path : The path were the item was written to.\n"
+            IN"-M --metrics <file>      Write the counters of each provider to <file> in prometheus' text format when done.\n"
             "\nDATABASE OPTIONS\n"
             IN"-c --cache <folder>      Creates or opens an existing cache at <folder>/metadata.db and lookups data from there.\n"
             IN"cache select [Query]     Selects data from the cache; you can use any other option behind this.\n"
@@ -312,6 +315,12 @@ static void visualize_from_options(void)
                 cvprint(YELLOW,"     - Quality: %d\n",elem1->quality);
                 cvprint(YELLOW,"     - Speed:   %d\n",elem1->speed);
                 cvprint(YELLOW,"     - Type:    %s\n",glyr_get_type_to_string(elem1->type));
+                if(elem1->transfers > 0)
+                {
+                    cvprint(YELLOW,"     - Learned: %ld/%ld ok, %ld items, %dms => Quality: %d Speed: %d\n",
+                            elem1->successes,elem1->transfers,elem1->items,elem1->latency_ms,
+                            elem1->ranked_quality,elem1->ranked_speed);
+                }
             }
 
             cvprint(GREEN," + Requires: (%s%s%s)\n",
@@ -377,6 +386,7 @@ static void parse_commandline_general(int argc, char * const * argv, GlyrQuery *
         {"lang",          required_argument, 0, 'l'},
         {"fuzzyness",     required_argument, 0, 'z'},
         {"callback",	  required_argument, 0, 'j'},
+        {"metrics",       required_argument, 0, 'M'},
         {"musictree-path",required_argument, 0, 's'},
         {0,               0,                 0, '0'}
     };
@@ -386,7 +396,7 @@ static void parse_commandline_general(int argc, char * const * argv, GlyrQuery *
     {
         gint c;
         gint option_index = 0;
-        if((c = getopt_long(argc, argv, "f:W:w:p:r:m:x:u:v:q:c:F:hVodDLa:b:t:i:e:s:n:l:z:j:k:8gGyY",long_options, &option_index)) == -1)
+        if((c = getopt_long(argc, argv, "f:W:w:p:r:m:x:u:v:q:c:F:hVodDLa:b:t:i:e:s:n:l:z:j:k:M:8gGyY",long_options, &option_index)) == -1)
         {
             break;
         }
@@ -493,6 +503,9 @@ static void parse_commandline_general(int argc, char * const * argv, GlyrQuery *
             case 'j':
                 CBData->exec_on_call = optarg;
                 break;
+            case 'M':
+                CBData->metrics_path = optarg;
+                break;
             case 'k':
                 glyr_opt_proxy(glyrs,optarg);
                 break;
@@ -804,6 +817,24 @@ static GlyrMemCache * concatenate_list(GlyrMemCache * list)
 
 //////////////////////////////////////
 
+static void write_metrics(const char * path)
+{
+    GlyrProviderMetrics * metrics = glyr_metrics_snapshot();
+    char * text = glyr_metrics_to_prometheus(metrics);
+
+    GError * error = NULL;
+    if(g_file_set_contents(path,text,-1,&error) == FALSE)
+    {
+        cvprint(RED,"Error: Writing metrics to <%s> failed: %s\n",path,(error) ? error->message : "unknown error");
+        g_clear_error(&error);
+    }
+
+    g_free(text);
+    glyr_metrics_free(metrics);
+}
+
+//////////////////////////////////////
+
 static void global_cleanup(void)
 {
     set_write_path(NULL);
@@ -887,6 +918,11 @@ int main(int argc, char * argv[])
             {
                 cprint(RED,1,&my_query,"Error: %s\n",glyr_strerror(get_error));
             }
+
+            if(CBQueryData.metrics_path != NULL)
+            {
+                write_metrics(CBQueryData.metrics_path);
+            }
         }
 
         glyr_db_destroy(db);